@@ -0,0 +1,533 @@
+/**
+ * \file brain_bench.c
+ * \brief Measure the throughput of synthetic networks
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Networks of depth layers of width neurons are generated for each point
+ * of the grid, then predict, a training minibatch (feedforward and
+ * backpropagate of each sample, then one update) and update_network alone
+ * are timed. Each measure is repeated and reported as its median and its
+ * median absolute deviation, as a table and optionally as JSON.
+ *
+ * The precision is the one the benchmark is built with: brain_bench uses
+ * BrainReal and brain_bench_double is always built in double precision.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include "mlp_network.h"
+#include "brain_weight_utils.h"
+#include "brain_random_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_probe.h"
+
+#define BENCH_MAX_VALUES   16
+#define BENCH_MAX_REPEAT   64
+#define BENCH_POOL         64
+/**
+ * \def BENCH_UPDATE_FLOPS
+ * \brief floating point operations per weight of a Momentum update
+ */
+#define BENCH_UPDATE_FLOPS 4
+
+/**
+ * \struct BenchGrid
+ * \brief  Benchmarked shapes and measurement parameters
+ */
+typedef struct BenchGrid
+{
+    BrainUint   _widths[BENCH_MAX_VALUES];      /*!< Neurons per layer       */
+    BrainUint   _number_of_widths;              /*!< Number of widths        */
+    BrainUint   _depths[BENCH_MAX_VALUES];      /*!< Number of layers        */
+    BrainUint   _number_of_depths;              /*!< Number of depths        */
+    BrainString _activations[BENCH_MAX_VALUES]; /*!< Activation functions    */
+    BrainUint   _number_of_activations;         /*!< Number of activations   */
+    BrainUint   _batches[BENCH_MAX_VALUES];     /*!< Minibatch sizes         */
+    BrainUint   _number_of_batches;             /*!< Number of batch sizes   */
+    BrainBool   _fast_math;                     /*!< Interpolated activations*/
+    BrainUint   _repeat;                        /*!< Repetitions per measure */
+    BrainDouble _time;                          /*!< Seconds per repetition  */
+    BrainInt    _cpu;                           /*!< Pinned cpu, -1 if none  */
+    BrainString _json;                          /*!< JSON output, may be NULL*/
+} BenchGrid;
+
+/**
+ * \struct BenchResult
+ * \brief  A measured rate
+ */
+typedef struct BenchResult
+{
+    BrainDouble _median; /*!< Median rate per second          */
+    BrainDouble _mad;    /*!< Median absolute deviation       */
+    BrainDouble _flops;  /*!< Operations per counted item     */
+} BenchResult;
+
+/**
+ * \brief a measured operation, returns the elapsed seconds of count items
+ */
+typedef BrainDouble (*BenchKernel)(MLPNetwork network,
+                                   BrainOptimizer optimizer,
+                                   const BrainUint count,
+                                   const BrainUint batch);
+
+static BrainSignal _inputs  = NULL;
+static BrainSignal _targets = NULL;
+static BrainSignal _losses  = NULL;
+static FILE*       _json    = NULL;
+static BrainBool   _first   = BRAIN_TRUE;
+
+static BrainString
+get_precision()
+{
+    return (sizeof(BrainReal) == sizeof(BrainDouble)) ? "double" : "float";
+}
+
+static void
+train_sample(MLPNetwork network, const BrainUint index)
+{
+    const BrainUint width  = get_network_number_of_input(network);
+    const BrainUint length = get_network_output_length(network);
+    const BrainSignal input  = _inputs  + (index % BENCH_POOL) * width;
+    const BrainSignal target = _targets + (index % BENCH_POOL) * length;
+    BrainSignal output = NULL;
+    BrainUint i = 0;
+
+    feedforward(network, width, input, BRAIN_TRUE);
+    output = get_network_output(network);
+
+    for (i = 0; i < length; ++i)
+    {
+        _losses[i] = output[i] - target[i];
+    }
+
+    backpropagate(network, length, _losses);
+}
+
+static BrainDouble
+bench_predict(MLPNetwork network, BrainOptimizer optimizer, const BrainUint count, const BrainUint batch)
+{
+    const BrainUint   width = get_network_number_of_input(network);
+    const BrainDouble begin = brain_probe_now();
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        predict(network, width, _inputs + (i % BENCH_POOL) * width);
+    }
+
+    return brain_probe_now() - begin;
+}
+
+static BrainDouble
+bench_train(MLPNetwork network, BrainOptimizer optimizer, const BrainUint count, const BrainUint batch)
+{
+    const BrainDouble begin = brain_probe_now();
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        train_sample(network, i);
+
+        if (((i + 1) % batch == 0)
+        ||  (i + 1 == count))
+        {
+            step_optimizer(optimizer, batch);
+            update_network(network, optimizer);
+        }
+    }
+
+    return brain_probe_now() - begin;
+}
+
+static BrainDouble
+bench_update(MLPNetwork network, BrainOptimizer optimizer, const BrainUint count, const BrainUint batch)
+{
+    BrainDouble elapsed = 0.;
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        BrainDouble begin = 0.;
+
+        // only the neurons kept by a backpropagation are updated
+        train_sample(network, i);
+
+        begin = brain_probe_now();
+        step_optimizer(optimizer, 1);
+        update_network(network, optimizer);
+        elapsed += brain_probe_now() - begin;
+    }
+
+    return elapsed;
+}
+
+static int
+compare_doubles(const void* a, const void* b)
+{
+    const BrainDouble x = *(const BrainDouble*)a;
+    const BrainDouble y = *(const BrainDouble*)b;
+
+    return (x > y) - (x < y);
+}
+
+static BrainDouble
+get_median(BrainDouble* values, const BrainUint number_of_values)
+{
+    qsort(values, number_of_values, sizeof(BrainDouble), compare_doubles);
+
+    return (number_of_values % 2) ? values[number_of_values / 2]
+                                  : 0.5 * (values[number_of_values / 2 - 1] + values[number_of_values / 2]);
+}
+
+static void
+measure(const BenchGrid* grid,
+        MLPNetwork network,
+        BrainOptimizer optimizer,
+        BenchKernel kernel,
+        const BrainUint batch,
+        BenchResult* result)
+{
+    BrainDouble rates[BENCH_MAX_REPEAT];
+    BrainDouble deviations[BENCH_MAX_REPEAT];
+    BrainDouble elapsed = 0.;
+    BrainUint   count = 1;
+    BrainUint   i = 0;
+    /******************************************************************/
+    /**     Warm the caches and find a count lasting the given time  **/
+    /******************************************************************/
+    while ((elapsed = kernel(network, optimizer, count, batch)) < 0.25 * grid->_time)
+    {
+        count *= 2;
+    }
+
+    count = (BrainUint)((BrainDouble)count * grid->_time / elapsed) + 1;
+
+    for (i = 0; i < grid->_repeat; ++i)
+    {
+        rates[i] = (BrainDouble)count / kernel(network, optimizer, count, batch);
+    }
+
+    result->_median = get_median(rates, grid->_repeat);
+
+    for (i = 0; i < grid->_repeat; ++i)
+    {
+        deviations[i] = (rates[i] > result->_median) ? rates[i] - result->_median : result->_median - rates[i];
+    }
+
+    result->_mad = get_median(deviations, grid->_repeat);
+}
+
+static MLPNetwork
+new_bench_network(const BenchGrid* grid,
+                  const BrainUint width,
+                  const BrainUint depth,
+                  BrainString activation)
+{
+    MLPNetwork network = NULL;
+    BrainChar  path[] = "/tmp/brain_bench_XXXXXX";
+    const BrainInt fd = mkstemp(path);
+
+    if (0 <= fd)
+    {
+        FILE* file = fdopen(fd, "w");
+        BrainUint i = 0;
+
+        fprintf(file, "<?xml version=\"1.0\"?>\n<network inputs=\"%u\" fast-math=\"%s\">\n    <layers>\n",
+                width, grid->_fast_math ? "true" : "false");
+
+        for (i = 0; i < depth; ++i)
+        {
+            fprintf(file, "        <layer neurons=\"%u\" activation-function=\"%s\" dropout=\"0\"/>\n",
+                    width, activation);
+        }
+
+        fprintf(file, "    </layers>\n</network>\n");
+        fclose(file);
+
+        network = new_network_from_context(path);
+        unlink(path);
+    }
+
+    return network;
+}
+
+static void
+report(const BenchGrid* grid,
+       BrainString benchmark,
+       BrainString unit,
+       const BrainUint width,
+       const BrainUint depth,
+       BrainString activation,
+       const BrainUint batch,
+       const BenchResult* result)
+{
+    const BrainDouble gflops = result->_median * result->_flops * 1e-9;
+
+    printf("%-8s %-7s %6u %5u %-9s %5u %14.1f %10.1f %-9s %8.3f\n",
+           benchmark, get_precision(), width, depth, activation, batch,
+           result->_median, result->_mad, unit, gflops);
+
+    if (BRAIN_ALLOCATED(_json))
+    {
+        fprintf(_json,
+                "%s    {\"name\": \"%s/%s/w%u/d%u/%s%s/b%u\", \"benchmark\": \"%s\", \"precision\": \"%s\", "
+                "\"width\": %u, \"depth\": %u, \"activation\": \"%s\", \"fast_math\": %s, \"batch\": %u, "
+                "\"unit\": \"%s\", \"better\": \"higher\", \"median\": %.6g, \"mad\": %.6g, \"repeat\": %u, \"gflops\": %.6g}",
+                _first ? "" : ",\n",
+                benchmark, get_precision(), width, depth, activation, grid->_fast_math ? "-fast" : "", batch,
+                benchmark, get_precision(), width, depth, activation, grid->_fast_math ? "true" : "false", batch,
+                unit, result->_median, result->_mad, grid->_repeat, gflops);
+
+        _first = BRAIN_FALSE;
+    }
+
+    fflush(stdout);
+}
+
+static void
+run_shape(const BenchGrid* grid,
+          const BrainUint width,
+          const BrainUint depth,
+          BrainString activation)
+{
+    MLPNetwork     network   = new_bench_network(grid, width, depth, activation);
+    BrainOptimizer optimizer = new_optimizer("Momentum");
+    /******************************************************************/
+    /**  Multiply-adds of the weights: one for the forward pass, two **/
+    /**  for the backward pass which also propagates the errors     **/
+    /******************************************************************/
+    const BrainDouble weights = (BrainDouble)depth * (BrainDouble)width * (BrainDouble)(width + 1);
+    BenchResult result;
+    BrainUint i = 0;
+
+    if (!BRAIN_ALLOCATED(network))
+    {
+        fprintf(stderr, "Unable to create a network of %u layers of %u %s neurons\n", depth, width, activation);
+    }
+    else
+    {
+        configure_optimizer(optimizer, 1e-4, 0.9, 0.9, 0.999, 1e-8);
+
+        BRAIN_RESIZE(_inputs,  BrainReal, BENCH_POOL * width);
+        BRAIN_RESIZE(_targets, BrainReal, BENCH_POOL * width);
+        BRAIN_RESIZE(_losses,  BrainReal, width);
+
+        fill_random_uniform(get_thread_random(), _inputs,  BENCH_POOL * width, -1., 1.);
+        fill_random_uniform(get_thread_random(), _targets, BENCH_POOL * width,  0., 1.);
+
+        result._flops = 2. * weights;
+        measure(grid, network, optimizer, bench_predict, 1, &result);
+        report(grid, "predict", "samples/s", width, depth, activation, 1, &result);
+
+        result._flops = BENCH_UPDATE_FLOPS * weights;
+        measure(grid, network, optimizer, bench_update, 1, &result);
+        report(grid, "update", "updates/s", width, depth, activation, 1, &result);
+
+        for (i = 0; i < grid->_number_of_batches; ++i)
+        {
+            const BrainUint batch = grid->_batches[i];
+
+            result._flops = 6. * weights + BENCH_UPDATE_FLOPS * weights / (BrainDouble)batch;
+            measure(grid, network, optimizer, bench_train, batch, &result);
+            report(grid, "train", "samples/s", width, depth, activation, batch, &result);
+        }
+    }
+
+    delete_optimizer(optimizer);
+    delete_network(network);
+}
+
+static BrainUint
+parse_uints(BrainString text, BrainUint* values)
+{
+    BrainUint number_of_values = 0;
+
+    while (BRAIN_ALLOCATED(text)
+    &&     (*text != '\0')
+    &&     (number_of_values < BENCH_MAX_VALUES))
+    {
+        values[number_of_values++] = (BrainUint)strtoul(text, (BrainChar**)&text, 10);
+
+        if (*text == ',')
+        {
+            ++text;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return number_of_values;
+}
+
+static BrainUint
+parse_strings(BrainChar* text, BrainString* values)
+{
+    BrainUint number_of_values = 0;
+    BrainChar* token = strtok(text, ",");
+
+    while (BRAIN_ALLOCATED(token)
+    &&     (number_of_values < BENCH_MAX_VALUES))
+    {
+        values[number_of_values++] = token;
+        token = strtok(NULL, ",");
+    }
+
+    return number_of_values;
+}
+
+static void
+usage(BrainString program)
+{
+    printf("Usage: %s [options]\n"
+           "  --widths W,...       neurons per layer            (16,64,256)\n"
+           "  --depths D,...       number of layers, at least 2 (2,4)\n"
+           "  --activations A,...  activation functions         (Sigmoid,TanH,ReLu)\n"
+           "  --batches B,...      training minibatch sizes     (1,32)\n"
+           "  --fast-math          use the interpolated activations\n"
+           "  --repeat N           repetitions of each measure  (5)\n"
+           "  --time S             seconds per repetition       (0.1)\n"
+           "  --cpu C              pinned cpu, -1 to disable    (current cpu)\n"
+           "  --json FILE          also write the results as JSON\n"
+           "  --quick              a small grid for smoke tests\n",
+           program);
+}
+
+int
+main(int argc, char** argv)
+{
+    BenchGrid grid;
+    BrainChar activations[] = "Sigmoid,TanH,ReLu";
+    BrainInt  i = 0;
+    BrainUint w = 0, d = 0, a = 0;
+
+    memset(&grid, 0, sizeof(grid));
+
+    grid._number_of_widths      = parse_uints("16,64,256", grid._widths);
+    grid._number_of_depths      = parse_uints("2,4",       grid._depths);
+    grid._number_of_batches     = parse_uints("1,32",      grid._batches);
+    grid._number_of_activations = parse_strings(activations, grid._activations);
+    grid._repeat = 5;
+    grid._time   = 0.1;
+    grid._cpu    = sched_getcpu();
+
+    for (i = 1; i < argc; ++i)
+    {
+        const BrainBool has_value = (i + 1 < argc);
+
+        if (!strcmp(argv[i], "--widths") && has_value)
+        {
+            grid._number_of_widths = parse_uints(argv[++i], grid._widths);
+        }
+        else if (!strcmp(argv[i], "--depths") && has_value)
+        {
+            grid._number_of_depths = parse_uints(argv[++i], grid._depths);
+        }
+        else if (!strcmp(argv[i], "--activations") && has_value)
+        {
+            grid._number_of_activations = parse_strings(argv[++i], grid._activations);
+        }
+        else if (!strcmp(argv[i], "--batches") && has_value)
+        {
+            grid._number_of_batches = parse_uints(argv[++i], grid._batches);
+        }
+        else if (!strcmp(argv[i], "--fast-math"))
+        {
+            grid._fast_math = BRAIN_TRUE;
+        }
+        else if (!strcmp(argv[i], "--repeat") && has_value)
+        {
+            grid._repeat = (BrainUint)atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--time") && has_value)
+        {
+            grid._time = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--cpu") && has_value)
+        {
+            grid._cpu = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--json") && has_value)
+        {
+            grid._json = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--quick"))
+        {
+            grid._number_of_widths = parse_uints("16,64", grid._widths);
+            grid._number_of_depths = parse_uints("2",     grid._depths);
+            grid._number_of_batches = parse_uints("32",   grid._batches);
+            grid._repeat = 3;
+            grid._time   = 0.02;
+        }
+        else
+        {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+    }
+
+    grid._repeat = (grid._repeat < 1) ? 1 : ((BENCH_MAX_REPEAT < grid._repeat) ? BENCH_MAX_REPEAT : grid._repeat);
+
+    // the measures are single threaded, keep them on one cpu
+    if (0 <= grid._cpu)
+    {
+        cpu_set_t cpus;
+
+        CPU_ZERO(&cpus);
+        CPU_SET(grid._cpu, &cpus);
+
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+        {
+            fprintf(stderr, "Unable to pin the benchmark on cpu %d\n", grid._cpu);
+        }
+    }
+
+    if (BRAIN_ALLOCATED(grid._json))
+    {
+        _json = fopen(grid._json, "w");
+
+        if (BRAIN_ALLOCATED(_json))
+        {
+            fprintf(_json, "{\n  \"precision\": \"%s\",\n  \"cpu\": %d,\n  \"results\": [\n", get_precision(), grid._cpu);
+        }
+        else
+        {
+            fprintf(stderr, "Unable to write %s\n", grid._json);
+            return EXIT_FAILURE;
+        }
+    }
+
+    set_random_seed(42);
+
+    printf("%-8s %-7s %6s %5s %-9s %5s %14s %10s %-9s %8s\n",
+           "kernel", "real", "width", "depth", "function", "batch", "median", "mad", "unit", "GFLOP/s");
+
+    for (w = 0; w < grid._number_of_widths; ++w)
+    {
+        for (d = 0; d < grid._number_of_depths; ++d)
+        {
+            for (a = 0; a < grid._number_of_activations; ++a)
+            {
+                run_shape(&grid, grid._widths[w], grid._depths[d], grid._activations[a]);
+            }
+        }
+    }
+
+    if (BRAIN_ALLOCATED(_json))
+    {
+        fprintf(_json, "\n  ]\n}\n");
+        fclose(_json);
+    }
+
+    BRAIN_DELETE(_inputs);
+    BRAIN_DELETE(_targets);
+    BRAIN_DELETE(_losses);
+
+    return EXIT_SUCCESS;
+}
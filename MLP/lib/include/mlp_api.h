@@ -10,13 +10,19 @@
 #endif
 
 WINDOWS_EXPORT void        mlp_plugin_init                 ();
+WINDOWS_EXPORT BrainBool   mlp_plugin_set_allocator        (MLPAllocator);
 WINDOWS_EXPORT MLPMetaData mlp_plugin_metadata             ();
+WINDOWS_EXPORT BrainBool   mlp_plugin_start_timeline       (BrainString);
+WINDOWS_EXPORT void        mlp_plugin_stop_timeline        ();
+WINDOWS_EXPORT BrainBool   mlp_plugin_track_xml_memory     ();
+WINDOWS_EXPORT void        mlp_plugin_get_memory_stats     (MLPMemoryStats);
 
 WINDOWS_EXPORT MLPTrainer  mlp_trainer_new                 (BrainString, BrainString);
 WINDOWS_EXPORT void        mlp_trainer_delete              (MLPTrainer);
 WINDOWS_EXPORT void        mlp_trainer_configure           (MLPTrainer, BrainString);
 WINDOWS_EXPORT BrainBool   mlp_trainer_is_running          (MLPTrainer);
 WINDOWS_EXPORT BrainFloat  mlp_trainer_get_progress        (MLPTrainer);
+WINDOWS_EXPORT BrainUint   mlp_trainer_get_epoch           (MLPTrainer);
 WINDOWS_EXPORT void        mlp_trainer_run                 (MLPTrainer);
 WINDOWS_EXPORT BrainFloat  mlp_trainer_error               (MLPTrainer);
 WINDOWS_EXPORT void        mlp_trainer_save_progression    (MLPTrainer, BrainString);
@@ -25,6 +31,10 @@ WINDOWS_EXPORT MLPNetwork  mlp_trainer_get_network         (MLPTrainer);
 WINDOWS_EXPORT BrainSignal mlp_trainer_get_layer_output_signal(MLPTrainer, BrainUint);
 WINDOWS_EXPORT BrainSignal mlp_trainer_get_input_signal    (MLPTrainer);
 WINDOWS_EXPORT BrainSignal mlp_trainer_get_target_signal   (MLPTrainer);
+WINDOWS_EXPORT void        mlp_trainer_split               (MLPTrainer, BrainReal);
+WINDOWS_EXPORT void        mlp_trainer_select_fold         (MLPTrainer, BrainUint, BrainUint);
+WINDOWS_EXPORT void        mlp_trainer_get_stats           (MLPTrainer, MLPTrainerStats);
+WINDOWS_EXPORT void        mlp_trainer_get_memory_usage    (MLPTrainer, MLPMemoryUsage);
 
 WINDOWS_EXPORT MLPNetwork  mlp_network_new                 (BrainString);
 WINDOWS_EXPORT void        mlp_network_delete              (MLPNetwork);
@@ -38,6 +48,13 @@ WINDOWS_EXPORT BrainUint   mlp_network_get_number_of_input (MLPNetwork);
 WINDOWS_EXPORT BrainUint   mlp_network_get_layer_number_of_neuron  (MLPNetwork, BrainUint);
 WINDOWS_EXPORT BrainSignal mlp_network_get_layer_output_signal     (MLPNetwork, BrainUint);
 WINDOWS_EXPORT BrainSignal mlp_network_get_input_signal            (MLPNetwork);
+WINDOWS_EXPORT BrainUint   mlp_network_get_number_of_label         (MLPNetwork);
+WINDOWS_EXPORT BrainString mlp_network_get_label                   (MLPNetwork, BrainUint);
+WINDOWS_EXPORT BrainBool   mlp_network_is_preprocessing            (MLPNetwork);
+WINDOWS_EXPORT void        mlp_network_fold_preprocessing          (MLPNetwork);
+WINDOWS_EXPORT void        mlp_network_set_counters                (MLPNetwork, BrainBool);
+WINDOWS_EXPORT void        mlp_network_get_counters                (MLPNetwork, MLPCounterStats);
+WINDOWS_EXPORT void        mlp_network_get_memory_usage            (MLPNetwork, MLPMemoryUsage);
 
 
 #endif /* MLP_API_H */
@@ -15,26 +15,48 @@
  * \fn MLPLayer new_layer(const BrainUint number_of_neurons,
  *                        const BrainActivationFunction activation_function,
  *                        const BrainActivationFunction derivative_function,
+ *                        const BrainGradientFunction gradient_function,
  *                          const BrainUint number_of_inputs,
  *                          const BrainSignal in,
- *                          BrainSignal previous_errors)
+ *                          BrainSignal previous_errors,
+ *                          const BrainReal dropout,
+ *                          BrainMemoryArena arena)
  * \brief Fonction to create a MLPLayer from an XML context
  *
  * \param activation_function a BrainActivationFunction
  * \param derivative_function a BrainDerivativeFunction
+ * \param gradient_function the derivative computed from the outputs, or NULL
+ *                          to compute it from the weighted sums
  * \param number_of_neurons Number of neurons in this layer
  * \param number_of_inputs size of the input signal
  * \param in input signal
  * \param previous_errors errors vector of the prevous layer
+ * \param dropout rate at which neurons are dropped during training
+ * \param arena the BrainMemoryArena of the network, or NULL. The optimizer
+ *              states are then carved with the weights instead of being
+ *              allocated by the first update
  *
  * \return a new allocated MLPLayer or NULL if it failed
  */
 MLPLayer  new_layer                 (const BrainUint   number_of_neurons,
                                      const BrainActivationFunction activation_function,
                                      const BrainActivationFunction derivative_function,
+                                     const BrainGradientFunction   gradient_function,
                                      const BrainUint   number_of_inputs,
                                      const BrainSignal in,
-                                     BrainSignal       previous_errors);
+                                     BrainSignal       previous_errors,
+                                     const BrainReal   dropout,
+                                     BrainMemoryArena  arena);
+/**
+ * \fn size_t get_layer_memory_footprint(const BrainUint number_of_neurons, const BrainUint number_of_inputs)
+ * \brief get the bytes of a BrainMemoryArena taken by a MLPLayer
+ *
+ * \param number_of_neurons Number of neurons in this layer
+ * \param number_of_inputs size of the input signal
+ * \return the footprint in bytes
+ */
+size_t    get_layer_memory_footprint(const BrainUint number_of_neurons,
+                                     const BrainUint number_of_inputs);
 /**
  * \fn MLPNeuron get_layer_neuron(const MLPLayer layer, const BrainUint index)
  * \brief get a Neuron from the layer
@@ -68,6 +90,14 @@ BrainSignal get_layer_output          (const MLPLayer layer);
  * \param layer a MLPLayer
  */
 void        delete_layer              (MLPLayer layer);
+/**
+ * \fn void accumulate_layer_memory(const MLPLayer layer, MLPMemoryUsage usage)
+ * \brief add the neurons, signals, weights and optimizer states of a layer to a memory usage
+ *
+ * \param layer a MLPLayer
+ * \param usage the MLPMemoryUsage to increase
+ */
+void        accumulate_layer_memory   (const MLPLayer layer, MLPMemoryUsage usage);
 /**
  * \fn void backpropagate_output_layer(MLPLayer output_layer, const BrainUint number_of_output, const BrainSignal output, const BrainSignal desired)
  * \brief apply backpropagation algorithm on an output layer
@@ -95,13 +125,38 @@ void backpropagate_hidden_layer(MLPLayer hidden_layer);
  */
 BrainSignal get_layer_errors(const MLPLayer layer);
 /**
- * \fn void activate_layer(MLPLayer layer, const BrainBool hidden_layer)
- * \brief activate the layer
+ * \fn const BrainUint* get_layer_active_neurons(const MLPLayer layer)
+ * \brief get the neurons kept by the last activation
  *
  * \param layer a MLPLayer
- * \param hidden_layer is this layer an hidden layer
+ * \return the kept neurons in order, or NULL if all of them were kept
+ */
+const BrainUint* get_layer_active_neurons(const MLPLayer layer);
+/**
+ * \fn BrainUint get_layer_number_of_active_neuron(const MLPLayer layer)
+ * \brief get the number of neurons kept by the last activation
+ *
+ * \param layer a MLPLayer
+ * \return the number of kept neurons
+ */
+BrainUint get_layer_number_of_active_neuron(const MLPLayer layer);
+/**
+ * \fn void activate_layer(MLPLayer layer, const BrainBool use_dropout, const BrainUint* inputs, const BrainUint number_of_inputs)
+ * \brief activate the layer
+ *
+ * With dropout, only the kept neurons are activated and then
+ * backpropagated, the others output 0. Each neuron only reads the
+ * inputs kept by the previous layer.
+ *
+ * \param layer            a MLPLayer
+ * \param use_dropout      should neurons be dropped
+ * \param inputs           the kept inputs, NULL to use all of them
+ * \param number_of_inputs the number of kept inputs
  */
-void activate_layer(const MLPLayer layer, const BrainBool hidden_layer);
+void activate_layer(const MLPLayer layer,
+                    const BrainBool  use_dropout,
+                    const BrainUint* inputs,
+                    const BrainUint  number_of_inputs);
 /**
  * \fn void serialize_layer(MLPLayer layer, Writer writer)
  * \brief serialize a layer
@@ -119,16 +174,41 @@ void serialize_layer(MLPLayer layer, Writer writer);
  */
 void deserialize_layer(MLPLayer layer, Context context);
 /**
- * \fn void update_layer(MLPLayer layer,
- *                       BrainReal learning_rate,
- *                       BrainReal momentum)
+ * \fn void update_layer(MLPLayer layer, const BrainOptimizer optimizer)
+ * \brief apply correction to all neurons to reduce the total error
+ *
+ * Neurons dropped for the whole minibatch are left untouched. The
+ * optimizer states are allocated on the first update.
+ *
+ * \param layer     a MLPLayer
+ * \param optimizer the BrainOptimizer
+ */
+void update_layer(MLPLayer layer, const BrainOptimizer optimizer);
+/**
+ * \fn void reset_layer_optimizer(MLPLayer layer)
+ * \brief forget the optimizer states, before changing of optimizer
+ *
+ * \param layer a MLPLayer
+ */
+void reset_layer_optimizer(MLPLayer layer);
+/**
+ * \fn void fold_layer_input_model(MLPLayer layer, const BrainSignal scales, const BrainSignal shifts)
+ * \brief absorb an affine transformation of the inputs into all neurons
+ *
+ * \param layer  a MLPLayer
+ * \param scales one scale per input
+ * \param shifts one shift per input
+ */
+void fold_layer_input_model(MLPLayer layer,
+                            const BrainSignal scales,
+                            const BrainSignal shifts);
+/**
+ * \fn void initialize_layer_weights(MLPLayer layer)
+ * \brief draw new random weights for all neurons
  *
- * \brief apply correction to a neuron to reduce the total error
+ * The optimizer states are cleared as well.
  *
  * \param layer a MLPLayer
- * \param minibatch_size size of the mini batch
  */
-void update_layer(MLPLayer layer,
-                  BrainReal learning_rate,
-                  BrainReal momentum);
+void initialize_layer_weights(MLPLayer layer);
 #endif /* MLP_LAYER_H */
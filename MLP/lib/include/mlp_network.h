@@ -19,6 +19,14 @@
  * \param network MLPNetwork to deallocate
  */
 void delete_network(MLPNetwork network);
+/**
+ * \fn void accumulate_network_memory(const MLPNetwork network, MLPMemoryUsage usage)
+ * \brief add all the blocks owned by a network to a memory usage
+ *
+ * \param network the MLPNetwork
+ * \param usage   the MLPMemoryUsage to increase
+ */
+void accumulate_network_memory(const MLPNetwork network, MLPMemoryUsage usage);
 /**
  * \fn void predict(MLPNetwork network, const BrainUint number_of_input, const BrainSignal in)
  * \brief propagate an input signal from the input signal to the output layer
@@ -74,14 +82,13 @@ BrainUint get_network_number_of_layer(const MLPNetwork network);
  */
 void backpropagate(MLPNetwork network, const BrainUint number_of_output, const BrainSignal desired);
 /**
- * \fn void update_networkMLPNetwork network, BrainReal learning_rate, BrainReal momentum)
+ * \fn void update_network(MLPNetwork network, const BrainOptimizer optimizer)
  * \brief apply correction to a neuron to reduce the total error
  *
- * \param network a MLPNetwork
- * \param learning_rate the learning rate
- * \param momentum the momentum
+ * \param network   a MLPNetwork
+ * \param optimizer the BrainOptimizer, see step_optimizer
  */
-void update_network(MLPNetwork network, BrainReal learning_rate, BrainReal momentum);
+void update_network(MLPNetwork network, const BrainOptimizer optimizer);
 /**
  * \fn void deserialize_network(MLPNetwork network, BrainString filepath)
  * \brief load previously trained neural network's weight
@@ -135,5 +142,141 @@ BrainUint get_network_number_of_input(const MLPNetwork);
  * \return the input signal
  */
 BrainSignal get_network_input_signal(const MLPNetwork network);
+/**
+ * \fn void set_network_labels(MLPNetwork network, const BrainLabelDictionary labels)
+ * \brief Name the network outputs
+ *
+ * The labels are copied and saved with the network
+ *
+ * \param network the MLPNetwork
+ * \param labels  the label of each output
+ */
+void set_network_labels(MLPNetwork network, const BrainLabelDictionary labels);
+/**
+ * \fn BrainUint get_network_number_of_label(const MLPNetwork network)
+ * \brief Get the number of named outputs
+ *
+ * \param network the MLPNetwork
+ * \return the number of labels
+ */
+BrainUint get_network_number_of_label(const MLPNetwork network);
+/**
+ * \fn BrainString get_network_label(const MLPNetwork network, const BrainUint index)
+ * \brief Get the label of an output
+ *
+ * \param network the MLPNetwork
+ * \param index   the output index
+ * \return the label or NULL
+ */
+BrainString get_network_label(const MLPNetwork network, const BrainUint index);
+/**
+ * \fn void set_network_preprocessing(MLPNetwork network, const BrainSignal scales, const BrainSignal shifts)
+ * \brief Set the normalization of the raw inputs given to predict
+ *
+ * A raw input x is normalized into x * scale + shift before being
+ * propagated. The model is copied and saved with the network, NULL
+ * scales or shifts remove it. feedforward still expects normalized
+ * inputs.
+ *
+ * \param network the MLPNetwork
+ * \param scales  one scale per input
+ * \param shifts  one shift per input
+ */
+void set_network_preprocessing(MLPNetwork network,
+                               const BrainSignal scales,
+                               const BrainSignal shifts);
+/**
+ * \fn BrainBool is_network_preprocessing(const MLPNetwork network)
+ * \brief Check if predict normalizes the raw inputs
+ *
+ * \param network the MLPNetwork
+ * \return BRAIN_TRUE if the network has a preprocessing model
+ */
+BrainBool is_network_preprocessing(const MLPNetwork network);
+/**
+ * \fn void fold_network_preprocessing(MLPNetwork network)
+ * \brief Absorb the preprocessing model into the first layer
+ *
+ * The first layer weights and biases are rewritten so that predict
+ * gives the same outputs on raw inputs without normalizing them. The
+ * network then expects raw inputs, so it should not be trained again
+ * on normalized data.
+ *
+ * \param network the MLPNetwork
+ */
+void fold_network_preprocessing(MLPNetwork network);
+/**
+ * \fn void initialize_network_weights(MLPNetwork network)
+ * \brief Draw new random weights for all layers
+ *
+ * \param network the MLPNetwork
+ */
+void initialize_network_weights(MLPNetwork network);
+/**
+ * \fn void reset_network_optimizer(MLPNetwork network)
+ * \brief Forget the optimizer states of all layers
+ *
+ * \param network the MLPNetwork
+ */
+void reset_network_optimizer(MLPNetwork network);
+/**
+ * \fn void set_network_profiling(MLPNetwork network, const BrainBool profiling)
+ * \brief Start or stop timing each layer, starting resets the times
+ *
+ * Forward times cover all forward passes, evaluation included.
+ *
+ * \param network   the MLPNetwork
+ * \param profiling BRAIN_TRUE to time each layer
+ */
+void set_network_profiling(MLPNetwork network, const BrainBool profiling);
+/**
+ * \fn BrainDouble get_network_layer_forward_time(const MLPNetwork network, const BrainUint index)
+ * \brief Get the time spent activating a layer since profiling started
+ *
+ * \param network the MLPNetwork
+ * \param index   the layer index
+ * \return a time in seconds, 0 if the network is not profiled
+ */
+BrainDouble get_network_layer_forward_time(const MLPNetwork network, const BrainUint index);
+/**
+ * \fn BrainDouble get_network_layer_backward_time(const MLPNetwork network, const BrainUint index)
+ * \brief Get the time spent backpropagating a layer since profiling started
+ *
+ * \param network the MLPNetwork
+ * \param index   the layer index
+ * \return a time in seconds, 0 if the network is not profiled
+ */
+BrainDouble get_network_layer_backward_time(const MLPNetwork network, const BrainUint index);
+/**
+ * \fn void set_network_counters(MLPNetwork network, const BrainBool counters)
+ * \brief Start or stop reading the hardware counters around predict
+ *
+ * Starting resets the counts, see brain_counter_utils.h.
+ *
+ * \param network  the MLPNetwork
+ * \param counters BRAIN_TRUE to read the counters
+ */
+void set_network_counters(MLPNetwork network, const BrainBool counters);
+/**
+ * \fn void get_network_counters(const MLPNetwork network, MLPCounterStats stats)
+ * \brief Get the hardware counters of predict since they were started
+ *
+ * \param network the MLPNetwork
+ * \param stats   the counters and their rates per prediction
+ */
+void get_network_counters(const MLPNetwork network, MLPCounterStats stats);
+/**
+ * \fn void fill_counter_stats(MLPCounterStats stats, const BrainCounters counters, const BrainUlong* values, const BrainUlong number_of_samples)
+ * \brief Fill a CounterStats from the counts of a region
+ *
+ * \param stats             the CounterStats to fill
+ * \param counters          the BrainCounters that measured the region, may be NULL
+ * \param values            Counter_Last counts
+ * \param number_of_samples the number of samples of the region
+ */
+void fill_counter_stats(MLPCounterStats stats,
+                        const BrainCounters counters,
+                        const BrainUlong* values,
+                        const BrainUlong number_of_samples);
 
 #endif /* MLP_NETWORK_H */
@@ -13,27 +13,40 @@
 
 /**
  * \fn MLPNeuron new_neuron(    BrainActivationFunction activation_function,
- *                              BrainActivationFunction derivative_function,
  *                              BrainSignal in,
  *                              const BrainUint number_of_inputs,
  *                              BrainSignal out,
- *                              BrainSignal errors)
+ *                              BrainSignal errors,
+ *                              BrainReal* weights,
+ *                              BrainReal* gradients,
+ *                              BrainMemoryArena arena)
  * \brief method to build a neuron
  *
  * \param activation_function a BrainActivationFunction
- * \param derivative_function a BrainDerivativeFunction
  * \param in               a input BrainSignal
  * \param number_of_inputs input_signal_size
  * \param out            a pointer to a BrainReal owned by the MLPLayer
  * \param errors an array owned by the MLPLayer to update weights
+ * \param weights number_of_inputs + 1 weights owned by the MLPLayer, bias last
+ * \param gradients number_of_inputs + 1 gradients owned by the MLPLayer
+ * \param arena the BrainMemoryArena of the network, or NULL
  * \return a MLPNeuron or NULL if it failed
  */
 MLPNeuron new_neuron(  BrainActivationFunction  activation_function,
-                       BrainActivationFunction  derivative_function,
                        BrainSignal              in,
                        const BrainUint          number_of_inputs,
                        BrainSignal              out,
-                       BrainSignal              errors);
+                       BrainSignal              errors,
+                       BrainReal*               weights,
+                       BrainReal*               gradients,
+                       BrainMemoryArena         arena);
+/**
+ * \fn size_t get_neuron_memory_footprint()
+ * \brief get the bytes of a BrainMemoryArena taken by a MLPNeuron
+ *
+ * \return the footprint in bytes
+ */
+size_t    get_neuron_memory_footprint();
 /**
  * \fn void delete_neuron(MLPNeuron neuron)
  * \brief free all MLPNeuron memory
@@ -42,13 +55,24 @@ MLPNeuron new_neuron(  BrainActivationFunction  activation_function,
  */
 void        delete_neuron              (MLPNeuron       neuron);
 /**
- * \fn void activate_neuron(MLPNeuron neuron, const BrainBool   is_activated)
+ * \fn void accumulate_neuron_memory(const MLPNeuron neuron, MLPMemoryUsage usage)
+ * \brief add a MLPNeuron to a memory usage
+ *
+ * \param neuron a MLPNeuron
+ * \param usage  the MLPMemoryUsage to increase
+ */
+void        accumulate_neuron_memory   (const MLPNeuron neuron, MLPMemoryUsage usage);
+/**
+ * \fn void activate_neuron(MLPNeuron neuron, const BrainUint* inputs, const BrainUint number_of_inputs)
  * \brief activate the input neuron
  *
- * \param neuron            a MLPNeuron
- * \param is_activated is this neuron activated
+ * \param neuron           a MLPNeuron
+ * \param inputs           the kept inputs, NULL to use all of them
+ * \param number_of_inputs the number of kept inputs
  */
-void activate_neuron(MLPNeuron neuron, const BrainBool is_activated);
+void activate_neuron(MLPNeuron neuron,
+                     const BrainUint* inputs,
+                     const BrainUint  number_of_inputs);
 /**
  * \fn BrainUint get_neuron_number_of_input(const MLPNeuron neuron)
  * \brief retrieve the number of input
@@ -57,6 +81,14 @@ void activate_neuron(MLPNeuron neuron, const BrainBool is_activated);
  * \return the number of input
  */
 BrainUint get_neuron_number_of_input(const MLPNeuron neuron);
+/**
+ * \fn BrainReal get_neuron_sum(const MLPNeuron neuron)
+ * \brief retrieve the weighted sum of the last activation
+ *
+ * \param neuron the Neuron
+ * \return <in, W> + bias
+ */
+BrainReal get_neuron_sum(const MLPNeuron neuron);
 /**
  * \fn BrainReal get_neuron_weight(const MLPNeuron neuron, const BrainUint index)
  * \brief retrieve a neuron weight
@@ -66,19 +98,6 @@ BrainUint get_neuron_number_of_input(const MLPNeuron neuron);
  * \return the neuron weight
  */
 BrainReal get_neuron_weight(const MLPNeuron neuron, const BrainUint index);
-/**
- * \fn void update_neuron(MLPNeuron reuron,
- *                        BrainReal minibatch_size,
- *                        BrainReal learning_rate,
- *                        BrainReal momemtum )
- * \brief apply correction to a neuron to reduce the total error
- *
- * \param neuron a MLPNeuron
- * \param minibatch_size size of the mini batch
- */
-void update_neuron(MLPNeuron neuron,
-                    BrainReal learning_rate,
-                    BrainReal momentum);
 /**
  * \fn void deserialize_neuron(MLPNeuron neuron, Context context)
  * \brief deserialize a neuron from a context
@@ -96,11 +115,37 @@ void deserialize_neuron(MLPNeuron neuron, Context context);
  */
 void serialize_neuron(MLPNeuron neuron, Writer writer);
 /**
- * \fn void backpropagate_neuron_gradient(MLPNeuron neuron, const BranReal loss);
+ * \fn void backpropagate_neuron_gradient(MLPNeuron neuron, const BrainReal neuron_gradient, const BrainUint* inputs, const BrainUint number_of_inputs);
  * \brief accummulate gradient over minibatch loss input and backpropagate gradient based error
  *
+ * \param neuron           the neuron
+ * \param neuron_gradient  the error times the activation derivative, see BrainGradientFunction
+ * \param inputs           the kept inputs, NULL to use all of them
+ * \param number_of_inputs the number of kept inputs
+ */
+void backpropagate_neuron_gradient(MLPNeuron neuron,
+                                   const BrainReal  neuron_gradient,
+                                   const BrainUint* inputs,
+                                   const BrainUint  number_of_inputs);
+/**
+ * \fn void fold_neuron_input_model(MLPNeuron neuron, const BrainSignal scales, const BrainSignal shifts)
+ * \brief absorb an affine transformation of the inputs into the weights
+ *
+ * Once folded, the neuron computes on a raw input x the same output it
+ * previously computed on x * scale + shift
+ *
+ * \param neuron the neuron
+ * \param scales one scale per input
+ * \param shifts one shift per input
+ */
+void fold_neuron_input_model(MLPNeuron neuron,
+                             const BrainSignal scales,
+                             const BrainSignal shifts);
+/**
+ * \fn void initialize_neuron_weights(MLPNeuron neuron)
+ * \brief draw new random weights and bias, like a new neuron
+ *
  * \param neuron the neuron
- * \param loss the error
  */
-void backpropagate_neuron_gradient(MLPNeuron neuron, const BrainReal loss);
+void initialize_neuron_weights(MLPNeuron neuron);
 #endif /* MLP_NEURON_H */
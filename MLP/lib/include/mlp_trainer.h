@@ -5,14 +5,19 @@
 
 MLPTrainer  new_trainer                     (MLPNetwork, MLPData);
 void        delete_trainer                  (MLPTrainer);
+void        accumulate_trainer_memory       (const MLPTrainer, MLPMemoryUsage);
 void        configure_trainer_with_context  (MLPTrainer, BrainString);
 BrainBool   is_training_required            (const MLPTrainer);
 BrainReal   get_training_progress           (const MLPTrainer);
+BrainUint   get_training_epoch              (const MLPTrainer);
 void        step                            (MLPTrainer);
 BrainReal   get_trainer_error               (const MLPTrainer);
 void        save_trainer_progression        (MLPTrainer trainer, BrainString path);
 void        restore_trainer_progression     (MLPTrainer, BrainString, BrainReal, BrainReal);
 MLPNetwork  get_trainer_network             (MLPTrainer);
 BrainSignal get_trainer_target_signal		(MLPTrainer);
+void        split_trainer_data              (MLPTrainer, const BrainReal);
+void        select_trainer_fold             (MLPTrainer, const BrainUint, const BrainUint);
+void        get_trainer_stats               (const MLPTrainer, MLPTrainerStats);
 
 #endif /* MLP_TRAINER_H */
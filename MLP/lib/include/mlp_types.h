@@ -50,4 +50,76 @@ typedef struct MetaData
 * \brief Pointer on a MetaData struct
 */
 typedef struct MetaData* MLPMetaData;
+/**
+ * \brief Struct CounterStats, hardware counters of a region
+ *
+ * Rates are per sample of the region, unavailable counters are zero.
+ */
+typedef struct CounterStats
+{
+    BrainUlong  cycles;                   /*!< CPU cycles                      */
+    BrainUlong  instructions;             /*!< Retired instructions            */
+    BrainUlong  l1_misses;                /*!< L1 data cache read misses       */
+    BrainUlong  llc_misses;               /*!< Last level cache misses         */
+    BrainUlong  branch_misses;            /*!< Mispredicted branches           */
+    BrainUlong  number_of_samples;        /*!< Samples of the region           */
+    BrainDouble instructions_per_cycle;   /*!< IPC                             */
+    BrainDouble l1_misses_per_sample;     /*!< L1 misses per sample            */
+    BrainDouble llc_misses_per_sample;    /*!< LLC misses per sample           */
+    BrainDouble branch_misses_per_sample; /*!< Branch misses per sample        */
+    BrainUint   available;                /*!< 1 << BrainCounterType if read   */
+} CounterStats;
+/**
+* \brief Pointer on a CounterStats struct
+*/
+typedef struct CounterStats* MLPCounterStats;
+/**
+ * \def MLP_STATS_MAX_LAYERS
+ * \brief Number of layers timed in a TrainerStats
+ */
+#define MLP_STATS_MAX_LAYERS 16
+/**
+ * \brief Struct TrainerStats, times are in seconds
+ *
+ * Training, update, evaluation and serialization are always timed.
+ * Sampling, forward, backward and the layer times are only measured when
+ * the settings enable profiling, since they cost a clock read per sample.
+ * Hardware counters are only read when the settings enable them.
+ */
+typedef struct TrainerStats
+{
+    BrainDouble  training;                             /*!< Steps, evaluation excluded      */
+    BrainDouble  sampling;                             /*!< Drawing the training samples    */
+    BrainDouble  forward;                              /*!< Forward passes and loss         */
+    BrainDouble  backward;                             /*!< Backpropagation                 */
+    BrainDouble  update;                               /*!< Weights update                  */
+    BrainDouble  evaluation;                           /*!< Error on the evaluating samples */
+    BrainDouble  serialization;                        /*!< Saving and restoring            */
+    BrainDouble  samples_per_second;                   /*!< Trained samples per second      */
+    BrainUlong   number_of_samples;                    /*!< Trained samples                 */
+    BrainUlong   number_of_steps;                      /*!< Steps                           */
+    BrainUint    number_of_layers;                     /*!< Timed layers                    */
+    BrainDouble  layer_forward[MLP_STATS_MAX_LAYERS];  /*!< Activation of each layer        */
+    BrainDouble  layer_backward[MLP_STATS_MAX_LAYERS]; /*!< Backpropagation of each layer   */
+    CounterStats forward_counters;                     /*!< Forward passes and loss         */
+    CounterStats backward_counters;                    /*!< Backpropagation                 */
+    CounterStats update_counters;                      /*!< Weights update                  */
+    CounterStats evaluation_counters;                  /*!< Error on the evaluating samples */
+} TrainerStats;
+/**
+* \brief Pointer on a TrainerStats struct
+*/
+typedef struct TrainerStats* MLPTrainerStats;
+/**
+* \brief Pointer on a MemoryUsage struct, see brain_memory_utils.h
+*/
+typedef struct MemoryUsage* MLPMemoryUsage;
+/**
+* \brief Pointer on a MemoryStats struct, see brain_memory_utils.h
+*/
+typedef struct MemoryStats* MLPMemoryStats;
+/**
+* \brief Pointer on a BrainAllocator struct, see brain_memory_utils.h
+*/
+typedef const struct BrainAllocator* MLPAllocator;
 #endif /* MLP_TYPES_H */
@@ -5,6 +5,7 @@
 #include "brain_logging_utils.h"
 #include "brain_random_utils.h"
 #include "brain_memory_utils.h"
+#include "brain_weight_utils.h"
 
 /**
  * \struct Layer
@@ -12,16 +13,32 @@
  *
  * All protected fields for a MLPLayer
  */
-struct Layer
+typedef struct Layer
 {
     /******************************************************************/
     /**                      STRUCTURAL PARAMETERS                   **/
     /******************************************************************/
-    BrainUint       _number_of_neuron; /*!< The number of MLPNeuron    */
-    MLPNeuron*      _neurons;          /*!< An array of MLPNeuron      */
-    BrainSignal     _in_errors;        /*!< Input vector errors          */
-    BrainSignal     _out;              /*!< Output vector of the Layer   */
-    BrainRandomMask _mask;             /*!< Dropout activation mask      */
+    BrainUint               _number_of_neuron;    /*!< The number of MLPNeuron    */
+    MLPNeuron*              _neurons;             /*!< An array of MLPNeuron      */
+    BrainSignal             _in_errors;           /*!< Input vector errors        */
+    BrainSignal             _out;                 /*!< Output vector of the Layer */
+    BrainSignal             _deltas;              /*!< Loss times A' per neuron   */
+    BrainGradientFunction   _gradient_function;   /*!< A' from the outputs        */
+    BrainActivationFunction _derivative_function; /*!< A' from the sums           */
+    BrainRandomMask         _mask;                /*!< Dropout activation mask    */
+    BrainReal               _dropout;             /*!< Dropout rate               */
+    BrainReal               _scale;               /*!< Scale of the kept outputs  */
+    const BrainUint*        _active;              /*!< Kept neurons, NULL if all  */
+    BrainUint               _number_of_active;    /*!< Number of kept neurons     */
+    const BrainUint*        _inputs;              /*!< Kept inputs, NULL if all   */
+    BrainUint               _number_of_inputs;    /*!< Number of kept inputs      */
+    BrainBool*              _pending;             /*!< Neurons with a gradient    */
+    BrainUint               _number_of_weights;   /*!< Weights per neuron, bias   */
+    BrainReal*              _weights;             /*!< Weights, a row per neuron  */
+    BrainReal*              _gradients;           /*!< Gradients of the weights   */
+    BrainReal*              _first;               /*!< First optimizer state      */
+    BrainReal*              _second;              /*!< Second optimizer state     */
+    BrainBool               _carved;              /*!< States carved in an arena  */
 } Layer;
 
 MLPNeuron
@@ -36,6 +53,29 @@ get_layer_neuron(const MLPLayer layer, const BrainUint index)
     return NULL;
 }
 
+void
+reset_layer_optimizer(MLPLayer layer)
+{
+    BRAIN_INPUT(reset_layer_optimizer)
+    if (BRAIN_ALLOCATED(layer))
+    {
+        if (layer->_carved)
+        {
+            // states carved in the arena are kept for the next optimizer
+            BRAIN_SET(layer->_first,  0, BrainReal, layer->_number_of_neuron * layer->_number_of_weights);
+            BRAIN_SET(layer->_second, 0, BrainReal, layer->_number_of_neuron * layer->_number_of_weights);
+        }
+        else
+        {
+            // states are allocated again by the next update
+            BRAIN_DELETE(layer->_first);
+            BRAIN_DELETE(layer->_second);
+        }
+        BRAIN_SET(layer->_pending, 0, BrainBool, layer->_number_of_neuron);
+    }
+    BRAIN_OUTPUT(reset_layer_optimizer)
+}
+
 void
 delete_layer(MLPLayer layer)
 {
@@ -57,7 +97,13 @@ delete_layer(MLPLayer layer)
 
         delete_random_mask(layer->_mask);
 
+        BRAIN_DELETE(layer->_pending);
+        BRAIN_DELETE(layer->_weights);
+        BRAIN_DELETE(layer->_gradients);
+        BRAIN_DELETE(layer->_first);
+        BRAIN_DELETE(layer->_second);
         BRAIN_DELETE(layer->_out);
+        BRAIN_DELETE(layer->_deltas);
         BRAIN_DELETE(layer->_in_errors);
         BRAIN_DELETE(layer);
     }
@@ -65,13 +111,62 @@ delete_layer(MLPLayer layer)
     BRAIN_OUTPUT(delete_layer)
 }
 
+void
+accumulate_layer_memory(const MLPLayer layer, MLPMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(layer))
+    {
+        if (BRAIN_ALLOCATED(layer->_neurons))
+        {
+            BrainUint i;
+
+            for (i = 0; i < layer->_number_of_neuron; ++i)
+            {
+                accumulate_neuron_memory(layer->_neurons[i], usage);
+            }
+
+            accumulate_memory_usage(usage, layer->_neurons);
+        }
+
+        accumulate_random_mask_memory(layer->_mask, usage);
+
+        accumulate_memory_usage(usage, layer->_pending);
+        accumulate_memory_usage(usage, layer->_weights);
+        accumulate_memory_usage(usage, layer->_gradients);
+        accumulate_memory_usage(usage, layer->_first);
+        accumulate_memory_usage(usage, layer->_second);
+        accumulate_memory_usage(usage, layer->_out);
+        accumulate_memory_usage(usage, layer->_deltas);
+        accumulate_memory_usage(usage, layer->_in_errors);
+        accumulate_memory_usage(usage, layer);
+    }
+}
+
+size_t
+get_layer_memory_footprint(const BrainUint number_of_neurons,
+                           const BrainUint number_of_inputs)
+{
+    const size_t number_of_weights = (size_t)number_of_neurons * (number_of_inputs + 1);
+
+    // every block carved by new_layer
+    return get_memory_arena_footprint(1, sizeof(Layer), Memory_Other)
+    +      get_memory_arena_footprint(number_of_neurons, sizeof(MLPNeuron), Memory_Other)
+    +      get_memory_arena_footprint(number_of_neurons, sizeof(BrainBool), Memory_Other)
+    +      3 * get_memory_arena_footprint(number_of_neurons, sizeof(BrainReal), Memory_Activations)
+    +      4 * get_memory_arena_footprint(number_of_weights, sizeof(BrainReal), Memory_Weights)
+    +      number_of_neurons * get_neuron_memory_footprint();
+}
+
 MLPLayer
 new_layer(const BrainUint     number_of_neurons,
           const BrainActivationFunction activation_function,
           const BrainActivationFunction derivative_function,
+          const BrainGradientFunction   gradient_function,
           const BrainUint     number_of_inputs,
           const BrainSignal   in,
-          BrainSignal         out_errors)
+          BrainSignal         out_errors,
+          const BrainReal     dropout,
+          BrainMemoryArena    arena)
 {
     BRAIN_INPUT(new_layer)
     /******************************************************************/
@@ -83,18 +178,47 @@ new_layer(const BrainUint     number_of_neurons,
     &&  (number_of_neurons != 0)
     &&  BRAIN_ALLOCATED(in))
     {
-        _layer                    = (MLPLayer)calloc(1, sizeof(Layer));
+        BRAIN_NEW_IN(arena, _layer, Layer, 1, Memory_Other);
         _layer->_number_of_neuron = number_of_neurons;
 
         if (0 != _layer->_number_of_neuron)
         {
             BrainUint index = 0;
 
-            BRAIN_NEW(_layer->_neurons, MLPNeuron,_layer->_number_of_neuron);
-            BRAIN_NEW(_layer->_out, BrainReal, _layer->_number_of_neuron);
-            BRAIN_NEW(_layer->_in_errors, BrainReal, _layer->_number_of_neuron);
+            BRAIN_NEW_IN(arena, _layer->_neurons, MLPNeuron, _layer->_number_of_neuron, Memory_Other);
+            BRAIN_NEW_IN(arena, _layer->_pending, BrainBool, _layer->_number_of_neuron, Memory_Other);
+            BRAIN_NEW_IN(arena, _layer->_out, BrainReal, _layer->_number_of_neuron, Memory_Activations);
+            BRAIN_NEW_IN(arena, _layer->_in_errors, BrainReal, _layer->_number_of_neuron, Memory_Activations);
+            BRAIN_NEW_IN(arena, _layer->_deltas, BrainReal, _layer->_number_of_neuron, Memory_Activations);
+            /******************************************************/
+            /**  All weights of the layer are contiguous, a row  **/
+            /**  per neuron with the bias last, so that they are **/
+            /**  updated by a single loop                        **/
+            /******************************************************/
+            _layer->_number_of_weights = number_of_inputs + 1;
+            BRAIN_NEW_IN(arena, _layer->_weights,   BrainReal, _layer->_number_of_neuron * _layer->_number_of_weights, Memory_Weights);
+            BRAIN_NEW_IN(arena, _layer->_gradients, BrainReal, _layer->_number_of_neuron * _layer->_number_of_weights, Memory_Weights);
+            _layer->_first  = NULL;
+            _layer->_second = NULL;
+            _layer->_carved = BRAIN_ALLOCATED(arena);
+
+            if (_layer->_carved)
+            {
+                // the optimizer is not known yet, room for the one with the most states
+                BRAIN_NEW_IN(arena, _layer->_first,  BrainReal, _layer->_number_of_neuron * _layer->_number_of_weights, Memory_Weights);
+                BRAIN_NEW_IN(arena, _layer->_second, BrainReal, _layer->_number_of_neuron * _layer->_number_of_weights, Memory_Weights);
+            }
 
-            _layer->_mask       = new_random_mask(_layer->_number_of_neuron);
+            _layer->_gradient_function   = gradient_function;
+            _layer->_derivative_function = derivative_function;
+
+            _layer->_dropout          = dropout;
+            _layer->_scale            = 1.;
+            _layer->_active           = NULL;
+            _layer->_number_of_active = _layer->_number_of_neuron;
+            _layer->_inputs           = NULL;
+            _layer->_number_of_inputs = number_of_inputs;
+            _layer->_mask             = new_random_mask(_layer->_number_of_neuron, dropout);
 
             for (index = 0; (index < _layer->_number_of_neuron); ++index)
             {
@@ -113,11 +237,13 @@ new_layer(const BrainUint     number_of_neurons,
                 /**                out_error      in_error           **/
                 /******************************************************/
                 _layer->_neurons[index] = new_neuron(activation_function,
-                                                     derivative_function,
                                                      in,
                                                      number_of_inputs,
                                                      &(_layer->_out[index]),
-                                                     out_errors);
+                                                     out_errors,
+                                                     _layer->_weights   + index * _layer->_number_of_weights,
+                                                     _layer->_gradients + index * _layer->_number_of_weights,
+                                                     arena);
             }
         }
     }
@@ -166,6 +292,65 @@ get_layer_errors(const MLPLayer layer)
     return ret;
 }
 
+const BrainUint*
+get_layer_active_neurons(const MLPLayer layer)
+{
+    const BrainUint* ret = NULL;
+
+    if (BRAIN_ALLOCATED(layer))
+    {
+        ret = layer->_active;
+    }
+
+    return ret;
+}
+
+BrainUint
+get_layer_number_of_active_neuron(const MLPLayer layer)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(layer))
+    {
+        ret = layer->_number_of_active;
+    }
+
+    return ret;
+}
+
+static void
+compute_layer_deltas(MLPLayer layer, const BrainReal* losses)
+{
+    /******************************************************************/
+    /**  $_j = loss_j * A'(<in, W>) for the whole layer at once      **/
+    /**                                                              **/
+    /**  A' is written from the cached outputs when it can, so no    **/
+    /**  activation is evaluated again. Dropped neurons are computed **/
+    /**  too, to keep a single loop, but their delta is never read   **/
+    /******************************************************************/
+    if (BRAIN_ALLOCATED(layer->_gradient_function))
+    {
+        layer->_gradient_function(layer->_out,
+                                  losses,
+                                  layer->_scale,
+                                  layer->_deltas,
+                                  layer->_number_of_neuron);
+    }
+    else if (BRAIN_ALLOCATED(layer->_derivative_function))
+    {
+        BrainUint k = 0;
+
+        for (k = 0; k < layer->_number_of_active; ++k)
+        {
+            const BrainUint i = BRAIN_ALLOCATED(layer->_active) ? layer->_active[k] : k;
+
+            layer->_deltas[i] = losses[i]
+                              * layer->_scale
+                              * layer->_derivative_function(get_neuron_sum(layer->_neurons[i]));
+        }
+    }
+}
+
 void
 backpropagate_output_layer(MLPLayer output_layer,
                            const BrainUint number_of_output,
@@ -217,6 +402,8 @@ backpropagate_output_layer(MLPLayer output_layer,
         {
             BrainUint output_index = 0;
 
+            compute_layer_deltas(output_layer, loss);
+
             for (output_index = 0;
                  output_index < number_of_output;
                ++output_index)
@@ -224,7 +411,11 @@ backpropagate_output_layer(MLPLayer output_layer,
                 /**************************************************/
                 /**           BACKPROPAGATE THE LOSS             **/
                 /**************************************************/
-                backpropagate_neuron_gradient(output_layer->_neurons[output_index], loss[output_index]);
+                backpropagate_neuron_gradient(output_layer->_neurons[output_index],
+                                              output_layer->_deltas[output_index],
+                                              output_layer->_inputs,
+                                              output_layer->_number_of_inputs);
+                output_layer->_pending[output_index] = BRAIN_TRUE;
             }
         }
     }
@@ -268,55 +459,71 @@ backpropagate_hidden_layer(MLPLayer hidden_layer)
 
     if (hidden_layer != NULL)
     {
-        const BrainUint current_number_of_neuron = hidden_layer->_number_of_neuron;
-        BrainUint i = 0;
+        BrainUint k = 0;
+
+        compute_layer_deltas(hidden_layer, hidden_layer->_in_errors);
 
-        for (i = 0; i < current_number_of_neuron; ++i)
+        /**************************************************************/
+        /**  Dropped neurons have no output, thus no error, only the **/
+        /**  kept ones are backpropagated                            **/
+        /**************************************************************/
+        for (k = 0; k < hidden_layer->_number_of_active; ++k)
         {
-            const BrainReal loss = hidden_layer->_in_errors[i];
-            const BrainBool activated = get_random_state(hidden_layer->_mask, i);
+            const BrainUint i = BRAIN_ALLOCATED(hidden_layer->_active) ? hidden_layer->_active[k] : k;
 
-            if (activated)
-            {
-                backpropagate_neuron_gradient(hidden_layer->_neurons[i], loss);
-            }
+            backpropagate_neuron_gradient(hidden_layer->_neurons[i],
+                                          hidden_layer->_deltas[i],
+                                          hidden_layer->_inputs,
+                                          hidden_layer->_number_of_inputs);
+            hidden_layer->_pending[i] = BRAIN_TRUE;
         }
     }
     BRAIN_OUTPUT(backpropagate_hidden_layer)
 }
 
 void
-activate_layer(MLPLayer layer, const BrainBool hidden_layer)
+activate_layer(MLPLayer layer,
+               const BrainBool  use_dropout,
+               const BrainUint* inputs,
+               const BrainUint  number_of_inputs)
 {
     BRAIN_INPUT(activate_layer)
     if (BRAIN_ALLOCATED(layer))
     {
-        BrainUint i = 0;
+        BrainUint k = 0;
 
-        BRAIN_SET(layer->_in_errors, 0, BrainReal, layer->_number_of_neuron);
+        layer->_inputs           = inputs;
+        layer->_number_of_inputs = number_of_inputs;
+        layer->_active           = NULL;
+        layer->_number_of_active = layer->_number_of_neuron;
+        layer->_scale            = 1.;
 
-        if (hidden_layer)
-        {
-            generate_random_mask(layer->_mask);
-        }
-        else
+        if (use_dropout
+        &&  (0. < layer->_dropout))
         {
-            // if dropout is not activated on this layer
-            // thus all neurons will be activated
-            generate_unit_mask(layer->_mask);
+            /**********************************************************/
+            /**  Only the kept neurons are activated, their outputs  **/
+            /**  are scaled so that their expectation does not       **/
+            /**  depend on the dropout (inverted dropout)            **/
+            /**********************************************************/
+            layer->_number_of_active = generate_random_mask(layer->_mask);
+            layer->_active           = get_random_mask_indices(layer->_mask);
+            layer->_scale            = 1. / (1. - layer->_dropout);
+
+            BRAIN_SET(layer->_out, 0, BrainReal, layer->_number_of_neuron);
         }
 
-#if defined(__GNUC__)
-        #pragma GCC ivdep
-#endif
-        for (i = 0; i < layer->_number_of_neuron; ++i)
+        for (k = 0; k < layer->_number_of_active; ++k)
         {
-            const BrainBool activation = get_random_state(layer->_mask, i);
+            const BrainUint i = BRAIN_ALLOCATED(layer->_active) ? layer->_active[k] : k;
 
             /**********************************************************/
-            /**                    ACTIVATE ALL NEURONS              **/
+            /**                  ACTIVATE KEPT NEURONS               **/
             /**********************************************************/
-            activate_neuron(layer->_neurons[i], !hidden_layer || activation);
+            activate_neuron(layer->_neurons[i], inputs, number_of_inputs);
+
+            layer->_out[i]      *= layer->_scale;
+            layer->_in_errors[i] = 0.;
         }
     }
     BRAIN_OUTPUT(activate_layer)
@@ -368,31 +575,111 @@ deserialize_layer(MLPLayer layer, Context context)
 
                 deserialize_neuron(neuron, neuron_context);
             }
+
+            BRAIN_SET(layer->_gradients, 0, BrainReal, number_of_neurons * layer->_number_of_weights);
+            reset_layer_optimizer(layer);
         }
     }
     BRAIN_OUTPUT(deserialize_layer)
 }
 
 void
-update_layer(MLPLayer layer,
-             BrainReal learning_rate,
-             BrainReal momentum)
+update_layer(MLPLayer layer, const BrainOptimizer optimizer)
 {
     BRAIN_INPUT(update_layer)
 
-    if (BRAIN_ALLOCATED(layer))
+    if (BRAIN_ALLOCATED(layer)
+    &&  BRAIN_ALLOCATED(optimizer))
     {
+        const BrainUint number_of_states  = get_optimizer_number_of_states(optimizer);
+        const BrainUint number_of_weights = layer->_number_of_weights;
         BrainUint i = 0;
-        for (i = 0; i < layer->_number_of_neuron; ++i)
+
+        if ((1 <= number_of_states)
+        &&  !BRAIN_ALLOCATED(layer->_first))
+        {
+            BRAIN_NEW_TAG(layer->_first, BrainReal, layer->_number_of_neuron * number_of_weights, Memory_Weights);
+        }
+
+        if ((2 <= number_of_states)
+        &&  !BRAIN_ALLOCATED(layer->_second))
+        {
+            BRAIN_NEW_TAG(layer->_second, BrainReal, layer->_number_of_neuron * number_of_weights, Memory_Weights);
+        }
+
+        while (i < layer->_number_of_neuron)
         {
             /**********************************************************/
-            /**                    UPDATE ALL NEURONS                **/
+            /**  UPDATE ALL NEURONS KEPT AT LEAST ONCE IN THE BATCH  **/
+            /**                                                      **/
+            /**  Consecutive kept neurons are contiguous rows, each  **/
+            /**  run of them is updated at once                      **/
             /**********************************************************/
-            update_neuron(layer->_neurons[i],
-                          learning_rate,
-                          momentum);
+            BrainUint j = i;
+
+            while ((j < layer->_number_of_neuron)
+            &&     layer->_pending[j])
+            {
+                layer->_pending[j] = BRAIN_FALSE;
+                ++j;
+            }
+
+            if (i < j)
+            {
+                const BrainUint offset = i * number_of_weights;
+
+                update_weights(optimizer,
+                               layer->_weights   + offset,
+                               layer->_gradients + offset,
+                               BRAIN_ALLOCATED(layer->_first)  ? layer->_first  + offset : NULL,
+                               BRAIN_ALLOCATED(layer->_second) ? layer->_second + offset : NULL,
+                               (j - i) * number_of_weights);
+                i = j;
+            }
+            else
+            {
+                ++i;
+            }
         }
     }
 
     BRAIN_OUTPUT(update_layer)
 }
+
+void
+fold_layer_input_model(MLPLayer layer,
+                       const BrainSignal scales,
+                       const BrainSignal shifts)
+{
+    BRAIN_INPUT(fold_layer_input_model)
+    if (BRAIN_ALLOCATED(layer))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < layer->_number_of_neuron; ++i)
+        {
+            fold_neuron_input_model(layer->_neurons[i], scales, shifts);
+        }
+
+        reset_layer_optimizer(layer);
+    }
+    BRAIN_OUTPUT(fold_layer_input_model)
+}
+
+void
+initialize_layer_weights(MLPLayer layer)
+{
+    BRAIN_INPUT(initialize_layer_weights)
+    if (BRAIN_ALLOCATED(layer))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < layer->_number_of_neuron; ++i)
+        {
+            initialize_neuron_weights(layer->_neurons[i]);
+        }
+
+        reset_layer_optimizer(layer);
+    }
+    BRAIN_OUTPUT(initialize_layer_weights)
+}
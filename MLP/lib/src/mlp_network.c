@@ -9,6 +9,9 @@
 #include "brain_math_utils.h"
 #include "brain_memory_utils.h"
 #include "brain_function_utils.h"
+#include "brain_label_utils.h"
+#include "brain_counter_utils.h"
+#include "brain_timeline_utils.h"
 
 #include "brain_probe.h"
 
@@ -28,8 +31,58 @@ typedef struct Network
     BrainSignal   _input;            /*!< Input signal of the network    */
     BrainUint     _number_of_inputs; /*!< Number of inputs               */
     BrainUint     _number_of_layers; /*!< Number of layers               */
+    BrainLabelDictionary _labels;    /*!< Label of each output           */
+    BrainSignal   _scales;           /*!< Input preprocessing scales     */
+    BrainSignal   _shifts;           /*!< Input preprocessing shifts     */
+    BrainDouble*  _forward_times;    /*!< Time per layer, NULL if off    */
+    BrainDouble*  _backward_times;   /*!< Time per layer, NULL if off    */
+    BrainCounters _counters;         /*!< Predict counters, NULL if off  */
+    BrainUlong*   _counts;           /*!< Counter_Last predict counts    */
+    BrainUlong    _predictions;      /*!< Number of counted predictions  */
 } Network;
 
+static void
+activate_network(MLPNetwork network, const BrainBool use_dropout)
+{
+    const BrainUint* inputs = NULL;
+    BrainUint number_of_inputs = network->_number_of_inputs;
+    BrainDouble time = 0.;
+    BrainUint i = 0;
+
+    if (BRAIN_ALLOCATED(network->_forward_times))
+    {
+        time = brain_probe_now();
+    }
+
+    for (i = 0; i < network->_number_of_layers; ++i)
+    {
+        const BrainUlong span = brain_timeline_begin();
+        /**************************************************************/
+        /**                    ACTIVATE ALL LAYERS                   **/
+        /**                                                          **/
+        /** Each layer only reads the neurons kept by the previous   **/
+        /** one                                                      **/
+        /**************************************************************/
+        activate_layer(network->_layers[i],
+                       use_dropout && (i != network->_number_of_layers - 1),
+                       inputs,
+                       number_of_inputs);
+
+        inputs           = get_layer_active_neurons(network->_layers[i]);
+        number_of_inputs = get_layer_number_of_active_neuron(network->_layers[i]);
+
+        brain_timeline_end("forward", "layer", span, (BrainInt)i);
+
+        if (BRAIN_ALLOCATED(network->_forward_times))
+        {
+            const BrainDouble now = brain_probe_now();
+
+            network->_forward_times[i] += now - time;
+            time = now;
+        }
+    }
+}
+
 void
 feedforward(MLPNetwork      network,
             const BrainUint   number_of_input,
@@ -42,28 +95,18 @@ feedforward(MLPNetwork      network,
         BRAIN_ALLOCATED(network) &&
         (number_of_input == network->_number_of_inputs))
     {
-        BrainUint i = 0;
         /**************************************************************/
         /**           FEED THE NETWORK WITH INPUT VECTOR             **/
         /**************************************************************/
         memcpy(network->_input, in, number_of_input*sizeof(BrainReal));
-#if defined(__GNUC__)
-        #pragma GCC ivdep
-#endif
-        for (i = 0; i < network->_number_of_layers; ++i)
-        {
-            /**********************************************************/
-            /**                    ACTIVATE ALL LAYERS               **/
-            /**********************************************************/
-            activate_layer(network->_layers[i], use_dropout && (i != network->_number_of_layers - 1));
-        }
+        activate_network(network, use_dropout);
     }
 
     BRAIN_OUTPUT(feedforward)
 }
 
 void
-update_network(MLPNetwork network, BrainReal learning_rate, BrainReal momentum)
+update_network(MLPNetwork network, const BrainOptimizer optimizer)
 {
     BRAIN_INPUT(update_network)
 
@@ -76,7 +119,7 @@ update_network(MLPNetwork network, BrainReal learning_rate, BrainReal momentum)
             /**********************************************************/
             /**                    UPDATE ALL LAYERS               **/
             /**********************************************************/
-            update_layer(network->_layers[i], learning_rate, momentum);
+            update_layer(network->_layers[i], optimizer);
         }
     }
 
@@ -146,16 +189,46 @@ backpropagate(MLPNetwork network,
         (0 < network->_number_of_layers)    &&
         BRAIN_ALLOCATED(loss))
     {
+        BrainDouble* times = network->_backward_times;
+        BrainDouble  time  = 0.;
+        BrainUlong   span  = brain_timeline_begin();
         BrainUint i = 0;
 
+        if (BRAIN_ALLOCATED(times))
+        {
+            time = brain_probe_now();
+        }
+
         /**************************************************************/
         /**                         BACKPROPAGATE THE LOSS           **/
         /**************************************************************/
         backpropagate_output_layer(network->_layers[network->_number_of_layers - 1], number_of_output, loss);
 
+        brain_timeline_end("backward", "layer", span, (BrainInt)(network->_number_of_layers - 1));
+
+        if (BRAIN_ALLOCATED(times))
+        {
+            const BrainDouble now = brain_probe_now();
+
+            times[network->_number_of_layers - 1] += now - time;
+            time = now;
+        }
+
         for (i = 1; i < network->_number_of_layers; ++i)
         {
+            span = brain_timeline_begin();
+
             backpropagate_hidden_layer(network->_layers[network->_number_of_layers - i - 1]);
+
+            brain_timeline_end("backward", "layer", span, (BrainInt)(network->_number_of_layers - i - 1));
+
+            if (BRAIN_ALLOCATED(times))
+            {
+                const BrainDouble now = brain_probe_now();
+
+                times[network->_number_of_layers - i - 1] += now - time;
+                time = now;
+            }
         }
     }
 
@@ -180,6 +253,10 @@ delete_network(MLPNetwork network)
 
     if (BRAIN_ALLOCATED(network))
     {
+        /******************************************************************/
+        /**  Blocks carved out of the arena of the network only update  **/
+        /**  the accounting, the arena is released with the last one    **/
+        /******************************************************************/
         if (BRAIN_ALLOCATED(network->_layers) &&
             (network->_number_of_layers != 0))
         {
@@ -190,6 +267,14 @@ delete_network(MLPNetwork network)
             }
         }
 
+        BRAIN_DELETE(network->_layers);
+        delete_label_dictionary(network->_labels);
+        BRAIN_DELETE(network->_scales);
+        BRAIN_DELETE(network->_shifts);
+        BRAIN_DELETE(network->_forward_times);
+        BRAIN_DELETE(network->_backward_times);
+        delete_counters(network->_counters);
+        BRAIN_DELETE(network->_counts);
         BRAIN_DELETE(network->_input);
         BRAIN_DELETE(network);
     }
@@ -197,12 +282,42 @@ delete_network(MLPNetwork network)
     BRAIN_OUTPUT(delete_network)
 }
 
+void
+accumulate_network_memory(const MLPNetwork network, MLPMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(network))
+    {
+        if (BRAIN_ALLOCATED(network->_layers))
+        {
+            BrainUint i = 0;
+            for (i = 0; i < network->_number_of_layers; ++i)
+            {
+                accumulate_layer_memory(network->_layers[i], usage);
+            }
+        }
+
+        accumulate_label_dictionary_memory(network->_labels, usage);
+        accumulate_memory_usage(usage, network->_layers);
+        accumulate_memory_usage(usage, network->_scales);
+        accumulate_memory_usage(usage, network->_shifts);
+        accumulate_memory_usage(usage, network->_forward_times);
+        accumulate_memory_usage(usage, network->_backward_times);
+        accumulate_memory_usage(usage, network->_counters);
+        accumulate_memory_usage(usage, network->_counts);
+        accumulate_memory_usage(usage, network->_input);
+        accumulate_memory_usage(usage, network);
+    }
+}
+
 static MLPNetwork
 new_network(const BrainUint signal_input_length,
             const BrainUint number_of_layers,
             const BrainUint *neuron_per_layers,
             const BrainActivationFunction *activation_functions,
-            const BrainActivationFunction *derivative_functions)
+            const BrainActivationFunction *derivative_functions,
+            const BrainGradientFunction *gradient_functions,
+            const BrainReal *dropouts,
+            const BrainBool use_arena)
 {
     BRAIN_INPUT(new_network)
 
@@ -213,14 +328,48 @@ new_network(const BrainUint signal_input_length,
 
     if (BRAIN_ALLOCATED(neuron_per_layers)
     &&  BRAIN_ALLOCATED(activation_functions)
-    &&  BRAIN_ALLOCATED(derivative_functions))
+    &&  BRAIN_ALLOCATED(derivative_functions)
+    &&  BRAIN_ALLOCATED(gradient_functions)
+    &&  BRAIN_ALLOCATED(dropouts))
     {
         BrainUint number_of_inputs = signal_input_length;
-        BRAIN_NEW(_network, Network, 1);
+        BrainMemoryArena arena = NULL;
+
+        if (use_arena)
+        {
+            /**********************************************************/
+            /**  The whole topology is carved out of one allocation: **/
+            /**  each layer keeps its structures, signals, weights   **/
+            /**  and optimizer states next to each other, and the    **/
+            /**  arena goes back to the allocator with the network   **/
+            /**********************************************************/
+            size_t size = get_memory_arena_footprint(1, sizeof(Network), Memory_Other)
+                        + get_memory_arena_footprint(signal_input_length, sizeof(BrainReal), Memory_Activations)
+                        + get_memory_arena_footprint(number_of_layers, sizeof(MLPLayer), Memory_Other);
+            BrainUint index = 0;
+
+            for (index = 0; index < number_of_layers; ++index)
+            {
+                size += get_layer_memory_footprint(neuron_per_layers[index],
+                                                   (index == 0) ? signal_input_length : neuron_per_layers[index - 1]);
+            }
+
+            arena = new_memory_arena(size);
+        }
+
+        BRAIN_NEW_IN(arena, _network, Network, 1, Memory_Other);
         _network->_number_of_inputs = signal_input_length;
-        BRAIN_NEW(_network->_input, BrainReal, signal_input_length);
-        BRAIN_NEW(_network->_layers, MLPLayer, number_of_layers);
+        BRAIN_NEW_IN(arena, _network->_input, BrainReal, signal_input_length, Memory_Activations);
+        BRAIN_NEW_IN(arena, _network->_layers, MLPLayer, number_of_layers, Memory_Other);
         _network->_number_of_layers = number_of_layers;
+        _network->_labels           = new_label_dictionary();
+        _network->_scales           = NULL;
+        _network->_shifts           = NULL;
+        _network->_forward_times    = NULL;
+        _network->_backward_times   = NULL;
+        _network->_counters         = NULL;
+        _network->_counts           = NULL;
+        _network->_predictions      = 0;
         /**************************************************************/
         /**                INITIALE THE RANDOM GENERATOR             **/
         /**************************************************************/
@@ -260,9 +409,12 @@ new_network(const BrainUint signal_input_length,
                 _network->_layers[index] = new_layer(number_of_neurons,
                                                      activation_functions[index],
                                                      derivative_functions[index],
+                                                     gradient_functions[index],
                                                      number_of_inputs,
                                                      in,
-                                                     previous_errors);
+                                                     previous_errors,
+                                                     dropouts[index],
+                                                     arena);
             }
 
             /**********************************************************/
@@ -270,6 +422,8 @@ new_network(const BrainUint signal_input_length,
             /**********************************************************/
             _network->_output = get_layer_output(_network->_layers[number_of_layers -1]);
         }
+
+        close_memory_arena(arena);
     }
 
     BRAIN_OUTPUT(new_network)
@@ -283,10 +437,92 @@ predict(MLPNetwork        network,
         const BrainSignal in)
 {
     BRAIN_INPUT(predict)
-    feedforward(network, number_of_input, in, BRAIN_FALSE);
+
+    if (BRAIN_ALLOCATED(in) &&
+        BRAIN_ALLOCATED(network) &&
+        (number_of_input == network->_number_of_inputs))
+    {
+        const BrainUlong span = brain_timeline_begin();
+
+        start_counters(network->_counters);
+
+        if (BRAIN_ALLOCATED(network->_scales))
+        {
+            BrainUint j = 0;
+            /**********************************************************/
+            /**      NORMALIZE THE RAW INPUT LIKE TRAINING INPUTS    **/
+            /**********************************************************/
+            for (j = 0; j < number_of_input; ++j)
+            {
+                network->_input[j] = in[j] * network->_scales[j] + network->_shifts[j];
+            }
+
+            activate_network(network, BRAIN_FALSE);
+        }
+        else
+        {
+            feedforward(network, number_of_input, in, BRAIN_FALSE);
+        }
+
+        if (BRAIN_ALLOCATED(network->_counters))
+        {
+            stop_counters(network->_counters, network->_counts);
+            ++network->_predictions;
+        }
+
+        brain_timeline_end("predict", "inference", span, -1);
+    }
+
     BRAIN_OUTPUT(predict)
 }
 
+static void
+serialize_preprocessing(const MLPNetwork network, Writer writer)
+{
+    if (BRAIN_ALLOCATED(network->_scales))
+    {
+        BrainUint j = 0;
+        BrainChar buffer[50];
+
+        for (j = 0; j < network->_number_of_inputs; ++j)
+        {
+            if (start_element(writer, "preprocessing"))
+            {
+                sprintf(buffer, "%.17g", network->_scales[j]);
+                add_attribute(writer, "scale", buffer);
+                sprintf(buffer, "%.17g", network->_shifts[j]);
+                add_attribute(writer, "shift", buffer);
+                stop_element(writer);
+            }
+        }
+    }
+}
+
+static void
+deserialize_preprocessing(MLPNetwork network, Context context)
+{
+    const BrainUint number_of_inputs = network->_number_of_inputs;
+
+    BRAIN_DELETE(network->_scales);
+    BRAIN_DELETE(network->_shifts);
+
+    if (get_number_of_node_with_name(context, "preprocessing") == number_of_inputs)
+    {
+        BrainUint j = 0;
+
+        BRAIN_NEW(network->_scales, BrainReal, number_of_inputs);
+        BRAIN_NEW(network->_shifts, BrainReal, number_of_inputs);
+
+        for (j = 0; j < number_of_inputs; ++j)
+        {
+            Context subcontext = get_node_with_name_and_index(context, "preprocessing", j);
+
+            network->_scales[j] = (BrainReal)node_get_double(subcontext, "scale", 1.0);
+            network->_shifts[j] = (BrainReal)node_get_double(subcontext, "shift", 0.0);
+        }
+    }
+}
+
 void
 deserialize_network(MLPNetwork network, BrainString filepath)
 {
@@ -311,6 +547,12 @@ deserialize_network(MLPNetwork network, BrainString filepath)
                 {
                     BrainUint i = 0;
 
+                    // restore the labels in their saved order
+                    delete_label_dictionary(network->_labels);
+                    network->_labels = new_label_dictionary();
+                    deserialize_label_dictionary(network->_labels, context);
+                    deserialize_preprocessing(network, context);
+
                     for (i = 0; i < number_of_layer; ++i)
                     {
                         Context layer_context = get_node_with_name_and_index(context, "layer", i);
@@ -351,6 +593,9 @@ serialize_network(const MLPNetwork network, BrainString filepath)
                     const BrainUint number_of_layer = network->_number_of_layers;
                     BrainUint i = 0;
 
+                    serialize_preprocessing(network, writer);
+                    serialize_label_dictionary(network->_labels, writer);
+
                     for (i = 0; i < number_of_layer;++i)
                     {
                         serialize_layer(network->_layers[i], writer);
@@ -399,6 +644,8 @@ new_network_from_context(BrainString filepath)
                 is_node_with_name(context, "network"))
             {
                 const BrainUint  number_of_inputs = node_get_int(context, "inputs", 1);
+                const BrainBool  fast_math        = node_get_bool(context, "fast-math", BRAIN_FALSE);
+                const BrainBool  use_arena        = node_get_bool(context, "arena", BRAIN_FALSE);
 
                 Context layers_context = get_node_with_name_and_index(context, "layers", 0);
 
@@ -409,29 +656,38 @@ new_network_from_context(BrainString filepath)
                     BrainChar* buffer = NULL;
                     BrainActivationFunction* activation_functions = NULL;
                     BrainActivationFunction* derivative_functions = NULL;
+                    BrainGradientFunction* gradient_functions = NULL;
+                    BrainReal* dropouts = NULL;
 
                     BRAIN_NEW(neuron_per_layers, BrainUint, number_of_layers);
+                    BRAIN_NEW(dropouts, BrainReal, number_of_layers);
                     BRAIN_NEW(activation_functions, BrainActivationFunction, number_of_layers);
                     BRAIN_NEW(derivative_functions, BrainActivationFunction, number_of_layers);
+                    BRAIN_NEW(gradient_functions, BrainGradientFunction, number_of_layers);
                     BrainUint  index = 0;
 
                     for (index = 0; index < number_of_layers; ++index)
                     {
                         Context subcontext       = get_node_with_name_and_index(layers_context, "layer", index);
                         neuron_per_layers[index] = node_get_int(subcontext, "neurons", 1);
+                        dropouts[index]          = (BrainReal)node_get_double(subcontext, "dropout", 0.5);
                         buffer                   = (BrainChar *)node_get_prop(subcontext, "activation-function");
 
                         if (BRAIN_ALLOCATED(buffer))
                         {
-                            activation_functions[index] = brain_activation_function(buffer);
+                            activation_functions[index] = fast_math ? brain_fast_activation_function(buffer)
+                                                                    : brain_activation_function(buffer);
                             derivative_functions[index] = brain_derivative_function(buffer);
+                            gradient_functions[index]   = brain_gradient_function(buffer);
 
-                            //BRAIN_DELETE(buffer)
+                            xmlFree(buffer);
                         }
                         else
                         {
-                            activation_functions[index] = brain_activation_function("Sigmoid");
+                            activation_functions[index] = fast_math ? brain_fast_activation_function("Sigmoid")
+                                                                    : brain_activation_function("Sigmoid");
                             derivative_functions[index] = brain_derivative_function("Sigmoid");
+                            gradient_functions[index]   = brain_gradient_function("Sigmoid");
                         }
                     }
 
@@ -439,11 +695,16 @@ new_network_from_context(BrainString filepath)
                                           number_of_layers,
                                           neuron_per_layers,
                                           activation_functions,
-                                          derivative_functions);
+                                          derivative_functions,
+                                          gradient_functions,
+                                          dropouts,
+                                          use_arena);
 
                     BRAIN_DELETE(neuron_per_layers);
+                    BRAIN_DELETE(dropouts);
                     BRAIN_DELETE(activation_functions);
                     BRAIN_DELETE(derivative_functions);
+                    BRAIN_DELETE(gradient_functions);
                 }
             }
 
@@ -496,3 +757,251 @@ get_network_input_signal(const MLPNetwork network)
 
     return ret;
 }
+
+void
+set_network_labels(MLPNetwork network, const BrainLabelDictionary labels)
+{
+    if (BRAIN_ALLOCATED(network)
+    &&  BRAIN_ALLOCATED(labels))
+    {
+        copy_label_dictionary(labels, network->_labels);
+    }
+}
+
+BrainUint
+get_network_number_of_label(const MLPNetwork network)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(network))
+    {
+        ret = get_label_dictionary_size(network->_labels);
+    }
+
+    return ret;
+}
+
+BrainString
+get_network_label(const MLPNetwork network, const BrainUint index)
+{
+    BrainString ret = NULL;
+
+    if (BRAIN_ALLOCATED(network))
+    {
+        ret = get_label_dictionary_label(network->_labels, index);
+    }
+
+    return ret;
+}
+
+void
+set_network_preprocessing(MLPNetwork network,
+                          const BrainSignal scales,
+                          const BrainSignal shifts)
+{
+    if (BRAIN_ALLOCATED(network))
+    {
+        const BrainUint number_of_inputs = network->_number_of_inputs;
+
+        BRAIN_DELETE(network->_scales);
+        BRAIN_DELETE(network->_shifts);
+
+        if (BRAIN_ALLOCATED(scales)
+        &&  BRAIN_ALLOCATED(shifts))
+        {
+            BRAIN_NEW(network->_scales, BrainReal, number_of_inputs);
+            BRAIN_NEW(network->_shifts, BrainReal, number_of_inputs);
+            BRAIN_COPY(scales, network->_scales, BrainReal, number_of_inputs);
+            BRAIN_COPY(shifts, network->_shifts, BrainReal, number_of_inputs);
+        }
+    }
+}
+
+BrainBool
+is_network_preprocessing(const MLPNetwork network)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(network))
+    {
+        ret = BRAIN_ALLOCATED(network->_scales);
+    }
+
+    return ret;
+}
+
+void
+fold_network_preprocessing(MLPNetwork network)
+{
+    BRAIN_INPUT(fold_network_preprocessing)
+
+    if (BRAIN_ALLOCATED(network)
+    &&  BRAIN_ALLOCATED(network->_scales)
+    &&  (0 < network->_number_of_layers))
+    {
+        fold_layer_input_model(network->_layers[0], network->_scales, network->_shifts);
+
+        BRAIN_DELETE(network->_scales);
+        BRAIN_DELETE(network->_shifts);
+    }
+
+    BRAIN_OUTPUT(fold_network_preprocessing)
+}
+
+void
+initialize_network_weights(MLPNetwork network)
+{
+    BRAIN_INPUT(initialize_network_weights)
+
+    if (BRAIN_ALLOCATED(network))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < network->_number_of_layers; ++i)
+        {
+            initialize_layer_weights(network->_layers[i]);
+        }
+    }
+
+    BRAIN_OUTPUT(initialize_network_weights)
+}
+
+void
+reset_network_optimizer(MLPNetwork network)
+{
+    BRAIN_INPUT(reset_network_optimizer)
+
+    if (BRAIN_ALLOCATED(network))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < network->_number_of_layers; ++i)
+        {
+            reset_layer_optimizer(network->_layers[i]);
+        }
+    }
+
+    BRAIN_OUTPUT(reset_network_optimizer)
+}
+
+void
+set_network_profiling(MLPNetwork network, const BrainBool profiling)
+{
+    if (BRAIN_ALLOCATED(network))
+    {
+        BRAIN_DELETE(network->_forward_times);
+        BRAIN_DELETE(network->_backward_times);
+
+        if (profiling)
+        {
+            BRAIN_NEW(network->_forward_times,  BrainDouble, network->_number_of_layers);
+            BRAIN_NEW(network->_backward_times, BrainDouble, network->_number_of_layers);
+        }
+    }
+}
+
+BrainDouble
+get_network_layer_forward_time(const MLPNetwork network, const BrainUint index)
+{
+    BrainDouble ret = 0.;
+
+    if (BRAIN_ALLOCATED(network)
+    &&  BRAIN_ALLOCATED(network->_forward_times)
+    &&  (index < network->_number_of_layers))
+    {
+        ret = network->_forward_times[index];
+    }
+
+    return ret;
+}
+
+BrainDouble
+get_network_layer_backward_time(const MLPNetwork network, const BrainUint index)
+{
+    BrainDouble ret = 0.;
+
+    if (BRAIN_ALLOCATED(network)
+    &&  BRAIN_ALLOCATED(network->_backward_times)
+    &&  (index < network->_number_of_layers))
+    {
+        ret = network->_backward_times[index];
+    }
+
+    return ret;
+}
+
+void
+set_network_counters(MLPNetwork network, const BrainBool counters)
+{
+    if (BRAIN_ALLOCATED(network))
+    {
+        delete_counters(network->_counters);
+        BRAIN_DELETE(network->_counts);
+
+        network->_counters    = NULL;
+        network->_predictions = 0;
+
+        if (counters)
+        {
+            network->_counters = new_counters();
+            BRAIN_NEW(network->_counts, BrainUlong, Counter_Last);
+        }
+    }
+}
+
+void
+fill_counter_stats(MLPCounterStats stats,
+                   const BrainCounters counters,
+                   const BrainUlong* values,
+                   const BrainUlong number_of_samples)
+{
+    if (BRAIN_ALLOCATED(stats))
+    {
+        BrainUint i = 0;
+
+        BRAIN_SET(stats, 0, CounterStats, 1);
+
+        if (BRAIN_ALLOCATED(counters)
+        &&  BRAIN_ALLOCATED(values))
+        {
+            for (i = 0; i < Counter_Last; ++i)
+            {
+                if (is_counter_available(counters, (BrainCounterType)i))
+                {
+                    stats->available |= 1 << i;
+                }
+            }
+
+            stats->cycles            = values[Counter_Cycles];
+            stats->instructions      = values[Counter_Instructions];
+            stats->l1_misses         = values[Counter_L1_Misses];
+            stats->llc_misses        = values[Counter_LLC_Misses];
+            stats->branch_misses     = values[Counter_Branch_Misses];
+            stats->number_of_samples = number_of_samples;
+
+            if (0 < stats->cycles)
+            {
+                stats->instructions_per_cycle = (BrainDouble)stats->instructions / (BrainDouble)stats->cycles;
+            }
+
+            if (0 < number_of_samples)
+            {
+                stats->l1_misses_per_sample     = (BrainDouble)stats->l1_misses     / (BrainDouble)number_of_samples;
+                stats->llc_misses_per_sample    = (BrainDouble)stats->llc_misses    / (BrainDouble)number_of_samples;
+                stats->branch_misses_per_sample = (BrainDouble)stats->branch_misses / (BrainDouble)number_of_samples;
+            }
+        }
+    }
+}
+
+void
+get_network_counters(const MLPNetwork network, MLPCounterStats stats)
+{
+    if (BRAIN_ALLOCATED(network))
+    {
+        fill_counter_stats(stats,
+                           network->_counters,
+                           network->_counts,
+                           network->_predictions);
+    }
+}
@@ -119,3 +119,53 @@ mlp_network_get_input_signal(MLPNetwork network)
 {
     return get_network_input_signal(network);
 }
+
+BrainUint __MLP_VISIBLE__
+mlp_network_get_number_of_label(MLPNetwork network)
+{
+    return get_network_number_of_label(network);
+}
+
+BrainString __MLP_VISIBLE__
+mlp_network_get_label(MLPNetwork network, BrainUint index)
+{
+    return get_network_label(network, index);
+}
+
+BrainBool __MLP_VISIBLE__
+mlp_network_is_preprocessing(MLPNetwork network)
+{
+    return is_network_preprocessing(network);
+}
+
+void __MLP_VISIBLE__
+mlp_network_fold_preprocessing(MLPNetwork network)
+{
+    fold_network_preprocessing(network);
+}
+
+void __MLP_VISIBLE__
+mlp_network_set_counters(MLPNetwork network, BrainBool counters)
+{
+    set_network_counters(network, counters);
+}
+
+void __MLP_VISIBLE__
+mlp_network_get_counters(MLPNetwork network, MLPCounterStats stats)
+{
+    if (BRAIN_ALLOCATED(network)
+    &&  BRAIN_ALLOCATED(stats))
+    {
+        get_network_counters(network, stats);
+    }
+}
+
+void __MLP_VISIBLE__
+mlp_network_get_memory_usage(MLPNetwork network, MLPMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(usage))
+    {
+        memset(usage, 0, sizeof(MemoryUsage));
+        accumulate_network_memory(network, usage);
+    }
+}
@@ -7,7 +7,6 @@
 #include "brain_memory_utils.h"
 #include "brain_signal_utils.h"
 #include "brain_function_utils.h"
-#include "brain_weight_utils.h"
 /**
  * \struct Neuron
  * \brief  Internal model for a MLPNeuron
@@ -20,11 +19,11 @@ typedef struct Neuron
     /**                      FUNCTIONAL PARAMETERS                   **/
     /******************************************************************/
     BrainActivationFunction _activation_function;   /*!< Activation function                                  */
-    BrainActivationFunction _derivative_function;   /*!< Derivative function                                  */
     /******************************************************************/
     /**                      STRUCTURAL PARAMETERS                   **/
     /******************************************************************/
-    BrainWeight*      _w;                     /*!< An array of weight                                   */
+    BrainReal*        _w;                     /*!< Weights row owned by the MLPLayer, bias last         */
+    BrainReal*        _gradients;             /*!< Gradients row owned by the MLPLayer                  */
     BrainSignal       _in;                    /*!< Input signal of an MLPNeuron                       */
     BrainSignal       _errors;                /*!< error to correct in the layer                        */
     BrainSignal       _out;                   /*!< An output value pointer owned by the MLPLayer      */
@@ -33,30 +32,9 @@ typedef struct Neuron
 } Neuron;
 
 void
-update_neuron(MLPNeuron neuron,
-              BrainReal learning_rate,
-              BrainReal momentum)
-{
-    BRAIN_INPUT(update_neuron_using_backpropagation)
-
-    if (BRAIN_ALLOCATED(neuron))
-    {
-        const BrainUint number_of_inputs  = neuron->_number_of_input;
-        BrainUint i = 0;
-        /******************************************************/
-        /**      UPDATE ALL WEIGHT USING GRADIENTS MEANS     **/
-        /******************************************************/
-        for (i = 0; i < number_of_inputs + 1; ++i)
-        {
-            update_weight(neuron->_w[i], learning_rate, momentum);
-        }
-    }
-
-    BRAIN_OUTPUT(update_neuron_using_backpropagation)
-}
-
-void
-activate_neuron(MLPNeuron neuron, const BrainBool is_activated)
+activate_neuron(MLPNeuron neuron,
+                const BrainUint* inputs,
+                const BrainUint  number_of_inputs)
 {
     BRAIN_INPUT(activate_neuron)
 
@@ -70,22 +48,27 @@ activate_neuron(MLPNeuron neuron, const BrainBool is_activated)
         /**************************************************************/
         /**                 COMPUTE A(<in, W>)                       **/
         /**************************************************************/
-        if ((activation_function != NULL)
-        &&  is_activated)
+        if (activation_function != NULL)
         {
+            const BrainReal* w = neuron->_w;
             BrainUint i = 0;
-            BrainReal w = 0.;
 
-#if defined(__GNUC__)
-            #pragma GCC ivdep
-#endif
-            for (i = 0; i < neuron->_number_of_input; ++i)
+            if (BRAIN_ALLOCATED(inputs))
             {
-                w = get_weight(neuron->_w[i]);
-                neuron->_sum += w * neuron->_in[i];
+                // dropped inputs are null, only gather the others
+                for (i = 0; i < number_of_inputs; ++i)
+                {
+                    const BrainUint j = inputs[i];
+
+                    neuron->_sum += w[j] * neuron->_in[j];
+                }
             }
-            w = get_weight(neuron->_w[i]);
-            neuron->_sum += w * 1.0;
+            else
+            {
+                neuron->_sum = dot(w, neuron->_in, neuron->_number_of_input);
+            }
+
+            neuron->_sum += w[neuron->_number_of_input] * 1.0;
 
             *(neuron->_out) = activation_function(neuron->_sum);
         }
@@ -101,51 +84,57 @@ delete_neuron(MLPNeuron neuron)
 
     if (BRAIN_ALLOCATED(neuron))
     {
-        BrainUint i = 0;
-        for (i = 0; i < neuron->_number_of_input + 1; ++i)
-        {
-            BRAIN_DELETE(neuron->_w[i]);
-        }
-        BRAIN_DELETE(neuron->_w);
+        // weights and gradients belong to the layer
         BRAIN_DELETE(neuron);
     }
 
     BRAIN_OUTPUT(delete_neuron)
 }
 
+void
+accumulate_neuron_memory(const MLPNeuron neuron, MLPMemoryUsage usage)
+{
+    // weights and gradients belong to the layer
+    accumulate_memory_usage(usage, neuron);
+}
+
+size_t
+get_neuron_memory_footprint()
+{
+    return get_memory_arena_footprint(1, sizeof(Neuron), Memory_Other);
+}
+
 MLPNeuron
 new_neuron(BrainActivationFunction activation_function,
-           BrainActivationFunction derivative_function,
            BrainSignal     in,
            const BrainUint number_of_inputs,
            BrainSignal     out,
-           BrainSignal     errors)
+           BrainSignal     errors,
+           BrainReal*      weights,
+           BrainReal*      gradients,
+           BrainMemoryArena arena)
 {
     BRAIN_INPUT(new_neuron)
     MLPNeuron _neuron = NULL;
 
     if (BRAIN_ALLOCATED(out)
+    &&  BRAIN_ALLOCATED(weights)
+    &&  BRAIN_ALLOCATED(gradients)
     &&  (0 < number_of_inputs))
     {
-        BrainUint                index   = 0;
-        BrainReal random_value_limit     = 1./sqrt((BrainReal)number_of_inputs);
+        BRAIN_NEW_IN(arena, _neuron, Neuron, 1, Memory_Other);
 
-        BRAIN_NEW(_neuron,                  Neuron,    1);
         // Note: You should not forget the bias associated to a dummy 1 input
-        BRAIN_NEW(_neuron->_w,              BrainWeight, number_of_inputs + 1);
-
+        _neuron->_w                      = weights;
+        _neuron->_gradients              = gradients;
         _neuron->_out                    = out;
         _neuron->_number_of_input        = number_of_inputs;
         _neuron->_in                     = in;
         _neuron->_sum                    = 0.;
         _neuron->_activation_function    = activation_function;
-        _neuron->_derivative_function    = derivative_function;
         _neuron->_errors                 = errors;
 
-        for (index = 0; index < _neuron->_number_of_input + 1; ++index)
-        {
-            _neuron->_w[index] = new_weight(random_value_limit);
-        }
+        initialize_neuron_weights(_neuron);
     }
 
     BRAIN_OUTPUT(new_neuron)
@@ -165,6 +154,19 @@ get_neuron_number_of_input(const MLPNeuron neuron)
     return ret;
 }
 
+BrainReal
+get_neuron_sum(const MLPNeuron neuron)
+{
+    BrainReal ret = 0.0;
+
+    if (BRAIN_ALLOCATED(neuron))
+    {
+        ret = neuron->_sum;
+    }
+
+    return ret;
+}
+
 BrainReal
 get_neuron_weight(const MLPNeuron neuron, const BrainUint index)
 {
@@ -173,7 +175,7 @@ get_neuron_weight(const MLPNeuron neuron, const BrainUint index)
     if (BRAIN_ALLOCATED(neuron) &&
         (index < neuron->_number_of_input))
     {
-        ret = get_weight(neuron->_w[index]);
+        ret = neuron->_w[index];
     }
 
     return ret;
@@ -195,11 +197,11 @@ deserialize_neuron(MLPNeuron neuron, Context context)
         {
             Context subcontext = get_node_with_name_and_index(context, "weight", index);
             value = (BrainReal)node_get_content_as_double(subcontext);
-            set_weight(neuron->_w[index], value);
+            neuron->_w[index] = value;
         }
 
         value = (BrainReal)node_get_double(context, "bias", 0.0);
-        set_weight(neuron->_w[neuron->_number_of_input], value);
+        neuron->_w[neuron->_number_of_input] = value;
     }
 
     BRAIN_OUTPUT(deserialize_neuron)
@@ -223,7 +225,7 @@ serialize_neuron(MLPNeuron neuron, Writer writer)
                 BrainChar buffer[50];
                 BrainReal w = 0.;
 
-                w = get_weight(neuron->_w[number_of_inputs]);
+                w = neuron->_w[number_of_inputs];
                 sprintf(buffer, "%lf", w);
                 add_attribute(writer, "bias", buffer);
 
@@ -231,7 +233,7 @@ serialize_neuron(MLPNeuron neuron, Writer writer)
                      index_input < number_of_inputs;
                      ++index_input)
                 {
-                    w = get_weight(neuron->_w[index_input]);
+                    w = neuron->_w[index_input];
                     sprintf(buffer, "%lf", w);
                     write_element(writer, "weight", buffer);
                 }
@@ -245,38 +247,118 @@ serialize_neuron(MLPNeuron neuron, Writer writer)
 }
 
 void
-backpropagate_neuron_gradient(MLPNeuron neuron, const BrainReal loss)
+backpropagate_neuron_gradient(MLPNeuron neuron,
+                              const BrainReal  neuron_gradient,
+                              const BrainUint* inputs,
+                              const BrainUint  number_of_inputs)
 {
     BRAIN_INPUT(backpropagate_neuron_gradient)
 
     if (BRAIN_ALLOCATED(neuron))
     {
-        const BrainUint number_of_inputs            = neuron->_number_of_input;
-        BrainActivationFunction derivative_function = neuron->_derivative_function;
+        const BrainReal* w = neuron->_w;
+        BrainReal* gradients = neuron->_gradients;
+        BrainSignal errors = neuron->_errors;
+        BrainUint i = 0;
 
-        if (BRAIN_ALLOCATED(derivative_function))
+        /******************************************************/
+        /**               BACKPROPAGATE $_i                  **/
+        /**                                                  **/
+        /** A dropped input has no gradient and its error is **/
+        /** never read, so only the kept ones are visited    **/
+        /******************************************************/
+        if (BRAIN_ALLOCATED(inputs))
         {
-            const BrainReal neuron_gradient   = loss * derivative_function(neuron->_sum);
-            BrainUint i = 0;
-
-            /******************************************************/
-            /**               BACKPROPAGATE $_i                  **/
-            /******************************************************/
             for (i = 0; i < number_of_inputs; ++i)
             {
-                if (BRAIN_ALLOCATED(neuron->_errors))
+                const BrainUint j = inputs[i];
+
+                if (BRAIN_ALLOCATED(errors))
                 {
-                    BrainReal w = get_weight(neuron->_w[i]);
-                    neuron->_errors[i] += neuron_gradient * w;
+                    errors[j] += neuron_gradient * w[j];
                 }
 
-                accumulate_gradient(neuron->_w[i], neuron_gradient, neuron->_in[i]);
+                gradients[j] += neuron_gradient * neuron->_in[j];
+            }
+        }
+        else
+        {
+            if (BRAIN_ALLOCATED(errors))
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < neuron->_number_of_input; ++i)
+                {
+                    errors[i] += neuron_gradient * w[i];
+                }
             }
 
-            // Bias is modelized with a dummy 1 input
-            accumulate_gradient(neuron->_w[i], neuron_gradient, 1.);
+#if defined(__GNUC__)
+            #pragma GCC ivdep
+#endif
+            for (i = 0; i < neuron->_number_of_input; ++i)
+            {
+                gradients[i] += neuron_gradient * neuron->_in[i];
+            }
         }
+
+        // Bias is modelized with a dummy 1 input
+        gradients[neuron->_number_of_input] += neuron_gradient * 1.;
     }
 
     BRAIN_OUTPUT(backpropagate_neuron_gradient)
 }
+
+void
+fold_neuron_input_model(MLPNeuron neuron,
+                        const BrainSignal scales,
+                        const BrainSignal shifts)
+{
+    BRAIN_INPUT(fold_neuron_input_model)
+
+    if (BRAIN_ALLOCATED(neuron)
+    &&  BRAIN_ALLOCATED(scales)
+    &&  BRAIN_ALLOCATED(shifts))
+    {
+        const BrainUint number_of_inputs = neuron->_number_of_input;
+        BrainReal bias = neuron->_w[number_of_inputs];
+        BrainUint i = 0;
+
+        /**************************************************************/
+        /**  <w, x * scale + shift> + b                              **/
+        /**        = <w * scale, x> + (b + <w, shift>)               **/
+        /**************************************************************/
+        for (i = 0; i < number_of_inputs; ++i)
+        {
+            const BrainReal w = neuron->_w[i];
+
+            bias += w * shifts[i];
+            neuron->_w[i] = w * scales[i];
+        }
+
+        neuron->_w[number_of_inputs] = bias;
+    }
+
+    BRAIN_OUTPUT(fold_neuron_input_model)
+}
+
+void
+initialize_neuron_weights(MLPNeuron neuron)
+{
+    BRAIN_INPUT(initialize_neuron_weights)
+
+    if (BRAIN_ALLOCATED(neuron))
+    {
+        const BrainReal random_value_limit = 1./sqrt((BrainReal)neuron->_number_of_input);
+
+        fill_random_uniform(get_thread_random(),
+                            neuron->_w,
+                            neuron->_number_of_input + 1,
+                            -random_value_limit,
+                            random_value_limit);
+        BRAIN_SET(neuron->_gradients, 0, BrainReal, neuron->_number_of_input + 1);
+    }
+
+    BRAIN_OUTPUT(initialize_neuron_weights)
+}
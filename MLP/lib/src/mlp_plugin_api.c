@@ -7,6 +7,7 @@
 #include "brain_data_utils.h"
 #include "brain_memory_utils.h"
 #include "brain_logging_utils.h"
+#include "brain_timeline_utils.h"
 
 #include "mlp_config.h"
 
@@ -22,9 +23,39 @@ mlp_plugin_init()
     brain_logging_init();
 }
 
+BrainBool __MLP_VISIBLE__
+mlp_plugin_set_allocator(MLPAllocator allocator)
+{
+    return brain_memory_set_allocator(allocator);
+}
+
 MLPMetaData __MLP_VISIBLE__
 mlp_plugin_metadata()
 {
     return &mlpInfos;
 }
 
+BrainBool __MLP_VISIBLE__
+mlp_plugin_start_timeline(BrainString path)
+{
+    return brain_timeline_start(path);
+}
+
+void __MLP_VISIBLE__
+mlp_plugin_stop_timeline()
+{
+    brain_timeline_stop();
+}
+
+BrainBool __MLP_VISIBLE__
+mlp_plugin_track_xml_memory()
+{
+    return brain_memory_track_xml();
+}
+
+void __MLP_VISIBLE__
+mlp_plugin_get_memory_stats(MLPMemoryStats stats)
+{
+    get_memory_stats(stats);
+}
+
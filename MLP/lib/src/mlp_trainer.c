@@ -5,6 +5,7 @@
 #include "mlp_config.h"
 
 #include "brain_data_utils.h"
+#include "brain_loader_utils.h"
 #include "brain_random_utils.h"
 #include "brain_function_utils.h"
 #include "brain_xml_utils.h"
@@ -12,24 +13,51 @@
 #include "brain_probe.h"
 #include "brain_math_utils.h"
 #include "brain_memory_utils.h"
+#include "brain_weight_utils.h"
+#include "brain_counter_utils.h"
+#include "brain_timeline_utils.h"
+
+/**
+ * \enum TrainerRegion
+ * \brief regions measured by the hardware counters
+ */
+typedef enum TrainerRegion
+{
+    Region_Forward,
+    Region_Backward,
+    Region_Update,
+    Region_Evaluation,
+    Region_Last
+} TrainerRegion;
 
 typedef struct Trainer
 {
     MLPNetwork        _network;
     MLPData           _data;
     BrainSignal       _target;
+    BrainBatchLoader  _loader;                      /*!< Minibatch prefetching thread   */
     /*********************************************************************/
     /**                      TRAINING PARAMETERS                        **/
     /*********************************************************************/
     BrainReal         _max_error;                   /*!< Maximum error threshold        */
     BrainUint         _max_iter;                    /*!< Maximum iteration              */
     BrainUint         _minibatch_size;              /*!< Minibatch size                 */
-    BrainReal         _learning_rate;               /*!< BackProp learning rate         */
-    BrainReal         _momemtum;                    /*!< BackProp momentum value        */
+    BrainOptimizer    _optimizer;                   /*!< Weights update rule            */
     BrainReal         _error;                       /*!< Current training error level   */
     BrainUint         _iterations;                  /*!< Current training iterrations   */
+    BrainBool         _restored;                    /*!< Weights or fold set by the user */
+    BrainUint         _prefetch;                    /*!< Number of prefetched minibatch */
     BrainCostFunction _cost_function;               /*!< Cost function                  */
     BrainCostFunction _cost_function_derivative;    /*!< Cost function derivative       */
+    /*********************************************************************/
+    /**                          STATISTICS                             **/
+    /*********************************************************************/
+    BrainBool         _profiling;                   /*!< Time each sample phase         */
+    TrainerStats      _stats;                       /*!< Times since the configuration  */
+    BrainCounters     _counters;                    /*!< Hardware counters, NULL if off */
+    BrainUlong*       _counts;                      /*!< Counter_Last counts per region */
+    BrainUlong        _evaluations;                 /*!< Number of evaluated samples    */
+    BrainBool         _timeline;                    /*!< Recording the timeline         */
 } Trainer;
 
 MLPTrainer
@@ -43,17 +71,32 @@ new_trainer(MLPNetwork network, MLPData data)
     trainer->_data             = data;
 
     const BrainUint output_length = get_output_signal_length(data);
-    BRAIN_NEW(trainer->_target, BrainReal, output_length);
+    BRAIN_NEW_TAG(trainer->_target, BrainReal, output_length, Memory_Activations);
+
+    // the trained network keeps the meaning of its outputs
+    // and the normalization of its inputs
+    set_network_labels(network, get_data_labels(data));
+    set_network_preprocessing(network,
+                              get_data_preprocessing_scales(data),
+                              get_data_preprocessing_shifts(data));
 
     trainer->_max_iter         = 1000;
     trainer->_max_error        = 0.0001;
     trainer->_error            = trainer->_max_error + 1.;
     trainer->_iterations       = 0;
+    trainer->_restored         = BRAIN_FALSE;
     trainer->_minibatch_size   = 32;
-    trainer->_learning_rate    = 1.12;
-    trainer->_momemtum         = 0.0;
+    trainer->_optimizer        = new_optimizer("Momentum");
+    trainer->_prefetch         = 0;
+    trainer->_loader           = NULL;
     trainer->_cost_function    = brain_cost_function("Quadratic");
     trainer->_cost_function_derivative = brain_derivative_cost_function("Quadratic");
+    trainer->_profiling        = BRAIN_FALSE;
+    trainer->_counters         = NULL;
+    trainer->_counts           = NULL;
+    trainer->_timeline         = BRAIN_FALSE;
+
+    configure_optimizer(trainer->_optimizer, 1.12, 0.0, 0.9, 0.999, 1e-8);
 
     return trainer;
 }
@@ -63,8 +106,18 @@ delete_trainer(MLPTrainer trainer)
 {
     if (BRAIN_ALLOCATED(trainer))
     {
+        // the loader thread reads the data so stop it first
+        delete_batch_loader(trainer->_loader);
         delete_data(trainer->_data);
         delete_network(trainer->_network);
+        delete_optimizer(trainer->_optimizer);
+        delete_counters(trainer->_counters);
+        BRAIN_DELETE(trainer->_counts);
+
+        if (trainer->_timeline)
+        {
+            brain_timeline_stop();
+        }
 
         if (BRAIN_ALLOCATED(trainer->_target))
         {
@@ -74,6 +127,49 @@ delete_trainer(MLPTrainer trainer)
     }
 }
 
+void
+accumulate_trainer_memory(const MLPTrainer trainer, MLPMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        accumulate_batch_loader_memory(trainer->_loader, usage);
+        accumulate_data_memory(trainer->_data, usage);
+        accumulate_network_memory(trainer->_network, usage);
+        accumulate_memory_usage(usage, trainer->_optimizer);
+        accumulate_memory_usage(usage, trainer->_counters);
+        accumulate_memory_usage(usage, trainer->_counts);
+        accumulate_memory_usage(usage, trainer->_target);
+        accumulate_memory_usage(usage, trainer);
+    }
+}
+
+static void
+seed_trainer(MLPTrainer trainer, const BrainUlong seed)
+{
+    MLPData data = trainer->_data;
+    /******************************************************************/
+    /**   The network and the data have been built before reading    **/
+    /**   the settings: draw the weights and the split again so      **/
+    /**   that a seed always gives the same run, unless they have    **/
+    /**   been restored, selected or trained since.                  **/
+    /**                                                              **/
+    /**   Threads get their random streams in the order they draw    **/
+    /**   after the seed: the loader must be stopped before.         **/
+    /******************************************************************/
+    set_random_seed(seed);
+
+    if (!trainer->_restored
+    &&  (trainer->_iterations == 0))
+    {
+        initialize_network_weights(trainer->_network);
+
+        if (!is_data_streamed(data))
+        {
+            split_trainer_data(trainer, get_data_training_ratio(data));
+        }
+    }
+}
+
 void
 configure_trainer_with_context(MLPTrainer trainer, BrainString filepath)
 {
@@ -83,7 +179,19 @@ configure_trainer_with_context(MLPTrainer trainer, BrainString filepath)
         BRAIN_ALLOCATED(filepath) &&
         validate_with_xsd(filepath, SETTINGS_XSD_FILE))
     {
-        Document settings_document = open_document(filepath);
+        Document  settings_document = NULL;
+        BrainBool counters          = BRAIN_FALSE;
+        BrainChar* timeline         = NULL;
+
+        /******************************************************************/
+        /**  The loader thread draws samples from the data and from the  **/
+        /**  random generator: stop it before any setting touches them,  **/
+        /**  the minibatch geometry may change too                       **/
+        /******************************************************************/
+        delete_batch_loader(trainer->_loader);
+        trainer->_loader = NULL;
+
+        settings_document = open_document(filepath);
 
         if (BRAIN_ALLOCATED(settings_document))
         {
@@ -92,24 +200,107 @@ configure_trainer_with_context(MLPTrainer trainer, BrainString filepath)
             if (BRAIN_ALLOCATED(backpropagation_context) &&
                 is_node_with_name(backpropagation_context, "backpropagation"))
             {
+                BrainOptimizer optimizer            = NULL;
                 BrainChar* buffer                   = (BrainChar *)node_get_prop(backpropagation_context, "cost-function");
                 trainer->_cost_function             = brain_cost_function(buffer);
                 trainer->_cost_function_derivative  = brain_derivative_cost_function(buffer);
+                xmlFree(buffer);
                 trainer->_max_iter                  = node_get_int(backpropagation_context, "iterations", 1000);
                 trainer->_max_error                 = (BrainReal)node_get_double(backpropagation_context, "error", 0.001);
                 trainer->_minibatch_size            = node_get_int(backpropagation_context, "mini-batch-size", 32);
-                trainer->_learning_rate             = (BrainReal)node_get_double(backpropagation_context, "learning-rate", 0.005);
-                trainer->_momemtum                  = (BrainReal)node_get_double(backpropagation_context, "momentum", 0.001);
+                trainer->_prefetch                  = node_get_int(backpropagation_context, "prefetch", 0);
                 trainer->_error                     = trainer->_max_error + 1.;
+                trainer->_profiling                 = node_get_bool(backpropagation_context, "profiling", BRAIN_FALSE);
+                counters                            = node_get_bool(backpropagation_context, "hardware-counters", BRAIN_FALSE);
+                timeline                            = (BrainChar *)node_get_prop(backpropagation_context, "timeline");
+
+                buffer = (BrainChar *)node_get_prop(backpropagation_context, "optimizer");
+                optimizer = new_optimizer(BRAIN_ALLOCATED(buffer) ? buffer : "Momentum");
+                if (BRAIN_ALLOCATED(buffer))
+                {
+                    xmlFree(buffer);
+                }
+
+                if (BRAIN_ALLOCATED(optimizer))
+                {
+                    configure_optimizer(optimizer,
+                                        (BrainReal)node_get_double(backpropagation_context, "learning-rate", 0.005),
+                                        (BrainReal)node_get_double(backpropagation_context, "momentum",      0.001),
+                                        (BrainReal)node_get_double(backpropagation_context, "beta1",         0.9),
+                                        (BrainReal)node_get_double(backpropagation_context, "beta2",         0.999),
+                                        (BrainReal)node_get_double(backpropagation_context, "epsilon",       1e-8));
+                    regularize_optimizer(optimizer,
+                                         (BrainReal)node_get_double(backpropagation_context, "weight-decay", 0.),
+                                         (BrainReal)node_get_double(backpropagation_context, "clipping",     0.));
+                    // states of the former optimizer do not fit the new one
+                    delete_optimizer(trainer->_optimizer);
+                    trainer->_optimizer = optimizer;
+                    reset_network_optimizer(trainer->_network);
+                }
+
+                buffer = (BrainChar *)node_get_prop(backpropagation_context, "sampling");
+                if (BRAIN_ALLOCATED(buffer))
+                {
+                    set_data_sampling(trainer->_data, buffer, node_get_int(backpropagation_context, "block-size", 0));
+                    xmlFree(buffer);
+                }
+
+                buffer = (BrainChar *)node_get_prop(backpropagation_context, "seed");
+                if (BRAIN_ALLOCATED(buffer))
+                {
+                    seed_trainer(trainer, strtoull(buffer, NULL, 10));
+                    xmlFree(buffer);
+                }
             }
 
             close_document(settings_document);
         }
+
+        BRAIN_SET(&(trainer->_stats), 0, TrainerStats, 1);
+        set_network_profiling(trainer->_network, trainer->_profiling);
+
+        delete_counters(trainer->_counters);
+        BRAIN_DELETE(trainer->_counts);
+
+        trainer->_counters    = NULL;
+        trainer->_evaluations = 0;
+
+        if (counters)
+        {
+            trainer->_counters = new_counters();
+            BRAIN_NEW(trainer->_counts, BrainUlong, Region_Last * Counter_Last);
+        }
+
+        if (trainer->_timeline)
+        {
+            brain_timeline_stop();
+        }
+
+        trainer->_timeline = BRAIN_FALSE;
+
+        if (BRAIN_ALLOCATED(timeline))
+        {
+            trainer->_timeline = brain_timeline_start(timeline);
+            xmlFree(timeline);
+        }
     }
 
     BRAIN_OUTPUT(configure_trainer_with_context)
 }
 
+static BrainUlong*
+get_trainer_counts(const MLPTrainer trainer, const TrainerRegion region)
+{
+    BrainUlong* ret = NULL;
+
+    if (BRAIN_ALLOCATED(trainer->_counts))
+    {
+        ret = trainer->_counts + region * Counter_Last;
+    }
+
+    return ret;
+}
+
 static BrainReal
 compute_error(const MLPTrainer trainer, const BrainUint index)
 {
@@ -133,8 +324,9 @@ compute_error(const MLPTrainer trainer, const BrainUint index)
         BrainSignal output = NULL;
         BrainUint j = 0;
 
-        // only propagate the signal threw all layers
-        predict(network, input_length, input);
+        // only propagate the signal threw all layers, evaluating
+        // signals are already normalized
+        feedforward(network, input_length, input, BRAIN_FALSE);
 
         // grab the network output and compute the error
         // between the target and the real output
@@ -166,15 +358,30 @@ compute_total_error(MLPTrainer trainer)
         MLPData  data    = trainer->_data;
 
         const BrainUint number_of_evaluating_sample = get_number_of_evaluating_sample(data);
+        const BrainDouble time = brain_probe_now();
         BrainUint i = 0;
 
-        trainer->_error = 0.;
-        for (i = 0; i < number_of_evaluating_sample; ++i)
+        if (0 < number_of_evaluating_sample)
         {
-            trainer->_error += compute_error(trainer, i);
+            const BrainUlong span = brain_timeline_begin();
+
+            start_counters(trainer->_counters);
+
+            trainer->_error = 0.;
+            for (i = 0; i < number_of_evaluating_sample; ++i)
+            {
+                trainer->_error += compute_error(trainer, i);
+            }
+
+            trainer->_error /= (BrainReal)(number_of_evaluating_sample);
+
+            stop_counters(trainer->_counters, get_trainer_counts(trainer, Region_Evaluation));
+            trainer->_evaluations += number_of_evaluating_sample;
+
+            brain_timeline_end("evaluation", "train", span, -1);
         }
 
-        trainer->_error /= (BrainReal)(number_of_evaluating_sample);
+        trainer->_stats.evaluation += brain_probe_now() - time;
     }
 
     BRAIN_OUTPUT(compute_total_error);
@@ -215,6 +422,106 @@ get_training_progress(MLPTrainer trainer)
     return ret;
 }
 
+BrainUint
+get_training_epoch(const MLPTrainer trainer)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        ret = get_data_epoch(trainer->_data);
+    }
+
+    return ret;
+}
+
+static void
+train_sample(MLPTrainer trainer,
+             const BrainSignal input,
+             const BrainSignal target,
+             BrainSignal loss)
+{
+    MLPNetwork network = trainer->_network;
+    MLPData  data    = trainer->_data;
+
+    const BrainUint input_length  = get_input_signal_length(data);
+    const BrainUint output_length = get_output_signal_length(data);
+    const BrainCostFunction cost_function_derivative = trainer->_cost_function_derivative;
+
+    BrainSignal output = NULL;
+    BrainDouble time   = 0.;
+    BrainUint   i = 0;
+
+    if (trainer->_profiling)
+    {
+        time = brain_probe_now();
+    }
+
+    start_counters(trainer->_counters);
+
+    /**************************************************/
+    /**       FORWARD PROPAGATION OF THE SIGNAL      **/
+    /**************************************************/
+    feedforward(network, input_length, input, BRAIN_TRUE);
+
+    /**************************************************/
+    /**     BACKPROPAGATION USING THE TARGET SIGNAL  **/
+    /**************************************************/
+    output = get_network_output(network);
+
+    /**************************************************************/
+    /**               COMPUTE OUTPUT ERROR DERIVATIVE            **/
+    /**************************************************************/
+    for (i = 0; i < output_length; ++i)
+    {
+        loss[i] = cost_function_derivative(output[i], target[i]);
+    }
+
+    stop_counters(trainer->_counters, get_trainer_counts(trainer, Region_Forward));
+
+    if (trainer->_profiling)
+    {
+        const BrainDouble now = brain_probe_now();
+
+        trainer->_stats.forward += now - time;
+        time = now;
+    }
+
+    start_counters(trainer->_counters);
+
+    backpropagate(network, output_length, loss);
+
+    stop_counters(trainer->_counters, get_trainer_counts(trainer, Region_Backward));
+
+    if (trainer->_profiling)
+    {
+        trainer->_stats.backward += brain_probe_now() - time;
+    }
+
+    ++trainer->_stats.number_of_samples;
+}
+
+static BrainBool
+sample_trainer(MLPTrainer trainer, BrainSignal* input, BrainSignal* target)
+{
+    BrainBool   ret  = BRAIN_FALSE;
+    BrainDouble time = 0.;
+
+    if (trainer->_profiling)
+    {
+        time = brain_probe_now();
+    }
+
+    ret = get_next_training_sample(trainer->_data, input, target);
+
+    if (trainer->_profiling)
+    {
+        trainer->_stats.sampling += brain_probe_now() - time;
+    }
+
+    return ret;
+}
+
 void
 step(MLPTrainer trainer)
 {
@@ -229,60 +536,112 @@ step(MLPTrainer trainer)
 
         const BrainUint input_length  = get_input_signal_length(data);
         const BrainUint output_length = get_output_signal_length(data);
-        const BrainUint number_of_training_sample = get_number_of_training_sample(data);
-        const BrainCostFunction cost_function_derivative = trainer->_cost_function_derivative;
 
         BrainSignal input  = NULL;
-        BrainSignal output = NULL;
         BrainSignal target = NULL;
         BrainSignal loss   = NULL;
-        BrainUint   i = 0;
         BrainUint   minibatch_size = 0;
+        BrainDouble time = brain_probe_now();
+        BrainUlong  step_span = brain_timeline_begin();
+        BrainUlong  span = 0;
 
-        BRAIN_NEW(loss, BrainReal, output_length);
-        /******************************************************/
-        /**         ACCUMULATE WITH RANDOM MINI-BATCH        **/
-        /******************************************************/
-        do
-        {
-            const BrainUint index = (BrainUint)BRAIN_RAND_RANGE(0, number_of_training_sample-1);
+        BRAIN_NEW_TAG(loss, BrainReal, output_length, Memory_Activations);
 
-            input  = get_training_input_signal(data, index);
-            target = get_training_output_signal(data, index);
-            BRAIN_COPY(target, trainer->_target, BrainReal, output_length);
+        if (0 < trainer->_prefetch)
+        {
+            BrainSignal inputs  = NULL;
+            BrainSignal targets = NULL;
+            BrainUint   number_of_samples = 0;
 
+            if (!BRAIN_ALLOCATED(trainer->_loader))
+            {
+                trainer->_loader = new_batch_loader(data,
+                                                    trainer->_minibatch_size,
+                                                    trainer->_prefetch);
+            }
             /**************************************************/
-            /**       FORWARD PROPAGATION OF THE SIGNAL      **/
+            /**      CONSUME A MINI-BATCH PREFETCHED BY      **/
+            /**              THE LOADER THREAD               **/
             /**************************************************/
-            feedforward(network, input_length, input, BRAIN_TRUE);
+            span = brain_timeline_begin();
+            number_of_samples = batch_loader_acquire(trainer->_loader, &inputs, &targets);
+            brain_timeline_end("wait", "io", span, -1);
 
-            /**************************************************/
-            /**     BACKPROPAGATION USING THE TARGET SIGNAL  **/
-            /**************************************************/
-            output = get_network_output(network);
+            if (trainer->_profiling)
+            {
+                trainer->_stats.sampling += brain_probe_now() - time;
+            }
+
+            span = brain_timeline_begin();
+
+            for (minibatch_size = 0; minibatch_size < number_of_samples; ++minibatch_size)
+            {
+                input  = inputs  + minibatch_size * input_length;
+                target = targets + minibatch_size * output_length;
+
+                train_sample(trainer, input, target, loss);
+            }
+
+            brain_timeline_end("minibatch", "train", span, -1);
+
+            if (0 < number_of_samples)
+            {
+                BRAIN_COPY(target, trainer->_target, BrainReal, output_length);
+            }
 
-            /**************************************************************/
-            /**               COMPUTE OUTPUT ERROR DERIVATIVE            **/
-            /**************************************************************/
-            for (i = 0; i < output_length; ++i)
+            batch_loader_release(trainer->_loader);
+        }
+        else
+        {
+            /******************************************************/
+            /**    ACCUMULATE WITH THE NEXT SAMPLES OF THE EPOCH  **/
+            /******************************************************/
+            span = brain_timeline_begin();
+
+            while ((minibatch_size < trainer->_minibatch_size)
+            &&     sample_trainer(trainer, &input, &target))
             {
-                loss[i] = cost_function_derivative(output[i], target[i]);
+                train_sample(trainer, input, target, loss);
+
+                ++minibatch_size;
             }
 
-            backpropagate(network, output_length, loss);
+            brain_timeline_end("minibatch", "train", span, -1);
 
-            ++minibatch_size;
-        } while (minibatch_size < trainer->_minibatch_size);
+            if (0 < minibatch_size)
+            {
+                BRAIN_COPY(target, trainer->_target, BrainReal, output_length);
+            }
+        }
         /**************************************************/
         /**             UPDATE NETWORK WEIGHTS           **/
         /**************************************************/
-        update_network(network, trainer->_learning_rate / (BrainReal)trainer->_minibatch_size, trainer->_momemtum);
+        if (0 < minibatch_size)
+        {
+            const BrainDouble update_time = brain_probe_now();
+
+            span = brain_timeline_begin();
+            start_counters(trainer->_counters);
+
+            step_optimizer(trainer->_optimizer, minibatch_size);
+            update_network(network, trainer->_optimizer);
+
+            stop_counters(trainer->_counters, get_trainer_counts(trainer, Region_Update));
+            brain_timeline_end("update", "train", span, -1);
+
+            trainer->_stats.update += brain_probe_now() - update_time;
+        }
+
+        trainer->_stats.training += brain_probe_now() - time;
+        ++trainer->_stats.number_of_steps;
 
         /**************************************************/
         /**                 UPDATE ERROR LEVEL           **/
         /**************************************************/
         compute_total_error(trainer);
 
+        brain_timeline_end("step", "train", step_span, (BrainInt)trainer->_iterations);
+
         /**************************************************/
         /**            INCREASE NUMBER OF EPOCH          **/
         /**************************************************/
@@ -315,7 +674,13 @@ save_trainer_progression(MLPTrainer trainer, BrainString path)
 {
     if (BRAIN_ALLOCATED(trainer) && BRAIN_ALLOCATED(path) && BRAIN_ALLOCATED(trainer->_network))
     {
+        const BrainDouble time = brain_probe_now();
+        const BrainUlong  span = brain_timeline_begin();
+
         serialize_network(trainer->_network, path);
+
+        brain_timeline_end("checkpoint", "io", span, -1);
+        trainer->_stats.serialization += brain_probe_now() - time;
     }
 }
 
@@ -333,7 +698,14 @@ restore_trainer_progression(MLPTrainer trainer,
         if (BRAIN_ALLOCATED(trainer->_network) &&
             BRAIN_ALLOCATED(serialized_network))
         {
+            const BrainDouble time = brain_probe_now();
+            const BrainUlong  span = brain_timeline_begin();
+
             deserialize_network(trainer->_network, serialized_network);
+            trainer->_restored = BRAIN_TRUE;
+
+            brain_timeline_end("restore", "io", span, -1);
+            trainer->_stats.serialization += brain_probe_now() - time;
         }
     }
 }
@@ -355,4 +727,94 @@ BrainSignal
 get_trainer_target_signal(MLPTrainer trainer)
 {
     return trainer->_target;
-}
\ No newline at end of file
+}
+
+void
+split_trainer_data(MLPTrainer trainer, const BrainReal training_ratio)
+{
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        // the loader thread reads the training view
+        delete_batch_loader(trainer->_loader);
+        trainer->_loader = NULL;
+
+        split_data(trainer->_data, training_ratio);
+        // the preprocessing has been fitted on the new training signals
+        set_network_preprocessing(trainer->_network,
+                                  get_data_preprocessing_scales(trainer->_data),
+                                  get_data_preprocessing_shifts(trainer->_data));
+        compute_total_error(trainer);
+    }
+}
+
+void
+select_trainer_fold(MLPTrainer trainer, const BrainUint number_of_folds, const BrainUint fold)
+{
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        // the loader thread reads the training view
+        delete_batch_loader(trainer->_loader);
+        trainer->_loader = NULL;
+
+        if (select_data_fold(trainer->_data, number_of_folds, fold))
+        {
+            trainer->_restored = BRAIN_TRUE;
+            /**********************************************************/
+            /**  Each fold is a new training: draw the weights again **/
+            /**  from the random generator and forget the progress   **/
+            /**  and the optimizer states of the former fold         **/
+            /**********************************************************/
+            initialize_network_weights(trainer->_network);
+            reset_network_optimizer(trainer->_network);
+            trainer->_iterations = 0;
+            trainer->_error      = trainer->_max_error + 1.;
+            // the preprocessing has been fitted on the new training signals
+            set_network_preprocessing(trainer->_network,
+                                      get_data_preprocessing_scales(trainer->_data),
+                                      get_data_preprocessing_shifts(trainer->_data));
+            compute_total_error(trainer);
+        }
+    }
+}
+
+void
+get_trainer_stats(const MLPTrainer trainer, MLPTrainerStats stats)
+{
+    if (BRAIN_ALLOCATED(trainer)
+    &&  BRAIN_ALLOCATED(stats))
+    {
+        const BrainUint number_of_layers = get_network_number_of_layer(trainer->_network);
+        BrainUint i = 0;
+
+        *stats = trainer->_stats;
+        stats->number_of_layers = MIN(number_of_layers, MLP_STATS_MAX_LAYERS);
+
+        if (0. < stats->training)
+        {
+            stats->samples_per_second = (BrainDouble)stats->number_of_samples / stats->training;
+        }
+
+        for (i = 0; i < stats->number_of_layers; ++i)
+        {
+            stats->layer_forward[i]  = get_network_layer_forward_time(trainer->_network, i);
+            stats->layer_backward[i] = get_network_layer_backward_time(trainer->_network, i);
+        }
+
+        fill_counter_stats(&(stats->forward_counters),
+                           trainer->_counters,
+                           get_trainer_counts(trainer, Region_Forward),
+                           stats->number_of_samples);
+        fill_counter_stats(&(stats->backward_counters),
+                           trainer->_counters,
+                           get_trainer_counts(trainer, Region_Backward),
+                           stats->number_of_samples);
+        fill_counter_stats(&(stats->update_counters),
+                           trainer->_counters,
+                           get_trainer_counts(trainer, Region_Update),
+                           stats->number_of_samples);
+        fill_counter_stats(&(stats->evaluation_counters),
+                           trainer->_counters,
+                           get_trainer_counts(trainer, Region_Evaluation),
+                           trainer->_evaluations);
+    }
+}
@@ -77,6 +77,19 @@ mlp_trainer_get_progress(MLPTrainer trainer)
     return progress;
 }
 
+BrainUint __MLP_VISIBLE__
+mlp_trainer_get_epoch(MLPTrainer trainer)
+{
+    BrainUint epoch = 0;
+
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        epoch = get_training_epoch(trainer);
+    }
+
+    return epoch;
+}
+
 void __MLP_VISIBLE__
 mlp_trainer_run(MLPTrainer trainer)
 {
@@ -170,3 +183,40 @@ mlp_trainer_get_target_signal(MLPTrainer trainer)
     return ret;
 }
 
+void __MLP_VISIBLE__
+mlp_trainer_split(MLPTrainer trainer, BrainReal training_ratio)
+{
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        split_trainer_data(trainer, training_ratio);
+    }
+}
+
+void __MLP_VISIBLE__
+mlp_trainer_get_stats(MLPTrainer trainer, MLPTrainerStats stats)
+{
+    if (BRAIN_ALLOCATED(trainer)
+    &&  BRAIN_ALLOCATED(stats))
+    {
+        get_trainer_stats(trainer, stats);
+    }
+}
+
+void __MLP_VISIBLE__
+mlp_trainer_get_memory_usage(MLPTrainer trainer, MLPMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(usage))
+    {
+        memset(usage, 0, sizeof(MemoryUsage));
+        accumulate_trainer_memory(trainer, usage);
+    }
+}
+
+void __MLP_VISIBLE__
+mlp_trainer_select_fold(MLPTrainer trainer, BrainUint number_of_folds, BrainUint fold)
+{
+    if (BRAIN_ALLOCATED(trainer))
+    {
+        select_trainer_fold(trainer, number_of_folds, fold);
+    }
+}
@@ -6,6 +6,8 @@ import os
 import ctypes
 
 from exchange.mlpnetwork  import MLPNetwork
+from exchange.mlptrainerstats import MLPTrainerStats, MLPCounterStats
+from exchange.mlpmemory import MLPMemoryUsage, MLPMemoryStats
 from mlploader import MLPLoader
 
 from core.mlpluginbase  import MLPluginBase
@@ -63,6 +65,48 @@ class MLPlugin(MLPluginBase, MLPLoader):
             self._version       = str(meta.version,     'ascii')
             self._author        = str(meta.author,      'ascii')
             self._description   = str(meta.description, 'ascii')
+
+    def mlStartTimeline(self, path):
+        """
+
+        :param path: the Chrome trace JSON file to write
+        :return: True if the recording has been started
+        """
+        ret = False
+        if self.mlp_plugin_start_timeline is not None:
+            ret = self.mlp_plugin_start_timeline(str(path).encode('ascii')) != 0
+        return ret
+
+    def mlStopTimeline(self):
+        """
+
+        """
+        if self.mlp_plugin_stop_timeline is not None:
+            self.mlp_plugin_stop_timeline()
+
+    def mlTrackXmlMemory(self):
+        """
+        Must be called before the first trainer or network is loaded, as the
+        libxml2 allocators are shared by the whole process
+
+        :return: True if the libxml2 allocations are accounted
+        """
+        ret = False
+        if self.mlp_plugin_track_xml_memory is not None:
+            ret = self.mlp_plugin_track_xml_memory() != 0
+        return ret
+
+    def mlGetMemoryStats(self):
+        """
+
+        :return: a dict of the live and peak bytes and allocation counts per tag
+        """
+        ret = {}
+        if self.mlp_plugin_get_memory_stats is not None:
+            stats = MLPMemoryStats()
+            self.mlp_plugin_get_memory_stats(ctypes.byref(stats))
+            ret = stats.toDict()
+        return ret
     """
     ....................................................................
     .......................... Plugin TRINER api........................
@@ -125,6 +169,54 @@ class MLPlugin(MLPluginBase, MLPLoader):
                 ret = self.mlp_trainer_get_progress(trainer['model'])
         return ret
 
+    def mlGetTrainerEpoch(self, trainer):
+        """
+
+        :param trainer:
+        :return:
+        """
+        ret = 0
+        with MLPModelManager(trainer, 'model') as model:
+            if self.mlp_trainer_get_epoch is not None:
+                ret = self.mlp_trainer_get_epoch(trainer['model'])
+        return ret
+
+    def mlGetTrainerStats(self, trainer):
+        """
+
+        :param trainer:
+        :return: a dict of the times in seconds and counts since the configuration
+        """
+        ret = {}
+        with MLPModelManager(trainer, 'model') as model:
+            if self.mlp_trainer_get_stats is not None:
+                stats = MLPTrainerStats()
+                self.mlp_trainer_get_stats(trainer['model'], ctypes.byref(stats))
+
+                for name, _ in MLPTrainerStats._fields_:
+                    ret[name] = getattr(stats, name)
+
+                ret['layer_forward']  = list(stats.layer_forward)[:stats.number_of_layers]
+                ret['layer_backward'] = list(stats.layer_backward)[:stats.number_of_layers]
+
+                for name in ['forward_counters', 'backward_counters', 'update_counters', 'evaluation_counters']:
+                    ret[name] = getattr(stats, name).toDict()
+        return ret
+
+    def mlGetTrainerMemoryUsage(self, trainer):
+        """
+
+        :param trainer:
+        :return: a dict of the bytes owned by the trainer, its network and its data per tag
+        """
+        ret = {}
+        with MLPModelManager(trainer, 'model') as model:
+            if self.mlp_trainer_get_memory_usage is not None:
+                usage = MLPMemoryUsage()
+                self.mlp_trainer_get_memory_usage(trainer['model'], ctypes.byref(usage))
+                ret = usage.toDict()
+        return ret
+
     def mlTrainerRun(self, trainer):
         """
 
@@ -338,6 +430,44 @@ class MLPlugin(MLPluginBase, MLPLoader):
             if self.mlp_network_predict is not None:
                 self.mlp_network_predict(network['model'], num, sig)
 
+    def mlSetNetworkCounters(self, network, enabled):
+        """
+
+        :param network:
+        :param enabled: read the hardware counters around each prediction
+        """
+        with MLPModelManager(network, 'model') as model:
+            if self.mlp_network_set_counters is not None:
+                self.mlp_network_set_counters(network['model'], 1 if enabled else 0)
+
+    def mlGetNetworkCounters(self, network):
+        """
+
+        :param network:
+        :return: a dict of the hardware counters of the predictions
+        """
+        ret = {}
+        with MLPModelManager(network, 'model') as model:
+            if self.mlp_network_get_counters is not None:
+                stats = MLPCounterStats()
+                self.mlp_network_get_counters(network['model'], ctypes.byref(stats))
+                ret = stats.toDict()
+        return ret
+
+    def mlGetNetworkMemoryUsage(self, network):
+        """
+
+        :param network:
+        :return: a dict of the bytes owned by the network per tag
+        """
+        ret = {}
+        with MLPModelManager(network, 'model') as model:
+            if self.mlp_network_get_memory_usage is not None:
+                usage = MLPMemoryUsage()
+                self.mlp_network_get_memory_usage(network['model'], ctypes.byref(usage))
+                ret = usage.toDict()
+        return ret
+
     def mlGetNetworkOutputLength(self, network):
         """
 
@@ -0,0 +1,36 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*
+
+import ctypes
+
+# Must match BrainMemoryTag in brain_memory_utils.h
+MLP_MEMORY_TAGS = ['other', 'weights', 'activations', 'dataset', 'labels', 'xml']
+
+class MLPMemoryUsage(ctypes.Structure):
+    _fields_ = [('bytes',            ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('blocks',           ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('total_bytes',      ctypes.c_ulonglong)]
+
+    def toDict(self):
+        ret = {'total_bytes': self.total_bytes}
+        for i, tag in enumerate(MLP_MEMORY_TAGS):
+            ret[tag] = {'bytes': self.bytes[i], 'blocks': self.blocks[i]}
+        return ret
+
+class MLPMemoryStats(ctypes.Structure):
+    _fields_ = [('live_bytes',       ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('peak_bytes',       ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('allocations',      ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('frees',            ctypes.c_ulonglong * len(MLP_MEMORY_TAGS)),
+                ('total_live_bytes', ctypes.c_ulonglong),
+                ('total_peak_bytes', ctypes.c_ulonglong)]
+
+    def toDict(self):
+        ret = {'total_live_bytes': self.total_live_bytes,
+               'total_peak_bytes': self.total_peak_bytes}
+        for i, tag in enumerate(MLP_MEMORY_TAGS):
+            ret[tag] = {'live_bytes':  self.live_bytes[i],
+                        'peak_bytes':  self.peak_bytes[i],
+                        'allocations': self.allocations[i],
+                        'frees':       self.frees[i]}
+        return ret
@@ -0,0 +1,42 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*
+
+import ctypes
+
+# Must match MLP_STATS_MAX_LAYERS in mlp_types.h
+MLP_STATS_MAX_LAYERS = 16
+
+class MLPCounterStats(ctypes.Structure):
+    _fields_ = [('cycles',                   ctypes.c_ulonglong),
+                ('instructions',             ctypes.c_ulonglong),
+                ('l1_misses',                ctypes.c_ulonglong),
+                ('llc_misses',               ctypes.c_ulonglong),
+                ('branch_misses',            ctypes.c_ulonglong),
+                ('number_of_samples',        ctypes.c_ulonglong),
+                ('instructions_per_cycle',   ctypes.c_double),
+                ('l1_misses_per_sample',     ctypes.c_double),
+                ('llc_misses_per_sample',    ctypes.c_double),
+                ('branch_misses_per_sample', ctypes.c_double),
+                ('available',                ctypes.c_uint)]
+
+    def toDict(self):
+        return dict((name, getattr(self, name)) for name, _ in self._fields_)
+
+class MLPTrainerStats(ctypes.Structure):
+    _fields_ = [('training',              ctypes.c_double),
+                ('sampling',              ctypes.c_double),
+                ('forward',               ctypes.c_double),
+                ('backward',              ctypes.c_double),
+                ('update',                ctypes.c_double),
+                ('evaluation',            ctypes.c_double),
+                ('serialization',         ctypes.c_double),
+                ('samples_per_second',    ctypes.c_double),
+                ('number_of_samples',     ctypes.c_ulonglong),
+                ('number_of_steps',       ctypes.c_ulonglong),
+                ('number_of_layers',      ctypes.c_uint),
+                ('layer_forward',         ctypes.c_double * MLP_STATS_MAX_LAYERS),
+                ('layer_backward',        ctypes.c_double * MLP_STATS_MAX_LAYERS),
+                ('forward_counters',      MLPCounterStats),
+                ('backward_counters',     MLPCounterStats),
+                ('update_counters',       MLPCounterStats),
+                ('evaluation_counters',   MLPCounterStats)]
@@ -7,6 +7,8 @@ from core.mlfunction import MLFunction
 from exchange.mlptrainer import MLPTrainer
 from exchange.mlpnetwork import MLPNetwork
 from exchange.mlpmetada import MLPMetaData
+from exchange.mlptrainerstats import MLPTrainerStats, MLPCounterStats
+from exchange.mlpmemory import MLPMemoryUsage, MLPMemoryStats
 
 import ctypes
 
@@ -28,12 +30,17 @@ class MLPLoader(MLLoader):
 
         self.mlp_plugin_init                       = MLFunction(self, 'mlp_plugin_init',                         None,                       [])
         self.mlp_plugin_metadata                   = MLFunction(self, 'mlp_plugin_metadata',                     ctypes.POINTER(MLPMetaData),[])
+        self.mlp_plugin_start_timeline             = MLFunction(self, 'mlp_plugin_start_timeline',               ctypes.c_ubyte,             [ctypes.c_char_p])
+        self.mlp_plugin_stop_timeline              = MLFunction(self, 'mlp_plugin_stop_timeline',                None,                       [])
+        self.mlp_plugin_track_xml_memory           = MLFunction(self, 'mlp_plugin_track_xml_memory',             ctypes.c_ubyte,             [])
+        self.mlp_plugin_get_memory_stats           = MLFunction(self, 'mlp_plugin_get_memory_stats',             None,                       [ctypes.POINTER(MLPMemoryStats)])
         
         self.mlp_trainer_new                       = MLFunction(self, 'mlp_trainer_new',                         ctypes.POINTER(MLPTrainer), [ctypes.c_char_p, ctypes.c_char_p])
         self.mlp_trainer_delete                    = MLFunction(self, 'mlp_trainer_delete',                      None,                       [ctypes.POINTER(MLPTrainer)])
         self.mlp_trainer_configure                 = MLFunction(self, 'mlp_trainer_configure',                   None,                       [ctypes.POINTER(MLPTrainer), ctypes.c_char_p])
         self.mlp_trainer_is_running                = MLFunction(self, 'mlp_trainer_is_running',                  ctypes.c_ubyte,             [ctypes.POINTER(MLPTrainer)])
         self.mlp_trainer_get_progress              = MLFunction(self, 'mlp_trainer_get_progress',                ctypes.c_double,            [ctypes.POINTER(MLPTrainer)])
+        self.mlp_trainer_get_epoch                 = MLFunction(self, 'mlp_trainer_get_epoch',                   ctypes.c_uint,              [ctypes.POINTER(MLPTrainer)])
         self.mlp_trainer_run                       = MLFunction(self, 'mlp_trainer_run',                         None,                       [ctypes.POINTER(MLPTrainer)])
         self.mlp_trainer_error                     = MLFunction(self, 'mlp_trainer_error',                       ctypes.c_double,            [ctypes.POINTER(MLPTrainer)])
         self.mlp_trainer_save_progression          = MLFunction(self, 'mlp_trainer_save_progression',            None,                       [ctypes.POINTER(MLPTrainer), ctypes.c_char_p])
@@ -42,6 +49,10 @@ class MLPLoader(MLLoader):
         self.mlp_trainer_get_layer_output_signal   = MLFunction(self, 'mlp_trainer_get_layer_output_signal',     None,                       [ctypes.POINTER(MLPTrainer), ctypes.c_uint], True)
         self.mlp_trainer_get_input_signal          = MLFunction(self, 'mlp_trainer_get_input_signal',            None,                       [ctypes.POINTER(MLPTrainer)], True)
         self.mlp_trainer_get_target_signal         = MLFunction(self, 'mlp_trainer_get_target_signal',           None,                       [ctypes.POINTER(MLPTrainer)])
+        self.mlp_trainer_split                     = MLFunction(self, 'mlp_trainer_split',                       None,                       [ctypes.POINTER(MLPTrainer), ctypes.c_double])
+        self.mlp_trainer_select_fold               = MLFunction(self, 'mlp_trainer_select_fold',                 None,                       [ctypes.POINTER(MLPTrainer), ctypes.c_uint, ctypes.c_uint])
+        self.mlp_trainer_get_stats                 = MLFunction(self, 'mlp_trainer_get_stats',                   None,                       [ctypes.POINTER(MLPTrainer), ctypes.POINTER(MLPTrainerStats)])
+        self.mlp_trainer_get_memory_usage          = MLFunction(self, 'mlp_trainer_get_memory_usage',            None,                       [ctypes.POINTER(MLPTrainer), ctypes.POINTER(MLPMemoryUsage)])
 
         self.mlp_network_new                       = MLFunction(self, 'mlp_network_new',                         ctypes.POINTER(MLPNetwork), [ctypes.c_char_p])
         self.mlp_network_delete                    = MLFunction(self, 'mlp_network_delete',                      None,                       [ctypes.POINTER(MLPNetwork)])
@@ -53,3 +64,10 @@ class MLPLoader(MLLoader):
         self.mlp_network_get_layer_number_of_neuron= MLFunction(self, 'mlp_network_get_layer_number_of_neuron',  ctypes.c_uint,              [ctypes.POINTER(MLPNetwork), ctypes.c_uint])
         self.mlp_network_get_number_of_layer       = MLFunction(self, 'mlp_network_get_number_of_layer',         ctypes.c_uint,              [ctypes.POINTER(MLPNetwork)])
         self.mlp_network_get_number_of_input       = MLFunction(self, 'mlp_network_get_number_of_input',         ctypes.c_uint,              [ctypes.POINTER(MLPNetwork)])
+        self.mlp_network_get_number_of_label       = MLFunction(self, 'mlp_network_get_number_of_label',         ctypes.c_uint,              [ctypes.POINTER(MLPNetwork)])
+        self.mlp_network_get_label                 = MLFunction(self, 'mlp_network_get_label',                   ctypes.c_char_p,            [ctypes.POINTER(MLPNetwork), ctypes.c_uint])
+        self.mlp_network_is_preprocessing          = MLFunction(self, 'mlp_network_is_preprocessing',            ctypes.c_ubyte,             [ctypes.POINTER(MLPNetwork)])
+        self.mlp_network_fold_preprocessing        = MLFunction(self, 'mlp_network_fold_preprocessing',          None,                       [ctypes.POINTER(MLPNetwork)])
+        self.mlp_network_set_counters              = MLFunction(self, 'mlp_network_set_counters',                None,                       [ctypes.POINTER(MLPNetwork), ctypes.c_ubyte])
+        self.mlp_network_get_counters              = MLFunction(self, 'mlp_network_get_counters',                None,                       [ctypes.POINTER(MLPNetwork), ctypes.POINTER(MLPCounterStats)])
+        self.mlp_network_get_memory_usage          = MLFunction(self, 'mlp_network_get_memory_usage',            None,                       [ctypes.POINTER(MLPNetwork), ctypes.POINTER(MLPMemoryUsage)])
@@ -0,0 +1,251 @@
+#include "mlp_api.h"
+#include "mlp_network.h"
+#include "mlp_layer.h"
+#include "mlp_neuron.h"
+#include "brain_data_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_random_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define TRAINER_TEST_FOLDS      10
+#define TRAINER_TEST_ITERATIONS 20
+#define TRAINER_TEST_REFITS     2000
+#define TRAINER_TEST_TOLERANCE  1e-7
+
+static BrainBool
+check(const BrainBool condition, BrainString message)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", message);
+    }
+
+    return condition;
+}
+
+static BrainUint
+get_row(BrainSignal signal, BrainSignal base, const BrainUint input_length)
+{
+    return (BrainUint)(signal - base) / input_length;
+}
+
+static BrainReal
+get_first_weight(MLPTrainer trainer)
+{
+    MLPNetwork network = mlp_trainer_get_network(trainer);
+
+    return get_neuron_weight(get_layer_neuron(get_network_layer(network, 0), 0), 0);
+}
+
+static BrainBool
+check_folds(BrainString data_path)
+{
+    BrainData   data      = new_data_from_context(data_path);
+    BrainUint*  evaluated = NULL;
+    BrainUint*  seen      = NULL;
+    BrainSignal base      = NULL;
+    BrainUint   rows      = 0;
+    BrainUint   length    = 0;
+    BrainBool   disjoint  = BRAIN_TRUE;
+    BrainBool   covered   = BRAIN_TRUE;
+    BrainBool   ret       = BRAIN_TRUE;
+    BrainUint   fold      = 0;
+    BrainUint   i         = 0;
+
+    if (!check(BRAIN_ALLOCATED(data), "the data is loaded"))
+    {
+        return BRAIN_FALSE;
+    }
+
+    rows   = get_number_of_training_sample(data) + get_number_of_evaluating_sample(data);
+    length = get_input_signal_length(data);
+    base   = get_training_input_signal(data, 0);
+
+    /******************************************************************/
+    /**  The rows are stored contiguously, the lowest signal of both **/
+    /**  views is the first row                                      **/
+    /******************************************************************/
+    for (i = 0; i < get_number_of_training_sample(data); ++i)
+    {
+        const BrainSignal signal = get_training_input_signal(data, i);
+
+        base = (signal < base) ? signal : base;
+    }
+
+    for (i = 0; i < get_number_of_evaluating_sample(data); ++i)
+    {
+        const BrainSignal signal = get_evaluating_input_signal(data, i);
+
+        base = (signal < base) ? signal : base;
+    }
+
+    BRAIN_NEW(evaluated, BrainUint, rows);
+    BRAIN_NEW(seen,      BrainUint, rows);
+
+    for (fold = 0; fold < TRAINER_TEST_FOLDS; ++fold)
+    {
+        ret = check(select_data_fold(data, TRAINER_TEST_FOLDS, fold), "the fold is selected") && ret;
+        ret = check(get_number_of_training_sample(data) + get_number_of_evaluating_sample(data) == rows, "a fold keeps every row") && ret;
+
+        // each row is either trained or evaluated in a fold
+        for (i = 0; i < rows; ++i)
+        {
+            seen[i] = 0;
+        }
+
+        for (i = 0; i < get_number_of_training_sample(data); ++i)
+        {
+            ++seen[get_row(get_training_input_signal(data, i), base, length)];
+        }
+
+        for (i = 0; i < get_number_of_evaluating_sample(data); ++i)
+        {
+            const BrainUint row = get_row(get_evaluating_input_signal(data, i), base, length);
+
+            ++seen[row];
+            ++evaluated[row];
+        }
+
+        for (i = 0; i < rows; ++i)
+        {
+            disjoint = disjoint && (seen[i] == 1);
+        }
+    }
+
+    // each row is evaluated in exactly one fold
+    for (i = 0; i < rows; ++i)
+    {
+        covered = covered && (evaluated[i] == 1);
+    }
+
+    ret = check(disjoint, "the training and evaluating views are disjoint and cover all rows") && ret;
+    ret = check(covered,  "the evaluating views of the folds partition the rows") && ret;
+    ret = check(!select_data_fold(data, rows + 1, 0), "more folds than rows are refused") && ret;
+    ret = check(get_number_of_training_sample(data) + get_number_of_evaluating_sample(data) == rows, "a refused fold keeps every row") && ret;
+
+    BRAIN_DELETE(evaluated);
+    BRAIN_DELETE(seen);
+    delete_data(data);
+
+    return ret;
+}
+
+static BrainBool
+check_refits(BrainString data_path)
+{
+    BrainData   refitted = NULL;
+    BrainData   fitted   = NULL;
+    BrainDouble worst    = 0.;
+    BrainBool   ret      = BRAIN_TRUE;
+    BrainUint   i        = 0;
+    BrainUint   j        = 0;
+
+    // both data shuffle their rows the same way
+    set_random_seed(11);
+    refitted = new_data_from_context(data_path);
+    set_random_seed(11);
+    fitted   = new_data_from_context(data_path);
+
+    /******************************************************************/
+    /**  Cycling through the folds refits the preprocessing many     **/
+    /**  times, the rows should not drift from a single fit          **/
+    /******************************************************************/
+    for (i = 0; i < TRAINER_TEST_REFITS; ++i)
+    {
+        select_data_fold(refitted, TRAINER_TEST_FOLDS, (i + 1) % TRAINER_TEST_FOLDS);
+    }
+
+    select_data_fold(fitted, TRAINER_TEST_FOLDS, TRAINER_TEST_REFITS % TRAINER_TEST_FOLDS);
+
+    for (i = 0; i < get_number_of_training_sample(fitted); ++i)
+    {
+        const BrainSignal a = get_training_input_signal(refitted, i);
+        const BrainSignal b = get_training_input_signal(fitted, i);
+
+        for (j = 0; j < get_input_signal_length(fitted); ++j)
+        {
+            const BrainDouble d = fabs((BrainDouble)a[j] - (BrainDouble)b[j]);
+
+            worst = (worst < d) ? d : worst;
+        }
+    }
+
+    printf("rows within %.3e after %u refits\n", worst, TRAINER_TEST_REFITS);
+    ret = check(worst < TRAINER_TEST_TOLERANCE, "refitting the preprocessing does not drift") && ret;
+
+    delete_data(refitted);
+    delete_data(fitted);
+
+    return ret;
+}
+
+static BrainBool
+check_training(BrainString network_path, BrainString data_path, BrainString settings_path)
+{
+    MLPTrainer trainer = mlp_trainer_new(network_path, data_path);
+    BrainBool  trained = BRAIN_TRUE;
+    BrainBool  reset   = BRAIN_TRUE;
+    BrainBool  ret     = BRAIN_TRUE;
+    BrainReal  weight  = 0.;
+    BrainUint  fold    = 0;
+
+    if (!check(BRAIN_ALLOCATED(trainer), "the trainer is loaded"))
+    {
+        return BRAIN_FALSE;
+    }
+
+    mlp_trainer_configure(trainer, settings_path);
+
+    /******************************************************************/
+    /**  Every fold starts a new training, even once the former fold **/
+    /**  has used all its iterations                                 **/
+    /******************************************************************/
+    for (fold = 0; fold < TRAINER_TEST_FOLDS; ++fold)
+    {
+        BrainUint runs = 0;
+
+        mlp_trainer_select_fold(trainer, TRAINER_TEST_FOLDS, fold);
+
+        reset = reset && ((fold == 0) || (get_first_weight(trainer) != weight));
+
+        while (mlp_trainer_is_running(trainer) && (runs <= TRAINER_TEST_ITERATIONS))
+        {
+            mlp_trainer_run(trainer);
+            ++runs;
+        }
+
+        trained = trained && (0 < runs) && (runs <= TRAINER_TEST_ITERATIONS);
+        weight  = get_first_weight(trainer);
+
+        printf("fold %u: %u iterations, error %.4f\n", fold, runs, mlp_trainer_error(trainer));
+    }
+
+    ret = check(trained, "every fold trains") && ret;
+    ret = check(reset,   "every fold draws new weights") && ret;
+
+    mlp_trainer_delete(trainer);
+
+    return ret;
+}
+
+int
+main(int argc, char** argv)
+{
+    BrainBool ret = BRAIN_TRUE;
+
+    if (argc != 4)
+    {
+        printf("usage: %s network.xml data.xml settings.xml\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    mlp_plugin_init();
+
+    ret = check_folds(argv[2]) && ret;
+    ret = check_refits(argv[2]) && ret;
+    ret = check_training(argv[1], argv[2], argv[3]) && ret;
+
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,410 @@
+/**
+ * \file brain_bench_check.c
+ * \brief Compare benchmark results with a baseline
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Reads two JSON files written by brain_bench or brain_core_bench and
+ * compares the metrics of the same name. A metric regresses when its median
+ * is worse than the baseline by more than its tolerance and by more than
+ * the noise, that is the sum of both median absolute deviations times a
+ * factor. The direction of a metric is given by its better field.
+ *
+ * The tolerance is, by priority, the one of the baseline metric, the one
+ * at the top of the baseline file, then the command line one. A metric of
+ * the baseline missing from the results is a failure. Given several results
+ * files, the best median of each metric is compared: noise only slows down
+ * a run, so a regression has to show in all of them.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "brain_core_types.h"
+#include "brain_memory_utils.h"
+
+#define CHECK_MAX_NAME          128
+#define CHECK_MAX_FILES         16
+/**
+ * \def CHECK_DEFAULT_TOLERANCE
+ * \brief catches a lost third of the throughput, not the noise of shared machines
+ */
+#define CHECK_DEFAULT_TOLERANCE 0.3
+#define CHECK_DEFAULT_FACTOR    3.
+
+/**
+ * \struct CheckMetric
+ * \brief  A benchmark result
+ */
+typedef struct CheckMetric
+{
+    BrainChar   _name[CHECK_MAX_NAME]; /*!< Unique name of the measure     */
+    BrainDouble _median;               /*!< Median value                   */
+    BrainDouble _mad;                  /*!< Median absolute deviation      */
+    BrainDouble _tolerance;            /*!< Relative tolerance, -1 if none */
+    BrainBool   _lower;                /*!< Lower values are better        */
+} CheckMetric;
+
+/**
+ * \struct CheckResults
+ * \brief  The results of a benchmark file
+ */
+typedef struct CheckResults
+{
+    CheckMetric* _metrics;           /*!< Metrics of the file            */
+    BrainUint    _number_of_metrics; /*!< Number of metrics              */
+    BrainDouble  _tolerance;         /*!< File tolerance, -1 if none     */
+} CheckResults;
+
+static BrainChar*
+read_file(BrainString path)
+{
+    BrainChar* buffer = NULL;
+    FILE*      file   = fopen(path, "rb");
+
+    if (BRAIN_ALLOCATED(file))
+    {
+        long length = 0;
+
+        fseek(file, 0, SEEK_END);
+        length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if (0 <= length)
+        {
+            BRAIN_NEW(buffer, BrainChar, length + 1);
+
+            if (fread(buffer, 1, length, file) != (size_t)length)
+            {
+                BRAIN_DELETE(buffer);
+            }
+        }
+
+        fclose(file);
+    }
+
+    return buffer;
+}
+
+static BrainString
+find_value(BrainString object, BrainString key)
+{
+    BrainChar   pattern[CHECK_MAX_NAME];
+    BrainString value = NULL;
+
+    snprintf(pattern, CHECK_MAX_NAME, "\"%s\"", key);
+    value = strstr(object, pattern);
+
+    if (BRAIN_ALLOCATED(value))
+    {
+        value = strchr(value + strlen(pattern), ':');
+
+        if (BRAIN_ALLOCATED(value))
+        {
+            ++value;
+            value += strspn(value, " \t\r\n");
+        }
+    }
+
+    return value;
+}
+
+static BrainBool
+get_number(BrainString object, BrainString key, BrainDouble* number)
+{
+    BrainString value = find_value(object, key);
+    BrainChar*  end   = NULL;
+    BrainBool   ret   = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(value))
+    {
+        *number = strtod(value, &end);
+        ret     = (end != value);
+    }
+
+    return ret;
+}
+
+static BrainBool
+get_string(BrainString object, BrainString key, BrainChar* string)
+{
+    BrainString value = find_value(object, key);
+    BrainBool   ret   = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(value)
+    &&  (*value == '"'))
+    {
+        const BrainString end = strchr(value + 1, '"');
+
+        if (BRAIN_ALLOCATED(end)
+        &&  (end - value - 1 < CHECK_MAX_NAME))
+        {
+            memcpy(string, value + 1, end - value - 1);
+            string[end - value - 1] = '\0';
+            ret = BRAIN_TRUE;
+        }
+    }
+
+    return ret;
+}
+
+static BrainBool
+load_results(BrainString path, CheckResults* results)
+{
+    BrainChar* buffer = read_file(path);
+    BrainChar* object = NULL;
+    BrainBool  ret    = BRAIN_FALSE;
+
+    memset(results, 0, sizeof(CheckResults));
+    results->_tolerance = -1.;
+
+    if (BRAIN_ALLOCATED(buffer))
+    {
+        object = strstr(buffer, "\"results\"");
+
+        if (BRAIN_ALLOCATED(object))
+        {
+            /**********************************************************/
+            /**   The file tolerance is written before the results   **/
+            /**********************************************************/
+            *object = '\0';
+            get_number(buffer, "tolerance", &(results->_tolerance));
+            object = strchr(object + 1, '{');
+            ret    = BRAIN_TRUE;
+
+            // the results are flat objects
+            while (ret
+            &&     BRAIN_ALLOCATED(object))
+            {
+                BrainChar* end = strchr(object, '}');
+                CheckMetric* metric = NULL;
+                BrainChar better[CHECK_MAX_NAME] = "higher";
+
+                if (!BRAIN_ALLOCATED(end))
+                {
+                    ret = BRAIN_FALSE;
+                    break;
+                }
+
+                *end = '\0';
+
+                BRAIN_RESIZE(results->_metrics, CheckMetric, (results->_number_of_metrics + 1));
+                metric = &(results->_metrics[results->_number_of_metrics]);
+                metric->_tolerance = -1.;
+
+                ret = get_string(object, "name", metric->_name)
+                &&    get_number(object, "median", &(metric->_median))
+                &&    get_number(object, "mad", &(metric->_mad));
+
+                get_number(object, "tolerance", &(metric->_tolerance));
+                get_string(object, "better", better);
+                metric->_lower = !strcmp(better, "lower");
+
+                ++results->_number_of_metrics;
+                object = strchr(end + 1, '{');
+            }
+        }
+
+        if (!ret)
+        {
+            fprintf(stderr, "Unable to parse the results of %s\n", path);
+            BRAIN_DELETE(results->_metrics);
+        }
+
+        BRAIN_DELETE(buffer);
+    }
+    else
+    {
+        fprintf(stderr, "Unable to read %s\n", path);
+    }
+
+    return ret;
+}
+
+static const CheckMetric*
+find_metric(const CheckResults* results, BrainString name)
+{
+    const CheckMetric* ret = NULL;
+    BrainUint i = 0;
+
+    for (i = 0; !BRAIN_ALLOCATED(ret) && (i < results->_number_of_metrics); ++i)
+    {
+        if (!strcmp(results->_metrics[i]._name, name))
+        {
+            ret = &(results->_metrics[i]);
+        }
+    }
+
+    return ret;
+}
+
+static void
+merge_results(CheckResults* results, const CheckResults* other)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < other->_number_of_metrics; ++i)
+    {
+        const CheckMetric* metric = &(other->_metrics[i]);
+        CheckMetric*       best   = (CheckMetric*)find_metric(results, metric->_name);
+
+        if (!BRAIN_ALLOCATED(best))
+        {
+            BRAIN_RESIZE(results->_metrics, CheckMetric, (results->_number_of_metrics + 1));
+            results->_metrics[results->_number_of_metrics++] = *metric;
+        }
+        else if (metric->_lower ? (metric->_median < best->_median)
+                                : (best->_median < metric->_median))
+        {
+            *best = *metric;
+        }
+    }
+}
+
+static BrainUint
+compare_results(const CheckResults* baseline,
+                const CheckResults* current,
+                const BrainDouble tolerance,
+                const BrainDouble factor)
+{
+    BrainUint failures = 0;
+    BrainUint i = 0;
+
+    printf("%-48s %14s %14s %9s %9s  %s\n", "metric", "baseline", "current", "change", "tolerance", "status");
+
+    for (i = 0; i < baseline->_number_of_metrics; ++i)
+    {
+        const CheckMetric* reference = &(baseline->_metrics[i]);
+        const CheckMetric* measure   = find_metric(current, reference->_name);
+        const BrainDouble  allowed   = (0. <= reference->_tolerance) ? reference->_tolerance
+                                     : (0. <= baseline->_tolerance)  ? baseline->_tolerance
+                                     : tolerance;
+
+        if (!BRAIN_ALLOCATED(measure))
+        {
+            printf("%-48s %14.6g %14s %9s %8.1f%%  MISSING\n", reference->_name, reference->_median, "-", "-", allowed * 100.);
+            ++failures;
+        }
+        else
+        {
+            const BrainDouble change = (reference->_median != 0.) ? (measure->_median - reference->_median) / reference->_median : 0.;
+            const BrainDouble noise  = factor * (reference->_mad + measure->_mad);
+            // positive when the measure is worse than the baseline
+            const BrainDouble loss   = reference->_lower ? change : -change;
+            const BrainDouble delta  = (measure->_median > reference->_median) ? measure->_median - reference->_median
+                                                                                : reference->_median - measure->_median;
+            BrainString status = "ok";
+
+            if ((allowed < loss)
+            &&  (noise < delta))
+            {
+                status = "REGRESSION";
+                ++failures;
+            }
+            else if ((allowed < -loss)
+            &&       (noise < delta))
+            {
+                status = "improved";
+            }
+
+            printf("%-48s %14.6g %14.6g %+8.1f%% %8.1f%%  %s\n",
+                   reference->_name, reference->_median, measure->_median, change * 100., allowed * 100., status);
+        }
+    }
+
+    for (i = 0; i < current->_number_of_metrics; ++i)
+    {
+        if (!BRAIN_ALLOCATED(find_metric(baseline, current->_metrics[i]._name)))
+        {
+            printf("%-48s %14s %14.6g %9s %9s  new\n", current->_metrics[i]._name, "-", current->_metrics[i]._median, "-", "-");
+        }
+    }
+
+    printf("%u failure(s) out of %u baseline metrics\n", failures, baseline->_number_of_metrics);
+
+    return failures;
+}
+
+static void
+usage(BrainString program)
+{
+    printf("Usage: %s [options] BASELINE RESULTS...\n"
+           "  --tolerance T   relative tolerance when the baseline has none (%.2f)\n"
+           "  --mad-factor K  a regression must exceed K times the MADs    (%.1f)\n"
+           "The best median of the results files is compared, so that a regression\n"
+           "has to be measured by every run.\n",
+           program, CHECK_DEFAULT_TOLERANCE, CHECK_DEFAULT_FACTOR);
+}
+
+int
+main(int argc, char** argv)
+{
+    BrainString  paths[CHECK_MAX_FILES];
+    BrainUint    number_of_paths = 0;
+    BrainDouble  tolerance = CHECK_DEFAULT_TOLERANCE;
+    BrainDouble  factor    = CHECK_DEFAULT_FACTOR;
+    CheckResults baseline;
+    CheckResults current;
+    BrainInt     ret = EXIT_FAILURE;
+    BrainInt     i = 0;
+
+    for (i = 1; i < argc; ++i)
+    {
+        const BrainBool has_value = (i + 1 < argc);
+
+        if (!strcmp(argv[i], "--tolerance") && has_value)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--mad-factor") && has_value)
+        {
+            factor = atof(argv[++i]);
+        }
+        else if ((argv[i][0] != '-')
+        &&       (number_of_paths < CHECK_MAX_FILES))
+        {
+            paths[number_of_paths++] = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+    }
+
+    if (number_of_paths < 2)
+    {
+        usage(argv[0]);
+    }
+    else if (load_results(paths[0], &baseline))
+    {
+        BrainBool loaded = BRAIN_TRUE;
+        BrainUint p = 0;
+
+        memset(&current, 0, sizeof(CheckResults));
+
+        for (p = 1; loaded && (p < number_of_paths); ++p)
+        {
+            CheckResults results;
+
+            loaded = load_results(paths[p], &results);
+
+            if (loaded)
+            {
+                merge_results(&current, &results);
+                BRAIN_DELETE(results._metrics);
+            }
+        }
+
+        if (loaded
+        &&  (compare_results(&baseline, &current, tolerance, factor) == 0))
+        {
+            ret = EXIT_SUCCESS;
+        }
+
+        BRAIN_DELETE(current._metrics);
+        BRAIN_DELETE(baseline._metrics);
+    }
+
+    return ret;
+}
@@ -0,0 +1,35 @@
+# Run a benchmark and compare its results with a baseline
+#
+#   BENCH      the benchmark executable
+#   BENCH_ARGS its arguments, separated by spaces
+#   CHECK      the brain_bench_check executable
+#   BASELINE   the baseline JSON file
+#   RESULTS    the JSON file written by the benchmark, suffixed by the attempt
+#   ATTEMPTS   number of runs before reporting a regression
+#
+# A failed check runs the benchmark again and compares the best results of
+# all the runs, so that a regression has to show in every one of them.
+separate_arguments(BENCH_ARGS)
+
+set(CHECK_RESULT 1)
+set(ATTEMPT 0)
+set(ATTEMPT_RESULTS)
+
+while ((NOT CHECK_RESULT EQUAL 0) AND (ATTEMPT LESS ATTEMPTS))
+    math(EXPR ATTEMPT "${ATTEMPT} + 1")
+    list(APPEND ATTEMPT_RESULTS ${RESULTS}.${ATTEMPT})
+
+    execute_process(COMMAND ${BENCH} ${BENCH_ARGS} --json ${RESULTS}.${ATTEMPT}
+                    RESULT_VARIABLE BENCH_RESULT)
+
+    if (NOT BENCH_RESULT EQUAL 0)
+        message(FATAL_ERROR "${BENCH} failed: ${BENCH_RESULT}")
+    endif(NOT BENCH_RESULT EQUAL 0)
+
+    execute_process(COMMAND ${CHECK} ${BASELINE} ${ATTEMPT_RESULTS}
+                    RESULT_VARIABLE CHECK_RESULT)
+endwhile((NOT CHECK_RESULT EQUAL 0) AND (ATTEMPT LESS ATTEMPTS))
+
+if (NOT CHECK_RESULT EQUAL 0)
+    message(FATAL_ERROR "Performance regression against ${BASELINE} in ${ATTEMPTS} runs")
+endif(NOT CHECK_RESULT EQUAL 0)
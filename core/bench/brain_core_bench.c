@@ -0,0 +1,907 @@
+/**
+ * \file brain_core_bench.c
+ * \brief Measure the throughput of the BrainCore kernels in isolation
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Each kernel is timed on vectors of increasing sizes. The default sizes are
+ * derived from the cache sizes of the machine so that the two vectors of a
+ * kernel fit in half of the L1, L2 and L3 caches, then spill to the memory.
+ * A measure is repeated and reported as its median and its median absolute
+ * deviation in nanoseconds per element, with the matching bandwidth.
+ *
+ * Signal kernels see the vectors as signals of BENCH_DIMENSION reals. The
+ * CSV and XML kernels parse generated files: an element is a parsed field
+ * or a read attribute and their bandwidth is the one of the file.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/stat.h>
+
+#include "brain_signal_utils.h"
+#include "brain_random_utils.h"
+#include "brain_csv_utils.h"
+#include "brain_xml_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_probe.h"
+
+#define BENCH_MAX_VALUES    16
+#define BENCH_MAX_REPEAT    64
+#define BENCH_DIMENSION     16
+#define BENCH_CLASSES       8
+/**
+ * \def BENCH_MAX_FOOTPRINT
+ * \brief bytes of the largest default size, above the last level cache
+ */
+#define BENCH_MAX_FOOTPRINT (1U << 30)
+/**
+ * \def BENCH_MAX_PARSED
+ * \brief elements of the largest generated file
+ */
+#define BENCH_MAX_PARSED    (1U << 22)
+
+/**
+ * \struct BenchOptions
+ * \brief  Benchmarked sizes and measurement parameters
+ */
+typedef struct BenchOptions
+{
+    BrainUint   _sizes[BENCH_MAX_VALUES];   /*!< Elements per vector       */
+    BrainUint   _number_of_sizes;           /*!< Number of sizes           */
+    BrainString _kernels[BENCH_MAX_VALUES]; /*!< Kernels, all if none      */
+    BrainUint   _number_of_kernels;         /*!< Number of kernels         */
+    BrainUint   _repeat;                    /*!< Repetitions per measure   */
+    BrainDouble _time;                      /*!< Seconds per repetition    */
+    BrainInt    _cpu;                       /*!< Pinned cpu, -1 if none    */
+    BrainString _json;                      /*!< JSON output, may be NULL  */
+} BenchOptions;
+
+/**
+ * \brief build the inputs of a kernel, returns the elements of a call or 0
+ */
+typedef BrainUint (*BenchSetup)(const BrainUint size);
+/**
+ * \brief call a kernel count times
+ */
+typedef void (*BenchRun)(const BrainUint count);
+/**
+ * \brief release the inputs of a kernel
+ */
+typedef void (*BenchTeardown)();
+
+/**
+ * \struct BenchKernel
+ * \brief  A measured kernel
+ */
+typedef struct BenchKernel
+{
+    BrainString   _name;     /*!< Kernel name                           */
+    BrainUint     _bytes;    /*!< Bytes per element, 0 for a file       */
+    BrainUint     _max_size; /*!< Largest size, 0 if unbounded          */
+    BenchSetup    _setup;    /*!< Build the inputs                      */
+    BenchRun      _run;      /*!< Call the kernel                       */
+    BenchTeardown _teardown; /*!< Release the inputs                    */
+} BenchKernel;
+
+/**
+ * \struct BenchResult
+ * \brief  A measured cost
+ */
+typedef struct BenchResult
+{
+    BrainDouble _median; /*!< Median nanoseconds per element  */
+    BrainDouble _mad;    /*!< Median absolute deviation       */
+} BenchResult;
+
+static BrainReal*      _a         = NULL;
+static BrainReal*      _b         = NULL;
+static BrainReal**     _signals   = NULL;
+static BrainReal**     _centers   = NULL;
+static BrainUint*      _labels    = NULL;
+static BrainReal       _means[BENCH_DIMENSION];
+static BrainReal       _sigmas[BENCH_DIMENSION];
+static BrainReal       _min[BENCH_DIMENSION];
+static BrainReal       _max[BENCH_DIMENSION];
+static BrainUint       _size      = 0;
+static BrainUint       _rows      = 0;
+static BrainRandomMask _mask      = NULL;
+static BrainCsvReader  _reader    = NULL;
+static Document        _document  = NULL;
+static BrainChar       _path[]    = "/tmp/brain_core_bench_XXXXXX";
+static BrainBool       _has_path  = BRAIN_FALSE;
+static BrainDouble     _file_size = 0.;
+static FILE*           _json      = NULL;
+static BrainBool       _first     = BRAIN_TRUE;
+// keep the results alive so that the calls are not optimized out
+static volatile BrainDouble _sink = 0.;
+
+static BrainString
+get_precision()
+{
+    return (sizeof(BrainReal) == sizeof(BrainDouble)) ? "double" : "float";
+}
+
+/**********************************************************************/
+/**                            INPUTS                                **/
+/**********************************************************************/
+static BrainUint
+setup_vectors(const BrainUint size)
+{
+    BrainRandom random = get_thread_random();
+    BrainUint i = 0, j = 0;
+
+    if (_size != size)
+    {
+        const BrainUint rows = (BENCH_DIMENSION <= size) ? size / BENCH_DIMENSION : 1;
+
+        _size = size;
+        _rows = size / BENCH_DIMENSION;
+
+        BRAIN_RESIZE(_a, BrainReal, size);
+        BRAIN_RESIZE(_b, BrainReal, size);
+        BRAIN_RESIZE(_signals, BrainReal*, rows);
+        BRAIN_RESIZE(_labels,  BrainUint,  rows);
+
+        for (i = 0; i < _rows; ++i)
+        {
+            _signals[i] = _a + i * BENCH_DIMENSION;
+        }
+    }
+    /******************************************************************/
+    /**   Separated clusters, so that kmeans converges in a few     **/
+    /**   iterations whatever the size                               **/
+    /******************************************************************/
+    for (i = 0; i < size; i += BENCH_DIMENSION)
+    {
+        const BrainReal center = (BrainReal)(10 * random_index(random, BENCH_CLASSES));
+
+        for (j = i; (j < i + BENCH_DIMENSION) && (j < size); ++j)
+        {
+            _a[j] = center + (BrainReal)random_normal(random);
+        }
+    }
+
+    fill_random_uniform(random, _b, size, -1., 1.);
+
+    return size;
+}
+
+static BrainUint
+setup_signals(const BrainUint size)
+{
+    BrainUint i = 0;
+
+    setup_vectors(size);
+
+    // the applied models leave the signals unchanged between the calls
+    for (i = 0; i < BENCH_DIMENSION; ++i)
+    {
+        _means[i]  = 0.;
+        _sigmas[i] = 1.;
+        _min[i]    = 0.;
+        _max[i]    = 1.;
+    }
+
+    return _rows * BENCH_DIMENSION;
+}
+
+static BrainUint
+setup_kmeans(const BrainUint size)
+{
+    BrainUint i = 0;
+
+    setup_vectors(size);
+
+    if (!BRAIN_ALLOCATED(_centers))
+    {
+        BRAIN_NEW(_centers, BrainReal*, BENCH_CLASSES);
+
+        for (i = 0; i < BENCH_CLASSES; ++i)
+        {
+            BRAIN_NEW(_centers[i], BrainReal, BENCH_DIMENSION);
+        }
+    }
+
+    return (BENCH_CLASSES <= _rows) ? _rows * BENCH_DIMENSION : 0;
+}
+
+static BrainUint
+setup_mask(const BrainUint size)
+{
+    _mask = new_random_mask(size, 0.5);
+
+    return size;
+}
+
+static void
+teardown_mask()
+{
+    delete_random_mask(_mask);
+    _mask = NULL;
+}
+
+static FILE*
+open_bench_file()
+{
+    FILE* file = NULL;
+    BrainInt fd = -1;
+
+    strcpy(_path, "/tmp/brain_core_bench_XXXXXX");
+    fd = mkstemp(_path);
+
+    if (0 <= fd)
+    {
+        file = fdopen(fd, "w");
+        _has_path = BRAIN_TRUE;
+    }
+
+    return file;
+}
+
+static void
+close_bench_file(FILE* file)
+{
+    struct stat status;
+
+    fclose(file);
+
+    _file_size = (stat(_path, &status) == 0) ? (BrainDouble)status.st_size : 0.;
+}
+
+static void
+remove_bench_file()
+{
+    if (_has_path)
+    {
+        unlink(_path);
+        _has_path = BRAIN_FALSE;
+    }
+}
+
+static BrainUint
+setup_csv(const BrainUint size)
+{
+    const BrainUint rows = size / BENCH_DIMENSION;
+    FILE*     file = open_bench_file();
+    BrainUint ret  = 0;
+
+    if (BRAIN_ALLOCATED(file))
+    {
+        BrainRandom random = get_thread_random();
+        BrainUint i = 0, j = 0;
+
+        for (i = 0; i < rows; ++i)
+        {
+            for (j = 0; j < BENCH_DIMENSION; ++j)
+            {
+                fprintf(file, "%s%.6f", (j == 0) ? "" : ",", random_range(random, -1., 1.));
+            }
+
+            fputc('\n', file);
+        }
+
+        close_bench_file(file);
+
+        _reader = new_csv_reader(_path, ",", BENCH_DIMENSION, Format_InputFirst, BRAIN_FALSE);
+        ret     = BRAIN_ALLOCATED(_reader) ? rows * BENCH_DIMENSION : 0;
+    }
+
+    return ret;
+}
+
+static void
+teardown_csv()
+{
+    delete_csv_reader(_reader);
+    _reader = NULL;
+
+    remove_bench_file();
+}
+
+static BrainUint
+setup_xml(const BrainUint size)
+{
+    // an int, a double, a boolean and a string attribute per node
+    const BrainUint nodes = size / 4;
+    FILE*     file = open_bench_file();
+    BrainUint ret  = 0;
+
+    if (BRAIN_ALLOCATED(file))
+    {
+        BrainRandom random = get_thread_random();
+        BrainUint i = 0;
+
+        fprintf(file, "<?xml version=\"1.0\"?>\n<samples>\n");
+
+        for (i = 0; i < nodes; ++i)
+        {
+            fprintf(file, "    <sample index=\"%u\" value=\"%.6f\" enabled=\"%s\" label=\"s%u\"/>\n",
+                    i, random_range(random, -1., 1.), (i % 2) ? "true" : "false", i);
+        }
+
+        fprintf(file, "</samples>\n");
+        close_bench_file(file);
+
+        _document = open_document(_path);
+        ret       = BRAIN_ALLOCATED(_document) ? nodes * 4 : 0;
+    }
+
+    return ret;
+}
+
+static void
+teardown_xml()
+{
+    if (BRAIN_ALLOCATED(_document))
+    {
+        close_document(_document);
+        _document = NULL;
+    }
+
+    remove_bench_file();
+}
+
+/**********************************************************************/
+/**                            KERNELS                               **/
+/**********************************************************************/
+static void
+run_dot(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        _sink += dot(_a, _b, _size);
+    }
+}
+
+static void
+run_distance(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        _sink += distance(_a, _b, _size);
+    }
+}
+
+static void
+run_norm2(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        _sink += norm2(_a, _size);
+    }
+}
+
+static void
+run_find_gaussian(const BrainUint count)
+{
+    BrainReal means[BENCH_DIMENSION];
+    BrainReal sigmas[BENCH_DIMENSION];
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        FindGaussianModel(_signals, means, sigmas, _rows, BENCH_DIMENSION);
+        _sink += means[0];
+    }
+}
+
+static void
+run_apply_gaussian(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        ApplyGaussianModel(_signals, _means, _sigmas, _rows, BENCH_DIMENSION);
+    }
+}
+
+static void
+run_find_minmax(const BrainUint count)
+{
+    BrainReal min[BENCH_DIMENSION];
+    BrainReal max[BENCH_DIMENSION];
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        FindMinMaxModel(_signals, min, max, _rows, BENCH_DIMENSION);
+        _sink += max[0];
+    }
+}
+
+static void
+run_apply_minmax(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        ApplyMinMaxModel(_signals, _min, _max, _rows, BENCH_DIMENSION);
+    }
+}
+
+static void
+run_kmeans(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        kmeans(_signals, _centers, _labels, BENCH_CLASSES, _rows, BENCH_DIMENSION);
+        _sink += _centers[0][0];
+    }
+}
+
+static void
+run_mask(const BrainUint count)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        _sink += generate_random_mask(_mask);
+    }
+}
+
+static void
+accumulate_line(void* data, BrainString label, const BrainReal* signal)
+{
+    *(BrainDouble*)data += signal[0];
+}
+
+static void
+run_csv(const BrainUint count)
+{
+    BrainDouble sum = 0.;
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        csv_reader_load(_reader, accumulate_line, &sum);
+    }
+
+    _sink += sum;
+}
+
+static void
+run_xml(const BrainUint count)
+{
+    const Context root = get_root_node(_document);
+    BrainUint i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        Context node = NULL;
+
+        for (node = root->children; BRAIN_ALLOCATED(node); node = node->next)
+        {
+            if (node->type == XML_ELEMENT_NODE)
+            {
+                Buffer label = node_get_prop(node, "label");
+
+                _sink += node_get_int(node, "index", 0)
+                       + node_get_double(node, "value", 0.)
+                       + node_get_bool(node, "enabled", BRAIN_FALSE);
+
+                if (BRAIN_ALLOCATED(label))
+                {
+                    xmlFree(label);
+                }
+            }
+        }
+    }
+}
+
+static const BenchKernel _kernels[] =
+{
+    {"dot",            2 * sizeof(BrainReal), 0,                setup_vectors, run_dot,            NULL},
+    {"distance",       2 * sizeof(BrainReal), 0,                setup_vectors, run_distance,       NULL},
+    {"norm2",              sizeof(BrainReal), 0,                setup_vectors, run_norm2,          NULL},
+    {"gaussian-find",      sizeof(BrainReal), 0,                setup_signals, run_find_gaussian,  NULL},
+    {"gaussian-apply", 2 * sizeof(BrainReal), 0,                setup_signals, run_apply_gaussian, NULL},
+    {"minmax-find",        sizeof(BrainReal), 0,                setup_signals, run_find_minmax,    NULL},
+    {"minmax-apply",   2 * sizeof(BrainReal), 0,                setup_signals, run_apply_minmax,   NULL},
+    {"kmeans",             sizeof(BrainReal), 0,                setup_kmeans,  run_kmeans,         NULL},
+    {"random-mask",        sizeof(BrainUint), 0,                setup_mask,    run_mask,           teardown_mask},
+    {"csv-load",       0,                     BENCH_MAX_PARSED, setup_csv,     run_csv,            teardown_csv},
+    {"xml-get",        0,                     BENCH_MAX_PARSED, setup_xml,     run_xml,            teardown_xml}
+};
+
+#define BENCH_NUMBER_OF_KERNELS (sizeof(_kernels) / sizeof(_kernels[0]))
+
+/**********************************************************************/
+/**                          MEASURES                                **/
+/**********************************************************************/
+static int
+compare_doubles(const void* a, const void* b)
+{
+    const BrainDouble x = *(const BrainDouble*)a;
+    const BrainDouble y = *(const BrainDouble*)b;
+
+    return (x > y) - (x < y);
+}
+
+static BrainDouble
+get_median(BrainDouble* values, const BrainUint number_of_values)
+{
+    qsort(values, number_of_values, sizeof(BrainDouble), compare_doubles);
+
+    return (number_of_values % 2) ? values[number_of_values / 2]
+                                  : 0.5 * (values[number_of_values / 2 - 1] + values[number_of_values / 2]);
+}
+
+static BrainDouble
+time_kernel(const BenchKernel* kernel, const BrainUint count)
+{
+    const BrainDouble begin = brain_probe_now();
+
+    kernel->_run(count);
+
+    return brain_probe_now() - begin;
+}
+
+static void
+measure(const BenchOptions* options,
+        const BenchKernel* kernel,
+        const BrainUint elements,
+        BenchResult* result)
+{
+    BrainDouble costs[BENCH_MAX_REPEAT];
+    BrainDouble deviations[BENCH_MAX_REPEAT];
+    BrainDouble elapsed = 0.;
+    BrainUint   count = 1;
+    BrainUint   i = 0;
+    /******************************************************************/
+    /**     Warm the caches and find a count lasting the given time  **/
+    /******************************************************************/
+    while ((elapsed = time_kernel(kernel, count)) < 0.25 * options->_time)
+    {
+        count *= 2;
+    }
+
+    count = (BrainUint)((BrainDouble)count * options->_time / elapsed) + 1;
+
+    for (i = 0; i < options->_repeat; ++i)
+    {
+        costs[i] = time_kernel(kernel, count) * 1e9 / ((BrainDouble)count * (BrainDouble)elements);
+    }
+
+    result->_median = get_median(costs, options->_repeat);
+
+    for (i = 0; i < options->_repeat; ++i)
+    {
+        deviations[i] = (costs[i] > result->_median) ? costs[i] - result->_median : result->_median - costs[i];
+    }
+
+    result->_mad = get_median(deviations, options->_repeat);
+}
+
+static void
+report(const BenchOptions* options,
+       const BenchKernel* kernel,
+       const BrainUint size,
+       const BrainUint elements,
+       const BenchResult* result)
+{
+    const BrainDouble bytes = (0 < kernel->_bytes) ? (BrainDouble)kernel->_bytes
+                                                   : _file_size / (BrainDouble)elements;
+    // bytes per nanosecond are GB/s
+    const BrainDouble gbps  = bytes / result->_median;
+
+    printf("%-14s %-7s %10u %12.1f %10.3f %9.3f %-10s %8.2f\n",
+           kernel->_name, get_precision(), size, bytes * (BrainDouble)elements / 1024.,
+           result->_median, result->_mad, "ns/element", gbps);
+
+    if (BRAIN_ALLOCATED(_json))
+    {
+        fprintf(_json,
+                "%s    {\"name\": \"%s/%s/n%u\", \"benchmark\": \"%s\", \"precision\": \"%s\", "
+                "\"size\": %u, \"elements\": %u, \"bytes\": %.6g, \"unit\": \"ns/element\", \"better\": \"lower\", "
+                "\"median\": %.6g, \"mad\": %.6g, \"repeat\": %u, \"gbps\": %.6g}",
+                _first ? "" : ",\n",
+                kernel->_name, get_precision(), size,
+                kernel->_name, get_precision(), size, elements, bytes * (BrainDouble)elements,
+                result->_median, result->_mad, options->_repeat, gbps);
+
+        _first = BRAIN_FALSE;
+    }
+
+    fflush(stdout);
+}
+
+static BrainBool
+is_kernel_selected(const BenchOptions* options, const BenchKernel* kernel)
+{
+    BrainBool ret = (options->_number_of_kernels == 0);
+    BrainUint i = 0;
+
+    for (i = 0; !ret && (i < options->_number_of_kernels); ++i)
+    {
+        ret = !strcmp(options->_kernels[i], kernel->_name);
+    }
+
+    return ret;
+}
+
+static void
+run_size(const BenchOptions* options, const BrainUint size)
+{
+    BenchResult result;
+    BrainUint i = 0;
+
+    for (i = 0; i < BENCH_NUMBER_OF_KERNELS; ++i)
+    {
+        const BenchKernel* kernel = &(_kernels[i]);
+
+        if (is_kernel_selected(options, kernel)
+        &&  ((kernel->_max_size == 0) || (size <= kernel->_max_size)))
+        {
+            const BrainUint elements = kernel->_setup(size);
+
+            if (0 < elements)
+            {
+                measure(options, kernel, elements, &result);
+                report(options, kernel, size, elements, &result);
+            }
+
+            if (BRAIN_ALLOCATED(kernel->_teardown))
+            {
+                kernel->_teardown();
+            }
+        }
+    }
+}
+
+/**********************************************************************/
+/**                          OPTIONS                                 **/
+/**********************************************************************/
+static BrainUint
+get_cache_size(const BrainInt level)
+{
+    // common sizes when the system does not tell
+    static const BrainUint defaults[] = {32 << 10, 1 << 20, 8 << 20};
+    long ret = 0;
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    switch (level)
+    {
+        case 1:  ret = sysconf(_SC_LEVEL1_DCACHE_SIZE); break;
+        case 2:  ret = sysconf(_SC_LEVEL2_CACHE_SIZE);  break;
+        default: ret = sysconf(_SC_LEVEL3_CACHE_SIZE);  break;
+    }
+#endif /* _SC_LEVEL1_DCACHE_SIZE */
+
+    return (0 < ret) ? (BrainUint)ret : defaults[level - 1];
+}
+
+static void
+set_default_sizes(BenchOptions* options)
+{
+    // most kernels read two vectors
+    const BrainUint element = 2 * sizeof(BrainReal);
+    const BrainUint l3      = get_cache_size(3);
+    BrainUint level = 0;
+
+    for (level = 1; level <= 3; ++level)
+    {
+        options->_sizes[level - 1] = get_cache_size(level) / 2 / element;
+    }
+
+    options->_sizes[3] = ((BENCH_MAX_FOOTPRINT / 4 < l3) ? BENCH_MAX_FOOTPRINT : 4 * l3) / element;
+    options->_number_of_sizes = 4;
+}
+
+static BrainUint
+parse_uints(BrainString text, BrainUint* values)
+{
+    BrainUint number_of_values = 0;
+
+    while (BRAIN_ALLOCATED(text)
+    &&     (*text != '\0')
+    &&     (number_of_values < BENCH_MAX_VALUES))
+    {
+        values[number_of_values++] = (BrainUint)strtoul(text, (BrainChar**)&text, 10);
+
+        if (*text == ',')
+        {
+            ++text;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return number_of_values;
+}
+
+static BrainUint
+parse_strings(BrainChar* text, BrainString* values)
+{
+    BrainUint number_of_values = 0;
+    BrainChar* token = strtok(text, ",");
+
+    while (BRAIN_ALLOCATED(token)
+    &&     (number_of_values < BENCH_MAX_VALUES))
+    {
+        values[number_of_values++] = token;
+        token = strtok(NULL, ",");
+    }
+
+    return number_of_values;
+}
+
+static void
+usage(BrainString program)
+{
+    BrainUint i = 0;
+
+    printf("Usage: %s [options]\n"
+           "  --sizes N,...        elements per vector          (half of L1, L2, L3, then 4 x L3)\n"
+           "  --kernels K,...      measured kernels             (all)\n"
+           "  --repeat N           repetitions of each measure  (5)\n"
+           "  --time S             seconds per repetition       (0.1)\n"
+           "  --cpu C              pinned cpu, -1 to disable    (current cpu)\n"
+           "  --json FILE          also write the results as JSON\n"
+           "  --quick              small sizes for smoke tests\n"
+           "Kernels:",
+           program);
+
+    for (i = 0; i < BENCH_NUMBER_OF_KERNELS; ++i)
+    {
+        printf(" %s", _kernels[i]._name);
+    }
+
+    printf("\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    BrainInt  i = 0;
+    BrainUint s = 0, k = 0;
+
+    memset(&options, 0, sizeof(options));
+
+    set_default_sizes(&options);
+    options._repeat = 5;
+    options._time   = 0.1;
+    options._cpu    = sched_getcpu();
+
+    for (i = 1; i < argc; ++i)
+    {
+        const BrainBool has_value = (i + 1 < argc);
+
+        if (!strcmp(argv[i], "--sizes") && has_value)
+        {
+            options._number_of_sizes = parse_uints(argv[++i], options._sizes);
+        }
+        else if (!strcmp(argv[i], "--kernels") && has_value)
+        {
+            options._number_of_kernels = parse_strings(argv[++i], options._kernels);
+        }
+        else if (!strcmp(argv[i], "--repeat") && has_value)
+        {
+            options._repeat = (BrainUint)atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--time") && has_value)
+        {
+            options._time = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--cpu") && has_value)
+        {
+            options._cpu = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--json") && has_value)
+        {
+            options._json = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--quick"))
+        {
+            options._number_of_sizes = parse_uints("1024,65536", options._sizes);
+            options._repeat = 3;
+            options._time   = 0.02;
+        }
+        else
+        {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+    }
+
+    options._repeat = (options._repeat < 1) ? 1 : ((BENCH_MAX_REPEAT < options._repeat) ? BENCH_MAX_REPEAT : options._repeat);
+
+    for (k = 0; k < options._number_of_kernels; ++k)
+    {
+        for (s = 0; s < BENCH_NUMBER_OF_KERNELS; ++s)
+        {
+            if (!strcmp(options._kernels[k], _kernels[s]._name))
+            {
+                break;
+            }
+        }
+
+        if (s == BENCH_NUMBER_OF_KERNELS)
+        {
+            fprintf(stderr, "Unknown kernel %s\n", options._kernels[k]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the threads of the parallel kernels are pinned on the same cpu
+    if (0 <= options._cpu)
+    {
+        cpu_set_t cpus;
+
+        CPU_ZERO(&cpus);
+        CPU_SET(options._cpu, &cpus);
+
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+        {
+            fprintf(stderr, "Unable to pin the benchmark on cpu %d\n", options._cpu);
+        }
+    }
+
+    if (BRAIN_ALLOCATED(options._json))
+    {
+        _json = fopen(options._json, "w");
+
+        if (BRAIN_ALLOCATED(_json))
+        {
+            fprintf(_json, "{\n  \"precision\": \"%s\",\n  \"cpu\": %d,\n"
+                           "  \"caches\": {\"l1\": %u, \"l2\": %u, \"l3\": %u},\n  \"results\": [\n",
+                    get_precision(), options._cpu, get_cache_size(1), get_cache_size(2), get_cache_size(3));
+        }
+        else
+        {
+            fprintf(stderr, "Unable to write %s\n", options._json);
+            return EXIT_FAILURE;
+        }
+    }
+
+    set_random_seed(42);
+
+    printf("%-14s %-7s %10s %12s %10s %9s %-10s %8s\n",
+           "kernel", "real", "size", "bytes(KiB)", "median", "mad", "unit", "GB/s");
+
+    for (s = 0; s < options._number_of_sizes; ++s)
+    {
+        run_size(&options, options._sizes[s]);
+    }
+
+    if (BRAIN_ALLOCATED(_json))
+    {
+        fprintf(_json, "\n  ]\n}\n");
+        fclose(_json);
+    }
+
+    if (BRAIN_ALLOCATED(_centers))
+    {
+        for (k = 0; k < BENCH_CLASSES; ++k)
+        {
+            BRAIN_DELETE(_centers[k]);
+        }
+
+        BRAIN_DELETE(_centers);
+    }
+
+    BRAIN_DELETE(_a);
+    BRAIN_DELETE(_b);
+    BRAIN_DELETE(_signals);
+    BRAIN_DELETE(_labels);
+
+    return EXIT_SUCCESS;
+}
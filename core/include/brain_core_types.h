@@ -30,6 +30,7 @@
 typedef unsigned char BrainBool;
 typedef int           BrainInt;
 typedef unsigned int  BrainUint;
+typedef unsigned long long BrainUlong;
 typedef float         BrainFloat;
 typedef double        BrainDouble;
 typedef const char*   BrainString;
@@ -60,6 +61,18 @@ typedef enum DataPreprocessing
     Preprocessing_First = Preprocessing_GaussianNormalization,
     Preprocessing_Last  = Preprocessing_Invalide
 } DataPreprocessing;
+/**
+ * \brief Define how training samples are drawn
+ */
+typedef enum DataSampling
+{
+    Sampling_Random,
+    Sampling_Shuffle,
+    Sampling_BlockShuffle,
+    Sampling_Invalide,
+    Sampling_First = Sampling_Random,
+    Sampling_Last  = Sampling_Invalide
+} DataSampling;
 /**
  * \brief define a DataFormat
  */
@@ -109,10 +122,46 @@ typedef xmlTextWriterPtr Writer;
  * \brief Define a BrainRandomMask
  */
 typedef struct RandomMask* BrainRandomMask;
+/**
+ * \brief Define a Random generator
+ */
+typedef struct Random* BrainRandom;
 /**
  * \brief Define a CsvReader
  */
 typedef struct CsvReader* BrainCsvReader;
+/**
+ * \brief Define a DataStream
+ */
+typedef struct DataStream* BrainDataStream;
+/**
+ * \brief Define a BatchLoader
+ */
+typedef struct BatchLoader* BrainBatchLoader;
+/**
+ * \brief Define a LabelDictionary
+ */
+typedef struct LabelDictionary* BrainLabelDictionary;
+/**
+ * \brief Define a SignalStatistics
+ */
+typedef struct SignalStatistics* BrainSignalStatistics;
+/**
+ * \brief Define a KMeans
+ */
+typedef struct KMeans* BrainKMeans;
+/**
+ * \brief Define a group of hardware Counters
+ */
+typedef struct Counters* BrainCounters;
+/**
+ * \brief Define the MemoryUsage of an object
+ */
+typedef struct MemoryUsage* BrainMemoryUsage;
+/**
+ * \brief Define a MemoryArena, blocks carved out of a single allocation
+ */
+typedef struct MemoryArena* BrainMemoryArena;
 /**
 * \brief Define a BrainSignal using single or double precision
 */
@@ -122,9 +171,24 @@ typedef BrainReal* BrainSignal;
  */
 typedef struct Network* BrainNetwork;
 /**
- * \brief Define a BrainWeight
+ * \brief Define a BrainOptimizer
+ */
+typedef struct Optimizer* BrainOptimizer;
+/**
+ * \brief Define how weights are updated from their gradients
  */
-typedef struct Weight* BrainWeight;
+typedef enum OptimizerType
+{
+    Optimizer_SGD,
+    Optimizer_Momentum,
+    Optimizer_Nesterov,
+    Optimizer_AdaGrad,
+    Optimizer_RMSProp,
+    Optimizer_Adam,
+    Optimizer_Invalide,
+    Optimizer_First = Optimizer_SGD,
+    Optimizer_Last  = Optimizer_Invalide
+} OptimizerType;
 /**
  * \brief Define a BrainData
  */
@@ -133,6 +197,15 @@ typedef struct Data* BrainData;
  * \brief function pointer on an activation function
  */
 typedef BrainReal (*BrainActivationFunction)(const BrainReal value);
+/**
+ * \brief function pointer computing loss * A'(x) for a whole layer from its
+ * outputs A(x) * scale
+ */
+typedef void (*BrainGradientFunction)(const BrainReal* outputs,
+                                      const BrainReal* losses,
+                                      const BrainReal  scale,
+                                      BrainReal*       gradients,
+                                      const BrainUint  number_of_outputs);
 /**
  * \brief function pointer on an cost function
  */
@@ -0,0 +1,74 @@
+/**
+ * \file brain_counter_utils.h
+ * \brief Define the API to read the hardware performance counters
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Counters are opened with perf_event_open as a single group, so they are
+ * read with one system call and always cover the same instructions. They
+ * only count the user space of the thread that reads them; the group is
+ * reopened when another thread starts reading.
+ *
+ * Counters are often unavailable, on other systems than Linux, in
+ * containers or when perf_event_paranoid forbids them. Unavailable counters
+ * simply stay at zero, check is_counter_available before reporting them.
+ */
+#ifndef BRAIN_COUNTER_UTILS_H
+#define BRAIN_COUNTER_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \enum BrainCounterType
+ * \brief the measured hardware events
+ */
+typedef enum BrainCounterType
+{
+    Counter_Cycles,        /*!< CPU cycles                 */
+    Counter_Instructions,  /*!< Retired instructions       */
+    Counter_L1_Misses,     /*!< L1 data cache read misses  */
+    Counter_LLC_Misses,    /*!< Last level cache misses    */
+    Counter_Branch_Misses, /*!< Mispredicted branches      */
+    Counter_Last
+} BrainCounterType;
+
+/**
+ * \fn BrainCounters new_counters()
+ * \brief open the counters for the calling thread
+ *
+ * \return a BrainCounters, even if no counter is available
+ */
+BrainCounters new_counters();
+/**
+ * \fn void delete_counters(BrainCounters counters)
+ * \brief close the counters
+ *
+ * \param counters a BrainCounters
+ */
+void delete_counters(BrainCounters counters);
+/**
+ * \fn BrainBool is_counter_available(const BrainCounters counters, const BrainCounterType type)
+ * \brief check if a counter is measured by the last thread
+ *
+ * \param counters a BrainCounters
+ * \param type     a counter
+ * \return BRAIN_TRUE if the counter is measured
+ */
+BrainBool is_counter_available(const BrainCounters counters, const BrainCounterType type);
+/**
+ * \fn void start_counters(BrainCounters counters)
+ * \brief start a measured region
+ *
+ * \param counters a BrainCounters, may be NULL
+ */
+void start_counters(BrainCounters counters);
+/**
+ * \fn void stop_counters(BrainCounters counters, BrainUlong* values)
+ * \brief end a measured region and add its counts
+ *
+ * \param counters a BrainCounters, may be NULL
+ * \param values   Counter_Last counts to increase
+ */
+void stop_counters(BrainCounters counters, BrainUlong* values);
+
+#endif /* BRAIN_COUNTER_UTILS_H */
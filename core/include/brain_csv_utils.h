@@ -13,5 +13,42 @@ BrainCsvReader new_csv_reader(  BrainString path,
 
 void delete_csv_reader(BrainCsvReader reader);
 
+void accumulate_csv_reader_memory(const BrainCsvReader reader, BrainMemoryUsage usage);
+
 void csv_reader_load(BrainCsvReader reader, CsvLineCbk cbk, void* data);
+/**
+ * \fn BrainBool csv_reader_open(BrainCsvReader reader)
+ * \brief open the CSV file to read it line by line
+ *
+ * \param reader a BrainCsvReader
+ * \return BRAIN_TRUE if the file has been opened
+ */
+BrainBool csv_reader_open(BrainCsvReader reader);
+/**
+ * \fn BrainBool csv_reader_next(BrainCsvReader reader, BrainString* label, const BrainReal** signal)
+ * \brief parse the next line of an opened CSV file
+ *
+ * The label and the signal are owned by the reader and are only valid
+ * until the next call
+ *
+ * \param reader a BrainCsvReader
+ * \param label  the parsed label or NULL if the data are not labelled
+ * \param signal the parsed signal
+ * \return BRAIN_FALSE at the end of the file
+ */
+BrainBool csv_reader_next(BrainCsvReader reader, BrainString* label, const BrainReal** signal);
+/**
+ * \fn void csv_reader_rewind(BrainCsvReader reader)
+ * \brief go back to the first line of an opened CSV file
+ *
+ * \param reader a BrainCsvReader
+ */
+void csv_reader_rewind(BrainCsvReader reader);
+/**
+ * \fn void csv_reader_close(BrainCsvReader reader)
+ * \brief close the CSV file
+ *
+ * \param reader a BrainCsvReader
+ */
+void csv_reader_close(BrainCsvReader reader);
 #endif /* BRAIN_CSV_UTILS_H */
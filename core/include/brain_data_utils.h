@@ -46,6 +46,9 @@ BrainSignal get_evaluating_input_signal(const BrainData data, const BrainUint in
  * \fn BrainSignal get_evaluating_output_signal(const BrainData data, const BrainUint index);
  * \brief get the output signal
  *
+ * Labelled data only store a class index per signal: the returned
+ * one-hot signal is shared and only valid until the next call
+ *
  * \param data a BrainData
  * \param index Index of the output signal
  * \return a BrainSignal
@@ -72,11 +75,50 @@ BrainSignal get_training_input_signal(const BrainData data, const BrainUint inde
  * \fn BrainSignal get_training_output_signal(const BrainData data, const BrainUint index);
  * \brief get the output signal
  *
+ * Labelled data only store a class index per signal: the returned
+ * one-hot signal is shared and only valid until the next call
+ *
  * \param data a BrainData
  * \param index Index of the output signal
  * \return a BrainSignal
  */
 BrainSignal get_training_output_signal(const BrainData data, const BrainUint index);
+/**
+ * \fn BrainBool get_next_training_sample(BrainData data, BrainSignal* input, BrainSignal* output)
+ * \brief get the next training sample
+ *
+ * When the data are streamed or labelled the returned signals are only
+ * valid until the next call
+ *
+ * \param data a BrainData
+ * \param input the input signal
+ * \param output the output signal
+ * \return BRAIN_FALSE if there is no training sample
+ */
+BrainBool get_next_training_sample(BrainData data, BrainSignal* input, BrainSignal* output);
+/**
+ * \fn void set_data_sampling(BrainData data, BrainString sampling, const BrainUint block_size)
+ * \brief choose how get_next_training_sample draws the training samples
+ *
+ * "Random" draws each sample independently. "Shuffle", the default,
+ * walks a permutation of all training samples drawn again at each epoch.
+ * "BlockShuffle" walks blocks of neighbour rows in a random order, and
+ * the rows of a block in a random order, to keep the memory accesses
+ * local. Streamed data are not affected.
+ *
+ * \param data       a BrainData
+ * \param sampling   the sampling name
+ * \param block_size rows per block of "BlockShuffle", 0 for the default
+ */
+void set_data_sampling(BrainData data, BrainString sampling, const BrainUint block_size);
+/**
+ * \fn BrainUint get_data_epoch(const BrainData data)
+ * \brief get the number of completed passes over the training samples
+ *
+ * \param data a BrainData
+ * \return the number of epochs
+ */
+BrainUint get_data_epoch(const BrainData data);
 /**
  * \fn void delete_data(const BrainData data);
  * \brief delete a data
@@ -84,6 +126,14 @@ BrainSignal get_training_output_signal(const BrainData data, const BrainUint ind
  * \param data A BrainData
  */
 void        delete_data(BrainData data);
+/**
+ * \fn void accumulate_data_memory(const BrainData data, BrainMemoryUsage usage)
+ * \brief add the rows, views, labels and stream of a data to a memory usage
+ *
+ * \param data  a BrainData
+ * \param usage the BrainMemoryUsage to increase
+ */
+void        accumulate_data_memory(const BrainData data, BrainMemoryUsage usage);
 /**
  * \fn BrainUint get_input_signal_length(const BrainData data)
  * \brief get all input signal size
@@ -100,5 +150,76 @@ BrainUint get_input_signal_length(const BrainData data);
  * \return size of all output signal
  */
 BrainUint get_output_signal_length(const BrainData data);
+/**
+ * \fn BrainLabelDictionary get_data_labels(const BrainData data)
+ * \brief get the labels of a labelled data
+ *
+ * The id of a label is the index of its output
+ *
+ * \param data a BrainData
+ * \return the BrainLabelDictionary or NULL if data are not labelled
+ */
+BrainLabelDictionary get_data_labels(const BrainData data);
+/**
+ * \fn BrainReal get_data_training_ratio(const BrainData data)
+ * \brief get the ratio of training signals
+ *
+ * \param data a BrainData
+ * \return the ratio of training signals
+ */
+BrainReal get_data_training_ratio(const BrainData data);
+/**
+ * \fn BrainBool is_data_streamed(const BrainData data)
+ * \brief check if the training signals are streamed from the disk
+ *
+ * \param data a BrainData
+ * \return BRAIN_TRUE if the training signals are streamed
+ */
+BrainBool is_data_streamed(const BrainData data);
+/**
+ * \fn BrainSignal get_data_preprocessing_scales(const BrainData data)
+ * \brief get the scales of the composed preprocessing
+ *
+ * All preprocessings of a data are composed in a single affine model,
+ * a raw input x is normalized into x * scale + shift
+ *
+ * \param data a BrainData
+ * \return one scale per input or NULL if inputs are not preprocessed
+ */
+BrainSignal get_data_preprocessing_scales(const BrainData data);
+/**
+ * \fn BrainSignal get_data_preprocessing_shifts(const BrainData data)
+ * \brief get the shifts of the composed preprocessing
+ *
+ * \param data a BrainData
+ * \return one shift per input or NULL if inputs are not preprocessed
+ */
+BrainSignal get_data_preprocessing_shifts(const BrainData data);
+/**
+ * \fn void split_data(BrainData data, const BrainReal training_ratio)
+ * \brief shuffle the loaded signals and split them again
+ *
+ * Signals are not copied, the training and evaluating datasets are views
+ * over the same rows. Preprocessing models are fitted again on the new
+ * training signals. A streamed data can not be split again.
+ *
+ * \param data           a BrainData
+ * \param training_ratio ratio of training signals
+ */
+void split_data(BrainData data, const BrainReal training_ratio);
+/**
+ * \fn BrainBool select_data_fold(BrainData data, const BrainUint number_of_folds, const BrainUint fold)
+ * \brief use a fold of a k-fold cross-validation as evaluating signals
+ *
+ * The folds are slices of the order set by the last shuffle, so looping
+ * over all folds evaluates each signal exactly once.
+ * More folds than rows are refused, the views are then left unchanged.
+ *
+ * \param data            a BrainData
+ * \param number_of_folds number of folds
+ * \param fold            index of the evaluating fold
+ * \return BRAIN_TRUE if the fold has been selected
+ */
+BrainBool select_data_fold(BrainData data, const BrainUint number_of_folds, const BrainUint fold);
 
 #endif /* BRAIN_DATA_H */
@@ -2,7 +2,9 @@
 #define BRAIN_FUNCTION_UTILS_H
 
 BrainActivationFunction brain_activation_function(BrainString name);
+BrainActivationFunction brain_fast_activation_function(BrainString name);
 BrainActivationFunction brain_derivative_function(BrainString name);
+BrainGradientFunction brain_gradient_function(BrainString name);
 BrainCostFunction brain_cost_function(BrainString name);
 BrainCostFunction brain_derivative_cost_function(BrainString name);
 
@@ -0,0 +1,138 @@
+/**
+ * \file brain_kmeans_utils.h
+ * \brief Define the API to cluster signals with k-means
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Centers are seeded with k-means++ and refined with Lloyd iterations.
+ * Hamerly bounds skip most of the point to center distances, the others
+ * are computed by blocks of signals against all centers. Iterations run
+ * on several threads, see brain_thread_utils.h.
+ *
+ * Data larger than the memory are clustered by minibatches, each center
+ * being the running mean of the signals it has been given.
+ */
+#ifndef BRAIN_KMEANS_UTILS_H
+#define BRAIN_KMEANS_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \fn BrainKMeans new_kmeans(const BrainUint number_of_clusters, const BrainUint size)
+ * \brief create a k-means model
+ *
+ * \param number_of_clusters the number of clusters
+ * \param size               the signal length
+ * \return a BrainKMeans
+ */
+BrainKMeans new_kmeans(const BrainUint number_of_clusters, const BrainUint size);
+/**
+ * \fn void delete_kmeans(BrainKMeans kmeans)
+ * \brief delete a k-means model
+ *
+ * \param kmeans a BrainKMeans
+ */
+void delete_kmeans(BrainKMeans kmeans);
+/**
+ * \fn void configure_kmeans(BrainKMeans kmeans, const BrainUint max_iterations, const BrainReal tolerance)
+ * \brief set the stopping criteria of fit_kmeans
+ *
+ * Iterations stop when no signal changes of cluster, or when the squared
+ * center movements sum to less than tolerance times the mean variance of
+ * the signal components.
+ *
+ * \param kmeans         a BrainKMeans
+ * \param max_iterations maximum number of Lloyd iterations
+ * \param tolerance      relative convergence tolerance
+ */
+void configure_kmeans(BrainKMeans kmeans,
+                      const BrainUint max_iterations,
+                      const BrainReal tolerance);
+/**
+ * \fn BrainUint fit_kmeans(BrainKMeans kmeans, BrainReal** signals, const BrainUint number_of_signals, BrainUint* labels)
+ * \brief seed and fit all centers on some signals
+ *
+ * \param kmeans            a BrainKMeans
+ * \param signals           the signals to cluster
+ * \param number_of_signals the number of signals, at least the number of clusters
+ * \param labels            the cluster of each signal, may be NULL
+ * \return the number of iterations
+ */
+BrainUint fit_kmeans(BrainKMeans kmeans,
+                     BrainReal** signals,
+                     const BrainUint number_of_signals,
+                     BrainUint* labels);
+/**
+ * \fn void partial_fit_kmeans(BrainKMeans kmeans, BrainReal** signals, const BrainUint number_of_signals)
+ * \brief update the centers with a minibatch of signals
+ *
+ * Each signal moves its closest center with a learning rate of one over
+ * the number of signals this center has been given (Sculley). Centers
+ * are seeded with k-means++ on the first minibatch, which must contain
+ * at least as many signals as clusters. The inertia is the one of the
+ * minibatch.
+ *
+ * \param kmeans            a BrainKMeans
+ * \param signals           the minibatch
+ * \param number_of_signals the number of signals
+ */
+void partial_fit_kmeans(BrainKMeans kmeans,
+                        BrainReal** signals,
+                        const BrainUint number_of_signals);
+/**
+ * \fn void partial_fit_kmeans_with_data(BrainKMeans kmeans, BrainData data, const BrainUint batch_size, const BrainUint number_of_batches)
+ * \brief update the centers with minibatches of training input signals
+ *
+ * Minibatches are read from get_next_training_sample by a loader thread,
+ * so only a few of them are in memory whatever the data size. Streamed
+ * data are read from the disk.
+ *
+ * \param kmeans            a BrainKMeans
+ * \param data              a BrainData with the same input length
+ * \param batch_size        number of signals per minibatch
+ * \param number_of_batches number of minibatches
+ */
+void partial_fit_kmeans_with_data(BrainKMeans kmeans,
+                                  BrainData data,
+                                  const BrainUint batch_size,
+                                  const BrainUint number_of_batches);
+/**
+ * \fn void predict_kmeans(const BrainKMeans kmeans, BrainReal** signals, const BrainUint number_of_signals, BrainUint* labels)
+ * \brief find the closest center of some signals
+ *
+ * \param kmeans            a BrainKMeans
+ * \param signals           the signals
+ * \param number_of_signals the number of signals
+ * \param labels            the closest center of each signal
+ */
+void predict_kmeans(const BrainKMeans kmeans,
+                    BrainReal** signals,
+                    const BrainUint number_of_signals,
+                    BrainUint* labels);
+/**
+ * \fn BrainUint get_kmeans_number_of_cluster(const BrainKMeans kmeans)
+ * \brief get the number of clusters
+ *
+ * \param kmeans a BrainKMeans
+ * \return the number of clusters
+ */
+BrainUint get_kmeans_number_of_cluster(const BrainKMeans kmeans);
+/**
+ * \fn BrainSignal get_kmeans_center(const BrainKMeans kmeans, const BrainUint cluster)
+ * \brief get the center of a cluster
+ *
+ * \param kmeans  a BrainKMeans
+ * \param cluster the cluster index
+ * \return the center or NULL
+ */
+BrainSignal get_kmeans_center(const BrainKMeans kmeans, const BrainUint cluster);
+/**
+ * \fn BrainReal get_kmeans_inertia(const BrainKMeans kmeans)
+ * \brief get the sum of squared distances of the fitted signals to their center
+ *
+ * \param kmeans a BrainKMeans
+ * \return the inertia of the last fit
+ */
+BrainReal get_kmeans_inertia(const BrainKMeans kmeans);
+
+#endif /* BRAIN_KMEANS_UTILS_H */
@@ -0,0 +1,119 @@
+/**
+ * \file brain_label_utils.h
+ * \brief Define the API to intern dataset labels
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * A LabelDictionary maps each distinct label to a stable id, which is
+ * the index of the output neuron representing this label. Ids are given
+ * in order of first appearance and never change, so a dictionary can be
+ * saved with the data or the model and restored later.
+ */
+#ifndef BRAIN_LABEL_UTILS_H
+#define BRAIN_LABEL_UTILS_H
+
+#include <stdio.h>
+#include "brain_core_types.h"
+
+/**
+ * \fn BrainLabelDictionary new_label_dictionary()
+ * \brief create an empty dictionary
+ *
+ * \return a BrainLabelDictionary
+ */
+BrainLabelDictionary new_label_dictionary();
+/**
+ * \fn void delete_label_dictionary(BrainLabelDictionary dictionary)
+ * \brief delete a dictionary and all its labels
+ *
+ * \param dictionary a BrainLabelDictionary
+ */
+void delete_label_dictionary(BrainLabelDictionary dictionary);
+/**
+ * \fn void accumulate_label_dictionary_memory(const BrainLabelDictionary dictionary, BrainMemoryUsage usage)
+ * \brief add the blocks of a dictionary to a memory usage
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param usage      the BrainMemoryUsage to increase
+ */
+void accumulate_label_dictionary_memory(const BrainLabelDictionary dictionary, BrainMemoryUsage usage);
+/**
+ * \fn BrainUint label_dictionary_intern(BrainLabelDictionary dictionary, BrainString label)
+ * \brief get the id of a label, adding it if it is unknown
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param label      the label
+ * \return the label id
+ */
+BrainUint label_dictionary_intern(BrainLabelDictionary dictionary, BrainString label);
+/**
+ * \fn BrainBool label_dictionary_find(const BrainLabelDictionary dictionary, BrainString label, BrainUint* id)
+ * \brief get the id of a known label
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param label      the label
+ * \param id         the label id
+ * \return BRAIN_FALSE if the label is unknown
+ */
+BrainBool label_dictionary_find(const BrainLabelDictionary dictionary, BrainString label, BrainUint* id);
+/**
+ * \fn BrainUint get_label_dictionary_size(const BrainLabelDictionary dictionary)
+ * \brief get the number of labels
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \return the number of labels
+ */
+BrainUint get_label_dictionary_size(const BrainLabelDictionary dictionary);
+/**
+ * \fn BrainString get_label_dictionary_label(const BrainLabelDictionary dictionary, const BrainUint id)
+ * \brief get a label from its id
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param id         the label id
+ * \return the label or NULL
+ */
+BrainString get_label_dictionary_label(const BrainLabelDictionary dictionary, const BrainUint id);
+/**
+ * \fn void copy_label_dictionary(const BrainLabelDictionary src, BrainLabelDictionary dst)
+ * \brief replace the content of dst by the content of src
+ *
+ * \param src the source BrainLabelDictionary
+ * \param dst the destination BrainLabelDictionary
+ */
+void copy_label_dictionary(const BrainLabelDictionary src, BrainLabelDictionary dst);
+/**
+ * \fn void serialize_label_dictionary(const BrainLabelDictionary dictionary, Writer writer)
+ * \brief write all labels as label elements, in id order
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param writer     the XML writer
+ */
+void serialize_label_dictionary(const BrainLabelDictionary dictionary, Writer writer);
+/**
+ * \fn void deserialize_label_dictionary(BrainLabelDictionary dictionary, Context context)
+ * \brief intern all label elements of an XML node, in document order
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param context    the XML node
+ */
+void deserialize_label_dictionary(BrainLabelDictionary dictionary, Context context);
+/**
+ * \fn BrainBool write_label_dictionary(const BrainLabelDictionary dictionary, FILE* file)
+ * \brief write all labels in a binary file
+ *
+ * \param dictionary a BrainLabelDictionary
+ * \param file       an opened binary file
+ * \return BRAIN_TRUE if all labels have been written
+ */
+BrainBool write_label_dictionary(const BrainLabelDictionary dictionary, FILE* file);
+/**
+ * \fn BrainBool read_label_dictionary(BrainLabelDictionary dictionary, FILE* file)
+ * \brief read the labels written by write_label_dictionary
+ *
+ * \param dictionary an empty BrainLabelDictionary
+ * \param file       an opened binary file
+ * \return BRAIN_TRUE if all labels have been read
+ */
+BrainBool read_label_dictionary(BrainLabelDictionary dictionary, FILE* file);
+
+#endif /* BRAIN_LABEL_UTILS_H */
@@ -0,0 +1,76 @@
+/**
+ * \file brain_loader_utils.h
+ * \brief Define the API to prefetch training minibatches
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * A BatchLoader owns a thread that gathers the next minibatches of a
+ * BrainData into preallocated contiguous buffers, while the trainer
+ * consumes the ready ones.
+ */
+#ifndef BRAIN_LOADER_UTILS_H
+#define BRAIN_LOADER_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \fn BrainBatchLoader new_batch_loader(BrainData data, const BrainUint batch_size, const BrainUint number_of_batches)
+ * \brief create a loader and start its thread
+ *
+ * \param data              the BrainData to read
+ * \param batch_size        number of samples per minibatch
+ * \param number_of_batches number of minibatches prefetched in the ring
+ * \return a BrainBatchLoader
+ */
+BrainBatchLoader new_batch_loader(BrainData data,
+                                  const BrainUint batch_size,
+                                  const BrainUint number_of_batches);
+/**
+ * \fn void delete_batch_loader(BrainBatchLoader loader)
+ * \brief stop the loader thread and free all buffers
+ *
+ * \param loader a BrainBatchLoader
+ */
+void delete_batch_loader(BrainBatchLoader loader);
+/**
+ * \fn void accumulate_batch_loader_memory(const BrainBatchLoader loader, BrainMemoryUsage usage)
+ * \brief add the minibatch buffers of a loader to a memory usage
+ *
+ * The data read by the loader is not accounted.
+ *
+ * \param loader a BrainBatchLoader
+ * \param usage  the BrainMemoryUsage to increase
+ */
+void accumulate_batch_loader_memory(const BrainBatchLoader loader, BrainMemoryUsage usage);
+/**
+ * \fn BrainUint batch_loader_acquire(BrainBatchLoader loader, BrainSignal* inputs, BrainSignal* outputs)
+ * \brief wait for the next ready minibatch
+ *
+ * Signals are stored row after row. The minibatch belongs to the
+ * consumer until batch_loader_release is called.
+ *
+ * \param loader  a BrainBatchLoader
+ * \param inputs  contiguous input signals
+ * \param outputs contiguous output signals
+ * \return the number of samples in the minibatch, 0 if there is no sample
+ */
+BrainUint batch_loader_acquire(BrainBatchLoader loader,
+                               BrainSignal* inputs,
+                               BrainSignal* outputs);
+/**
+ * \fn void batch_loader_release(BrainBatchLoader loader)
+ * \brief give the acquired minibatch back to the loader thread
+ *
+ * \param loader a BrainBatchLoader
+ */
+void batch_loader_release(BrainBatchLoader loader);
+/**
+ * \fn BrainUint get_batch_loader_batch_size(const BrainBatchLoader loader)
+ * \brief get the number of samples per minibatch
+ *
+ * \param loader a BrainBatchLoader
+ * \return the minibatch size
+ */
+BrainUint get_batch_loader_batch_size(const BrainBatchLoader loader);
+
+#endif /* BRAIN_LOADER_UTILS_H */
@@ -2,9 +2,11 @@
 #define BRAIN_LOGGING_UTILS_H
 
 #include "brain_core_types.h"
+#include "brain_trace_utils.h"
 
-#define BRAIN_INPUT(func)   BRAIN_DEBUG(">>>> Brain ENTERING:\t%s", #func);
-#define BRAIN_OUTPUT(func)  BRAIN_DEBUG("<<<< Brain LEAVING:\t%s", #func);
+// compiled out unless BRAIN_ENABLE_TRACING, see brain_trace_utils.h
+#define BRAIN_INPUT(func)   BRAIN_TRACE_BEGIN(func)
+#define BRAIN_OUTPUT(func)  BRAIN_TRACE_END(func)
 
 void brain_logging_init();
 
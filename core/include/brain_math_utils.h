@@ -38,6 +38,20 @@ BrainReal softplus(const BrainReal value);
 BrainReal sinusoid(const BrainReal value);
 BrainReal relu(const BrainReal value);
 /**********************************************************************/
+/**                     FAST ACTIVATION FUNCTIONS                    **/
+/**                                                                  **/
+/**  Linear interpolation of tables built by                         **/
+/**  initialize_fast_activations, which must be called first. The    **/
+/**  absolute error to the libm versions is below 1e-4 in single     **/
+/**  precision: 2.4e-5 for tanh, 1.2e-5 for the sigmoid, 8e-6 for   **/
+/**  the softplus and 1.5e-6 for arctan                              **/
+/**********************************************************************/
+void      initialize_fast_activations();
+BrainReal fast_sigmoid(const BrainReal value);
+BrainReal fast_tangeant_hyperbolic(const BrainReal value);
+BrainReal fast_co_tangeant(const BrainReal value);
+BrainReal fast_softplus(const BrainReal value);
+/**********************************************************************/
 /**                        DERIVATIVE FUNCTIONS                      **/
 /**********************************************************************/
 BrainReal identity_derivative(const BrainReal value);
@@ -48,6 +62,14 @@ BrainReal softplus_derivative(const BrainReal value);
 BrainReal sinusoid_derivative(const BrainReal value);
 BrainReal relu_derivative(const BrainReal value);
 /**********************************************************************/
+/**                         GRADIENT FUNCTIONS                       **/
+/**********************************************************************/
+void identity_gradient(const BrainReal* outputs, const BrainReal* losses, const BrainReal scale, BrainReal* gradients, const BrainUint number_of_outputs);
+void sigmoid_gradient(const BrainReal* outputs, const BrainReal* losses, const BrainReal scale, BrainReal* gradients, const BrainUint number_of_outputs);
+void tangeant_hyperbolic_gradient(const BrainReal* outputs, const BrainReal* losses, const BrainReal scale, BrainReal* gradients, const BrainUint number_of_outputs);
+void softplus_gradient(const BrainReal* outputs, const BrainReal* losses, const BrainReal scale, BrainReal* gradients, const BrainUint number_of_outputs);
+void relu_gradient(const BrainReal* outputs, const BrainReal* losses, const BrainReal scale, BrainReal* gradients, const BrainUint number_of_outputs);
+/**********************************************************************/
 /**                           COST FUNCTIONS                         **/
 /**********************************************************************/
 BrainReal quadratic_cost(const BrainReal output, const BrainReal desired);
@@ -1,15 +1,235 @@
+/**
+ * \file brain_memory_utils.h
+ * \brief Define the allocation macros and the memory accounting API
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Every allocation of the library goes through these macros. A block is
+ * preceded by a small header holding its size and its tag, so that the
+ * live bytes, the peak bytes and the number of allocations are tracked per
+ * subsystem, and so that an object can sum the blocks it owns.
+ *
+ * Weights and activations blocks start on a BRAIN_MEMORY_ALIGNMENT boundary
+ * and their size is rounded up to it, the padding being zeroed, so that
+ * vector kernels may load whole aligned vectors up to the end of a buffer.
+ *
+ * The memory itself comes from a BrainAllocator, malloc and friends by
+ * default, which a host application may replace before the first
+ * allocation.
+ *
+ * A block allocated by these macros must be released by BRAIN_DELETE, and
+ * BRAIN_DELETE only releases blocks allocated by these macros.
+ *
+ * Objects of a known size may also be carved out of a BrainMemoryArena, a
+ * single allocation sized beforehand with get_memory_arena_footprint. A
+ * carved block is used, accounted, resized and deleted like any other one,
+ * but deleting it does not call the allocator: the arena is given back in
+ * one release once it is closed and all its blocks are deleted.
+ */
 #ifndef BRAIN_MEMORY_UTILS_H
 #define BRAIN_MEMORY_UTILS_H
 #include <string.h>
 #include <stdlib.h>
+#include "brain_core_types.h"
+
+/**
+ * \def BRAIN_MEMORY_ALIGNMENT
+ * \brief alignment and padding in bytes of the weights and activations, a
+ * cache line and an AVX-512 vector
+ */
+#define BRAIN_MEMORY_ALIGNMENT 64
+
+/**
+ * \enum BrainMemoryTag
+ * \brief the subsystem an allocation is accounted to
+ */
+typedef enum BrainMemoryTag
+{
+    Memory_Other,       /*!< Structures and work buffers               */
+    Memory_Weights,     /*!< Weights, gradients and optimizer state    */
+    Memory_Activations, /*!< Signals flowing through the network       */
+    Memory_Dataset,     /*!< Rows, batches and views of the data       */
+    Memory_Labels,      /*!< Label dictionaries and classes of rows    */
+    Memory_XML,         /*!< libxml2 documents, see brain_memory_track_xml */
+    Memory_Last
+} BrainMemoryTag;
+
+/**
+ * \brief Struct MemoryStats, allocations of the whole process
+ */
+typedef struct MemoryStats
+{
+    BrainUlong live_bytes[Memory_Last];  /*!< Allocated bytes               */
+    BrainUlong peak_bytes[Memory_Last];  /*!< Highest allocated bytes       */
+    BrainUlong allocations[Memory_Last]; /*!< Allocations since the start   */
+    BrainUlong frees[Memory_Last];       /*!< Releases since the start      */
+    BrainUlong total_live_bytes;         /*!< Allocated bytes of all tags   */
+    BrainUlong total_peak_bytes;         /*!< Highest total_live_bytes      */
+} MemoryStats;
+
+/**
+ * \brief Struct MemoryUsage, blocks owned by an object
+ */
+typedef struct MemoryUsage
+{
+    BrainUlong bytes[Memory_Last];       /*!< Allocated bytes               */
+    BrainUlong blocks[Memory_Last];      /*!< Number of blocks              */
+    BrainUlong total_bytes;              /*!< Allocated bytes of all tags   */
+} MemoryUsage;
+
+/**
+ * \brief Struct BrainAllocator, where the blocks come from
+ *
+ * Every function gets the context as first argument. allocate_aligned
+ * receives a power of two alignment and may be NULL, the alignment is then
+ * obtained by over-allocating. reallocate may be NULL, a block is then
+ * moved by an allocation and a copy. Blocks do not need to be zeroed.
+ */
+typedef struct BrainAllocator
+{
+    void* (*allocate)        (void* context, size_t size);
+    void* (*reallocate)      (void* context, void* pointer, size_t size);
+    void  (*release)         (void* context, void* pointer);
+    void* (*allocate_aligned)(void* context, size_t alignment, size_t size);
+    void*   context;
+} BrainAllocator;
+
 #define BRAIN_ALLOCATED(pointer) (pointer != NULL)
 #define BRAIN_DELETE(pointer) if (pointer != NULL)                     \
                             {                                          \
-                                free(pointer);                         \
+                                brain_memory_free(pointer);            \
                                 pointer = NULL;                        \
                             }
-#define BRAIN_RESIZE(pointer, type, length) pointer = (type*)realloc(pointer, length * sizeof(type))
-#define BRAIN_NEW(pointer, type, length)    pointer = (type*)calloc (length, sizeof(type))
-#define BRAIN_COPY(src, dst, type, length)  memcpy(dst, src, length * sizeof(type))
-#define BRAIN_SET(pointer, value, type, length) memset(pointer, value, length * sizeof(type))
-#endif /* BRAIN_MEMORY_UTILS */
+#define BRAIN_NEW_TAG(pointer, type, length, tag) pointer = (type*)brain_memory_allocate((length), sizeof(type), tag)
+#define BRAIN_RESIZE_TAG(pointer, type, length, tag) pointer = (type*)brain_memory_resize(pointer, (length), sizeof(type), tag)
+#define BRAIN_NEW_IN(arena, pointer, type, length, tag) pointer = (type*)brain_memory_arena_allocate(arena, (length), sizeof(type), tag)
+#define BRAIN_NEW(pointer, type, length)    BRAIN_NEW_TAG(pointer, type, length, Memory_Other)
+#define BRAIN_RESIZE(pointer, type, length) BRAIN_RESIZE_TAG(pointer, type, length, Memory_Last)
+#define BRAIN_COPY(src, dst, type, length)  memcpy(dst, src, (length) * sizeof(type))
+#define BRAIN_SET(pointer, value, type, length) memset(pointer, value, (length) * sizeof(type))
+
+/**
+ * \fn void* brain_memory_allocate(const size_t number, const size_t size, const BrainMemoryTag tag)
+ * \brief allocate a zeroed block, like calloc
+ *
+ * \param number number of elements
+ * \param size   size of an element
+ * \param tag    accounted subsystem
+ * \return the block, NULL if it cannot be allocated
+ */
+void* brain_memory_allocate(const size_t number, const size_t size, const BrainMemoryTag tag);
+/**
+ * \fn void* brain_memory_resize(void* pointer, const size_t number, const size_t size, const BrainMemoryTag tag)
+ * \brief resize a block, like realloc
+ *
+ * \param pointer a block or NULL
+ * \param number  number of elements
+ * \param size    size of an element
+ * \param tag     accounted subsystem, Memory_Last to keep the one of the block
+ * \return the block, NULL if it cannot be allocated or if the size is 0
+ */
+void* brain_memory_resize(void* pointer, const size_t number, const size_t size, const BrainMemoryTag tag);
+/**
+ * \fn void brain_memory_free(void* pointer)
+ * \brief release a block
+ *
+ * \param pointer a block or NULL
+ */
+void brain_memory_free(void* pointer);
+/**
+ * \fn size_t brain_memory_size(const void* pointer)
+ * \brief get the usable size of a block, padding included
+ *
+ * \param pointer a block or NULL
+ * \return the size in bytes
+ */
+size_t brain_memory_size(const void* pointer);
+/**
+ * \fn size_t get_memory_arena_footprint(const size_t number, const size_t size, const BrainMemoryTag tag)
+ * \brief get the bytes of an arena taken by a block, header, alignment and padding included
+ *
+ * The footprints of all the blocks carved out of an arena sum up to a size
+ * it can hold, whatever their order.
+ *
+ * \param number number of elements
+ * \param size   size of an element
+ * \param tag    accounted subsystem
+ * \return the footprint in bytes, 0 if the block is too large
+ */
+size_t get_memory_arena_footprint(const size_t number, const size_t size, const BrainMemoryTag tag);
+/**
+ * \fn BrainMemoryArena new_memory_arena(const size_t size)
+ * \brief allocate an arena in a single allocation
+ *
+ * \param size the sum of the footprints of the blocks to carve
+ * \return the arena, NULL if it cannot be allocated
+ */
+BrainMemoryArena new_memory_arena(const size_t size);
+/**
+ * \fn void* brain_memory_arena_allocate(BrainMemoryArena arena, const size_t number, const size_t size, const BrainMemoryTag tag)
+ * \brief carve a zeroed block out of an arena
+ *
+ * When the arena is NULL, closed or full, the block is allocated as by
+ * brain_memory_allocate, so that callers do not have to care.
+ *
+ * \param arena  a BrainMemoryArena or NULL
+ * \param number number of elements
+ * \param size   size of an element
+ * \param tag    accounted subsystem
+ * \return the block, NULL if it cannot be allocated
+ */
+void* brain_memory_arena_allocate(BrainMemoryArena arena, const size_t number, const size_t size, const BrainMemoryTag tag);
+/**
+ * \fn void close_memory_arena(BrainMemoryArena arena)
+ * \brief stop carving blocks out of an arena
+ *
+ * The arena is released right away if none of its blocks is allocated,
+ * otherwise with the last of them. Its blocks must be deleted by the same
+ * thread.
+ *
+ * \param arena a BrainMemoryArena or NULL
+ */
+void close_memory_arena(BrainMemoryArena arena);
+/**
+ * \fn BrainBool brain_memory_set_allocator(const BrainAllocator* allocator)
+ * \brief allocate the next blocks from a host allocator
+ *
+ * A block is released by the allocator it comes from, so the allocator can
+ * only be replaced while no block is allocated, that is before the first
+ * allocation or once everything has been deleted. The allocator is copied.
+ *
+ * \param allocator the allocator, NULL for malloc, realloc and free
+ * \return BRAIN_FALSE if some blocks are still allocated
+ */
+BrainBool brain_memory_set_allocator(const BrainAllocator* allocator);
+/**
+ * \fn void get_memory_stats(MemoryStats* stats)
+ * \brief read the allocations of the process
+ *
+ * \param stats the filled statistics
+ */
+void get_memory_stats(MemoryStats* stats);
+/**
+ * \fn void reset_memory_peaks()
+ * \brief start the peaks again from the live bytes
+ */
+void reset_memory_peaks();
+/**
+ * \fn void accumulate_memory_usage(MemoryUsage* usage, const void* pointer)
+ * \brief add a block to the usage of an object
+ *
+ * \param usage   the usage to increase
+ * \param pointer a block or NULL
+ */
+void accumulate_memory_usage(MemoryUsage* usage, const void* pointer);
+/**
+ * \fn BrainBool brain_memory_track_xml()
+ * \brief account the libxml2 allocations as Memory_XML
+ *
+ * libxml2 allocators are global to the process: this must be called before
+ * any libxml2 allocation, by this library or by the host application.
+ *
+ * \return BRAIN_TRUE if libxml2 uses the accounted allocator
+ */
+BrainBool brain_memory_track_xml();
+#endif /* BRAIN_MEMORY_UTILS_H */
@@ -2,11 +2,18 @@
 #define BRAIN_PROBE_H
 
 #include "brain_logging_utils.h"
-#include <time.h>
 
-#define BRAIN_PROBE_START(func) clock_t t = clock();                   \
+#define BRAIN_PROBE_START(func) BrainDouble t = brain_probe_now();     \
                                 BRAIN_DEBUG("[%s:%d] Start probing", #func, __LINE__);
-#define BRAIN_PROBE_STOP(func)  BrainDouble elapsed = ((BrainDouble)(clock() - t)) / CLOCKS_PER_SEC;\
+#define BRAIN_PROBE_STOP(func)  BrainDouble elapsed = brain_probe_now() - t;\
                                 BRAIN_DEBUG("[%s:%d] Elapsed time: %.8lf", #func, __LINE__, elapsed);
 
+/**
+ * \fn BrainDouble brain_probe_now()
+ * \brief read the monotonic clock
+ *
+ * \return a time in seconds, only differences are meaningful
+ */
+BrainDouble brain_probe_now();
+
 #endif /* BRAIN_PROBE_H */
@@ -11,14 +11,43 @@
 
 #include "brain_core_types.h"
 
-#define BRAIN_RANDOM_INITIALIZATION srand(time(NULL));
-#define BRAIN_RAND_UNIT (BrainDouble)rand()/((BrainDouble)RAND_MAX)
-#define BRAIN_RAND_RANGE(min, max) BRAIN_RAND_UNIT * (BrainDouble)(max - min) + (BrainDouble)min
+/**
+ * Random numbers come from xoshiro256** generators. Each thread owns a
+ * stream which is a jump of 2^128 draws away from the others, so threads
+ * never share a state nor overlap. All streams derive from one seed: the
+ * BRAIN_SEED environment variable, set_random_seed, or the time.
+ */
+#define BRAIN_RANDOM_INITIALIZATION initialize_random();
+#define BRAIN_RAND_UNIT random_unit(get_thread_random())
+#define BRAIN_RAND_RANGE(min, max) random_range(get_thread_random(), (BrainDouble)(min), (BrainDouble)(max))
+
+/**
+ * A BrainRandomMask drops each element with a given rate and keeps the
+ * list of the others, see get_random_mask_indices.
+ */
+BrainRandomMask  new_random_mask        (const BrainUint number_of_elements, const BrainReal rate);
+void             delete_random_mask     (BrainRandomMask random_mask);
+BrainUint        generate_random_mask   (BrainRandomMask random_mask);
+void             generate_unit_mask     (BrainRandomMask random_mask);
+const BrainUint* get_random_mask_indices(const BrainRandomMask random_mask);
+BrainUint        get_random_mask_size   (const BrainRandomMask random_mask);
+void             accumulate_random_mask_memory(const BrainRandomMask random_mask, BrainMemoryUsage usage);
+
+BrainRandom     new_random          (const BrainUlong seed);
+void            delete_random       (BrainRandom random);
+void            seed_random         (BrainRandom random, const BrainUlong seed);
+void            copy_random         (const BrainRandom src, BrainRandom dst);
+void            jump_random         (BrainRandom random);
+BrainUlong      random_next         (BrainRandom random);
+BrainDouble     random_unit         (BrainRandom random);
+BrainDouble     random_range        (BrainRandom random, const BrainDouble min, const BrainDouble max);
+BrainUint       random_index        (BrainRandom random, const BrainUint number_of_elements);
+BrainDouble     random_normal       (BrainRandom random);
+void            fill_random_uniform (BrainRandom random, BrainReal* values, const BrainUint number_of_values, const BrainReal min, const BrainReal max);
+void            fill_random_normal  (BrainRandom random, BrainReal* values, const BrainUint number_of_values, const BrainReal mean, const BrainReal sigma);
 
-BrainRandomMask new_random_mask     (const BrainUint number_of_elements);
-void            delete_random_mask  (BrainRandomMask random_mask);
-BrainUint       generate_random_mask(BrainRandomMask random_mask);
-void            generate_unit_mask  (BrainRandomMask random_mask);
-BrainBool       get_random_state    (const BrainRandomMask random_mask, const BrainUint index);
+void            initialize_random   ();
+void            set_random_seed     (const BrainUlong seed);
+BrainRandom     get_thread_random   ();
 
 #endif /* BRAIN_RANDOM_UTILS_H */
@@ -14,6 +14,56 @@ BrainReal distance( const BrainReal* a,
 BrainReal norm2(const BrainReal* a,
                 const BrainUint size);
 
+BrainSignalStatistics new_signal_statistics(const BrainUint size);
+
+void delete_signal_statistics(BrainSignalStatistics statistics);
+
+void reset_signal_statistics(BrainSignalStatistics statistics);
+
+void accumulate_signal_statistics(BrainSignalStatistics statistics,
+                                  const BrainReal* signal);
+
+void merge_signal_statistics(BrainSignalStatistics statistics,
+                             const BrainSignalStatistics other);
+
+void find_signal_statistics(BrainSignalStatistics statistics,
+                            BrainReal** signals,
+                            const BrainUint number_of_signals);
+
+BrainUlong get_signal_statistics_count(const BrainSignalStatistics statistics);
+
+void get_signal_statistics(const BrainSignalStatistics statistics,
+                           BrainReal* means,
+                           BrainReal* variances,
+                           BrainReal* min,
+                           BrainReal* max);
+
+void ApplyAffineModel(  BrainReal** signals,
+                        const BrainReal* scales,
+                        const BrainReal* shifts,
+                        const BrainUint number_of_signals,
+                        const BrainUint size);
+
+void ReplaceAffineModel(BrainReal** signals,
+                        const BrainReal* former_scales,
+                        const BrainReal* former_shifts,
+                        const BrainReal* scales,
+                        const BrainReal* shifts,
+                        const BrainUint number_of_signals,
+                        const BrainUint size);
+
+void GetGaussianScale(  const BrainReal* means,
+                        const BrainReal* sigmas,
+                        BrainReal* scales,
+                        BrainReal* shifts,
+                        const BrainUint size);
+
+void GetMinMaxScale(const BrainReal* min,
+                    const BrainReal* max,
+                    BrainReal* scales,
+                    BrainReal* shifts,
+                    const BrainUint size);
+
 void FindGaussianModel( BrainReal** signals,
                         BrainReal* means,
                         BrainReal* sigmas,
@@ -0,0 +1,151 @@
+/**
+ * \file brain_stream_utils.h
+ * \brief Define the API to stream a dataset from the disk
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * A DataStream reads a CSV repository sequentially and serves its rows
+ * through a bounded shuffle buffer, so that the memory footprint does not
+ * depend on the size of the dataset. An epoch is a full pass over the file.
+ */
+#ifndef BRAIN_STREAM_UTILS_H
+#define BRAIN_STREAM_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \brief decode a parsed CSV line into an input and an output signal
+ */
+typedef void (*StreamDecodeCbk)(void* data,
+                                BrainString label,
+                                const BrainReal* signal,
+                                BrainSignal input,
+                                BrainSignal output);
+/**
+ * \brief called for each row during the preparation pass
+ */
+typedef void (*StreamRowCbk)(void* data,
+                             const BrainSignal input,
+                             const BrainSignal output,
+                             const BrainBool holdout);
+/**
+ * \fn BrainDataStream new_data_stream(BrainString path,
+ *                                     BrainString tokenizer,
+ *                                     const BrainDataFormat format,
+ *                                     const BrainBool is_labelled,
+ *                                     const BrainUint input_length,
+ *                                     const BrainUint output_length,
+ *                                     const BrainUint buffer_size,
+ *                                     BrainString cache_path,
+ *                                     StreamDecodeCbk decode,
+ *                                     void* data)
+ * \brief create a stream on a CSV repository
+ *
+ * \param path          the CSV repository
+ * \param tokenizer     the CSV tokenizer
+ * \param format        the CSV format
+ * \param is_labelled   the CSV contains labels
+ * \param input_length  the input signal length
+ * \param output_length the output signal length
+ * \param buffer_size   number of rows kept in the shuffle buffer
+ * \param cache_path    binary cache file or NULL
+ * \param decode        callback used to decode a CSV line
+ * \param data          user data given to the decode callback
+ * \return a BrainDataStream
+ */
+BrainDataStream new_data_stream(BrainString path,
+                                BrainString tokenizer,
+                                const BrainDataFormat format,
+                                const BrainBool is_labelled,
+                                const BrainUint input_length,
+                                const BrainUint output_length,
+                                const BrainUint buffer_size,
+                                BrainString cache_path,
+                                StreamDecodeCbk decode,
+                                void* data);
+/**
+ * \fn void delete_data_stream(BrainDataStream stream)
+ * \brief delete a stream
+ *
+ * \param stream a BrainDataStream
+ */
+void delete_data_stream(BrainDataStream stream);
+/**
+ * \fn void accumulate_data_stream_memory(const BrainDataStream stream, BrainMemoryUsage usage)
+ * \brief add the blocks of a stream and of its reader to a memory usage
+ *
+ * \param stream a BrainDataStream
+ * \param usage  the BrainMemoryUsage to increase
+ */
+void accumulate_data_stream_memory(const BrainDataStream stream, BrainMemoryUsage usage);
+/**
+ * \fn void set_data_stream_holdout(BrainDataStream stream, const BrainReal training_ratio, const BrainUint holdout_size)
+ * \brief keep some rows out of the training epochs
+ *
+ * A row is held out if a hash of its position is above the training ratio,
+ * until holdout_size rows have been held out. The selection is deterministic
+ * so the same rows are skipped at each epoch.
+ *
+ * \param stream         a BrainDataStream
+ * \param training_ratio ratio of rows used for the training
+ * \param holdout_size   maximum number of held out rows
+ */
+void set_data_stream_holdout(BrainDataStream stream,
+                             const BrainReal training_ratio,
+                             const BrainUint holdout_size);
+/**
+ * \fn void set_data_stream_labels(BrainDataStream stream, BrainLabelDictionary labels)
+ * \brief give the dictionary filled by the decode callback
+ *
+ * The labels are stored in the binary cache, and restored in this
+ * dictionary when the cache is reused. Without dictionary the cache of a
+ * labelled repository is never reused.
+ *
+ * \param stream a BrainDataStream
+ * \param labels the BrainLabelDictionary
+ */
+void set_data_stream_labels(BrainDataStream stream, BrainLabelDictionary labels);
+/**
+ * \fn BrainUlong data_stream_prepare(BrainDataStream stream, StreamRowCbk cbk, void* data)
+ * \brief read the whole repository once
+ *
+ * This pass counts the rows, selects the held out rows and writes the binary
+ * cache if one has been requested. Each row is given to the callback.
+ *
+ * \param stream a BrainDataStream
+ * \param cbk    callback called on each row
+ * \param data   user data given to the callback
+ * \return the number of training rows
+ */
+BrainUlong data_stream_prepare(BrainDataStream stream, StreamRowCbk cbk, void* data);
+/**
+ * \fn BrainBool data_stream_next(BrainDataStream stream, BrainSignal* input, BrainSignal* output)
+ * \brief get the next training row from the shuffle buffer
+ *
+ * The returned signals are owned by the stream and are valid until the
+ * next call.
+ *
+ * \param stream a BrainDataStream
+ * \param input  the input signal
+ * \param output the output signal
+ * \return BRAIN_FALSE if the stream does not contain any training row
+ */
+BrainBool data_stream_next(BrainDataStream stream, BrainSignal* input, BrainSignal* output);
+/**
+ * \fn BrainUint get_data_stream_epoch(const BrainDataStream stream)
+ * \brief get the number of completed passes over the repository
+ *
+ * \param stream a BrainDataStream
+ * \return the number of epochs
+ */
+BrainUint get_data_stream_epoch(const BrainDataStream stream);
+/**
+ * \fn BrainUlong get_data_stream_number_of_rows(const BrainDataStream stream)
+ * \brief get the number of training rows per epoch
+ *
+ * \param stream a BrainDataStream
+ * \return the number of training rows
+ */
+BrainUlong get_data_stream_number_of_rows(const BrainDataStream stream);
+
+#endif /* BRAIN_STREAM_UTILS_H */
@@ -0,0 +1,50 @@
+/**
+ * \file brain_thread_utils.h
+ * \brief Define the API to split a loop over several threads
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * The number of threads is the number of online processors, or the value
+ * of the BRAIN_NUM_THREADS environment variable if it is defined.
+ */
+#ifndef BRAIN_THREAD_UTILS_H
+#define BRAIN_THREAD_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \brief body of a parallel loop, called on [begin, end) by the thread index
+ */
+typedef void (*ParallelCbk)(void* data,
+                            const BrainUint begin,
+                            const BrainUint end,
+                            const BrainUint thread);
+/**
+ * \fn BrainUint get_number_of_threads(const BrainUint number_of_items, const BrainUint grain)
+ * \brief get the number of threads used to process some items
+ *
+ * Each thread gets at least grain items, so small loops stay on the
+ * calling thread.
+ *
+ * \param number_of_items the number of items
+ * \param grain           the minimum number of items per thread
+ * \return the number of threads
+ */
+BrainUint get_number_of_threads(const BrainUint number_of_items, const BrainUint grain);
+/**
+ * \fn void parallel_for(const BrainUint number_of_items, const BrainUint number_of_threads, ParallelCbk cbk, void* data)
+ * \brief split [0, number_of_items) into contiguous chunks, one per thread
+ *
+ * The calling thread processes the first chunk and waits for the others.
+ *
+ * \param number_of_items   the number of items
+ * \param number_of_threads the number of threads, see get_number_of_threads
+ * \param cbk               the loop body
+ * \param data              user data given to the loop body
+ */
+void parallel_for(const BrainUint number_of_items,
+                  const BrainUint number_of_threads,
+                  ParallelCbk cbk,
+                  void* data);
+
+#endif /* BRAIN_THREAD_UTILS_H */
@@ -0,0 +1,63 @@
+/**
+ * \file brain_timeline_utils.h
+ * \brief Define the API to record a timeline of spans
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Spans are written in the Chrome Trace Event format, which can be loaded
+ * in Perfetto or chrome://tracing. Unlike brain_trace_utils.h the recorder
+ * is started at runtime: when it is stopped a span costs a single test.
+ *
+ * Each thread fills its own chunks of spans. Full chunks are handed to a
+ * background thread that formats and writes them, so recording threads
+ * never wait for the disk. A thread reusing the timeline index of a thread
+ * that exited appears on the same track.
+ */
+#ifndef BRAIN_TIMELINE_UTILS_H
+#define BRAIN_TIMELINE_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \def BRAIN_TIMELINE_CHUNK
+ * \brief number of spans a thread gathers before handing them to the writer
+ */
+#define BRAIN_TIMELINE_CHUNK 1024
+
+/**
+ * \fn BrainBool brain_timeline_start(BrainString path)
+ * \brief start recording spans to a JSON file
+ *
+ * \param path the output file, overwritten
+ * \return BRAIN_TRUE if the recorder has been started
+ */
+BrainBool brain_timeline_start(BrainString path);
+/**
+ * \fn void brain_timeline_stop()
+ * \brief write the pending spans and close the file
+ *
+ * Spans still open are dropped. Recording threads may keep running.
+ */
+void brain_timeline_stop();
+/**
+ * \fn BrainUlong brain_timeline_begin()
+ * \brief open a span
+ *
+ * \return the begin time, 0 if the recorder is stopped
+ */
+BrainUlong brain_timeline_begin();
+/**
+ * \fn void brain_timeline_end(BrainString name, BrainString category, const BrainUlong begin, const BrainInt index)
+ * \brief close a span opened by brain_timeline_begin
+ *
+ * \param name     a string living as long as the program, usually a literal
+ * \param category a string living as long as the program, usually a literal
+ * \param begin    the value returned by brain_timeline_begin
+ * \param index    a layer, iteration or thread index, negative if none
+ */
+void brain_timeline_end(BrainString name,
+                        BrainString category,
+                        const BrainUlong begin,
+                        const BrainInt index);
+
+#endif /* BRAIN_TIMELINE_UTILS_H */
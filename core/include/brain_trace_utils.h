@@ -0,0 +1,69 @@
+/**
+ * \file brain_trace_utils.h
+ * \brief Define the API to trace function calls
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * BRAIN_TRACE_BEGIN and BRAIN_TRACE_END expand to nothing unless the
+ * library is built with BRAIN_ENABLE_TRACING, so they can be left in the
+ * hottest loops.
+ *
+ * When enabled, each thread records events in its own binary ring buffer
+ * holding the last BRAIN_TRACE_CAPACITY events. Nothing is formatted until
+ * the buffers are dumped. The buffer of a thread that exits is given to
+ * the next traced thread, so short lived workers do not add up.
+ */
+#ifndef BRAIN_TRACE_UTILS_H
+#define BRAIN_TRACE_UTILS_H
+
+#include "brain_core_types.h"
+
+/**
+ * \def BRAIN_TRACE_CAPACITY
+ * \brief number of events per thread, a power of two
+ */
+#define BRAIN_TRACE_CAPACITY 65536
+
+/**
+ * \enum BrainTraceEvent
+ * \brief kind of a trace event
+ */
+typedef enum BrainTraceEvent
+{
+    Trace_Begin, /*!< Entering a function */
+    Trace_End    /*!< Leaving a function  */
+} BrainTraceEvent;
+
+#if defined(BRAIN_ENABLE_TRACING)
+#define BRAIN_TRACE_BEGIN(func) brain_trace_record(#func, Trace_Begin);
+#define BRAIN_TRACE_END(func)   brain_trace_record(#func, Trace_End);
+#else
+#define BRAIN_TRACE_BEGIN(func)
+#define BRAIN_TRACE_END(func)
+#endif /* BRAIN_ENABLE_TRACING */
+
+/**
+ * \fn void brain_trace_record(BrainString name, const BrainTraceEvent event)
+ * \brief record an event in the ring buffer of the calling thread
+ *
+ * \param name  a string living as long as the program, usually a literal
+ * \param event the kind of event
+ */
+void brain_trace_record(BrainString name, const BrainTraceEvent event);
+/**
+ * \fn void brain_trace_dump(FILE* file)
+ * \brief write the recorded events, oldest first for each thread
+ *
+ * Each line holds the thread, the monotonic time in nanoseconds, B or E
+ * and the function name. Traced threads should not run meanwhile.
+ *
+ * \param file an opened file
+ */
+void brain_trace_dump(FILE* file);
+/**
+ * \fn void brain_trace_clear()
+ * \brief forget all recorded events
+ */
+void brain_trace_clear();
+
+#endif /* BRAIN_TRACE_UTILS_H */
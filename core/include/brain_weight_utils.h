@@ -1,15 +1,99 @@
+/**
+ * \file brain_weight_utils.h
+ * \brief Define the API to update weights from their gradients
+ * \author Benoit F.
+ * \date 18 octobre 2026
+ *
+ * Weights, gradients and optimizer states are contiguous arrays owned by
+ * the caller, so a whole layer is updated by a single loop. Each update
+ * averages the gradients of a minibatch, clips them, decays the weights
+ * and applies the optimizer rule, then clears the gradients.
+ */
 #ifndef BRAIN_WEIGHT_UTILS
 #define BRAIN_WEIGHT_UTILS
 #include "brain_core_types.h"
 
-BrainWeight new_weight(BrainReal);
-
-void update_weight(BrainWeight, BrainReal, BrainReal);
-
-BrainReal get_weight(BrainWeight);
-
-void set_weight(BrainWeight, BrainReal);
-
-void accumulate_gradient(BrainWeight, BrainReal, BrainReal);
+/**
+ * \fn BrainOptimizer new_optimizer(BrainString name)
+ * \brief create an optimizer
+ *
+ * \param name SGD, Momentum, Nesterov, AdaGrad, RMSProp or Adam
+ * \return a BrainOptimizer or NULL if the name is unknown
+ */
+BrainOptimizer new_optimizer(BrainString name);
+/**
+ * \fn void delete_optimizer(BrainOptimizer optimizer)
+ * \brief delete an optimizer
+ *
+ * \param optimizer a BrainOptimizer
+ */
+void delete_optimizer(BrainOptimizer optimizer);
+/**
+ * \fn void configure_optimizer(BrainOptimizer optimizer, const BrainReal learning_rate, const BrainReal momentum, const BrainReal beta1, const BrainReal beta2, const BrainReal epsilon)
+ * \brief set the optimizer rule parameters
+ *
+ * Momentum and Nesterov use momentum, RMSProp uses beta2 as its decay
+ * and Adam uses both betas.
+ *
+ * \param optimizer     a BrainOptimizer
+ * \param learning_rate the learning rate
+ * \param momentum      the velocity decay
+ * \param beta1         the first moment decay
+ * \param beta2         the second moment decay
+ * \param epsilon       added to the second moment root
+ */
+void configure_optimizer(BrainOptimizer optimizer,
+                         const BrainReal learning_rate,
+                         const BrainReal momentum,
+                         const BrainReal beta1,
+                         const BrainReal beta2,
+                         const BrainReal epsilon);
+/**
+ * \fn void regularize_optimizer(BrainOptimizer optimizer, const BrainReal weight_decay, const BrainReal clipping)
+ * \brief set the weight decay and the gradient clipping
+ *
+ * The decay is decoupled from the gradient: weights shrink by
+ * learning_rate * weight_decay at each update, whatever the rule.
+ *
+ * \param optimizer    a BrainOptimizer
+ * \param weight_decay the weight decay, 0 to disable it
+ * \param clipping     the largest absolute gradient, 0 to disable it
+ */
+void regularize_optimizer(BrainOptimizer optimizer,
+                          const BrainReal weight_decay,
+                          const BrainReal clipping);
+/**
+ * \fn BrainUint get_optimizer_number_of_states(const BrainOptimizer optimizer)
+ * \brief get the number of states stored for each weight
+ *
+ * \param optimizer a BrainOptimizer
+ * \return 0, 1 or 2
+ */
+BrainUint get_optimizer_number_of_states(const BrainOptimizer optimizer);
+/**
+ * \fn void step_optimizer(BrainOptimizer optimizer, const BrainUint number_of_samples)
+ * \brief start a new update
+ *
+ * \param optimizer         a BrainOptimizer
+ * \param number_of_samples the number of samples accumulated in the gradients
+ */
+void step_optimizer(BrainOptimizer optimizer, const BrainUint number_of_samples);
+/**
+ * \fn void update_weights(const BrainOptimizer optimizer, BrainReal* weights, BrainReal* gradients, BrainReal* first, BrainReal* second, const BrainUint number_of_weights)
+ * \brief update some contiguous weights and clear their gradients
+ *
+ * \param optimizer         a BrainOptimizer
+ * \param weights           the weights
+ * \param gradients         the accumulated gradients
+ * \param first             the first state of each weight, may be NULL without state
+ * \param second            the second state of each weight, may be NULL with less than 2 states
+ * \param number_of_weights the number of weights
+ */
+void update_weights(const BrainOptimizer optimizer,
+                    BrainReal* weights,
+                    BrainReal* gradients,
+                    BrainReal* first,
+                    BrainReal* second,
+                    const BrainUint number_of_weights);
 
 #endif /* BRAIN_WEIGHT_UTILS  */
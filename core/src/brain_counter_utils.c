@@ -0,0 +1,232 @@
+#include "brain_counter_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_logging_utils.h"
+#include <pthread.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#endif /* __linux__ */
+
+/**
+ * \struct Counters
+ * \brief  A perf_event group
+ */
+typedef struct Counters
+{
+    BrainInt   _fds[Counter_Last];    /*!< Event file, -1 if unavailable   */
+    BrainUint  _slots[Counter_Last];  /*!< Position in the group read      */
+    BrainUint  _number_of_opened;     /*!< Number of opened events         */
+    BrainUlong _start[Counter_Last];  /*!< Counts at the region start      */
+    pthread_t  _thread;               /*!< Counted thread                  */
+} Counters;
+
+#if defined(__linux__)
+static const __u32 _counter_types[] =
+{
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HARDWARE
+};
+
+static const __u64 _counter_configs[] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D
+    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static BrainInt
+open_counter(const BrainCounterType type, const BrainInt leader)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size           = sizeof(attr);
+    attr.type           = _counter_types[type];
+    attr.config         = _counter_configs[type];
+    attr.disabled       = (leader < 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP;
+
+    return (BrainInt)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif /* __linux__ */
+
+static void
+close_counters(BrainCounters counters)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < Counter_Last; ++i)
+    {
+#if defined(__linux__)
+        if (0 <= counters->_fds[i])
+        {
+            close(counters->_fds[i]);
+        }
+#endif /* __linux__ */
+        counters->_fds[i] = -1;
+    }
+
+    counters->_number_of_opened = 0;
+}
+
+static void
+open_counters(BrainCounters counters)
+{
+    counters->_thread = pthread_self();
+
+#if defined(__linux__)
+    {
+        BrainInt  leader = -1;
+        BrainUint i = 0;
+
+        for (i = 0; i < Counter_Last; ++i)
+        {
+            counters->_fds[i] = open_counter((BrainCounterType)i, leader);
+
+            if (0 <= counters->_fds[i])
+            {
+                if (leader < 0)
+                {
+                    leader = counters->_fds[i];
+                }
+
+                counters->_slots[i] = counters->_number_of_opened++;
+            }
+        }
+
+        if (0 <= leader)
+        {
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+#endif /* __linux__ */
+}
+
+static BrainBool
+read_counters(BrainCounters counters, BrainUlong* values)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+#if defined(__linux__)
+    if (0 < counters->_number_of_opened)
+    {
+        BrainUint i = 0;
+        // the number of events followed by their counts
+        __u64 buffer[Counter_Last + 1];
+
+        for (i = 0; i < Counter_Last; ++i)
+        {
+            if (0 <= counters->_fds[i])
+            {
+                break;
+            }
+        }
+
+        if (read(counters->_fds[i], buffer, sizeof(buffer)) > 0)
+        {
+            for (i = 0; i < Counter_Last; ++i)
+            {
+                values[i] = (0 <= counters->_fds[i]) ? buffer[1 + counters->_slots[i]] : 0;
+            }
+
+            ret = BRAIN_TRUE;
+        }
+    }
+#endif /* __linux__ */
+
+    return ret;
+}
+
+BrainCounters
+new_counters()
+{
+    BrainCounters counters = NULL;
+    BrainUint i = 0;
+
+    BRAIN_NEW(counters, Counters, 1);
+
+    for (i = 0; i < Counter_Last; ++i)
+    {
+        counters->_fds[i] = -1;
+    }
+
+    open_counters(counters);
+
+    if (counters->_number_of_opened == 0)
+    {
+        BRAIN_WARNING("Hardware counters are not available");
+    }
+
+    return counters;
+}
+
+void
+delete_counters(BrainCounters counters)
+{
+    if (BRAIN_ALLOCATED(counters))
+    {
+        close_counters(counters);
+        BRAIN_DELETE(counters);
+    }
+}
+
+BrainBool
+is_counter_available(const BrainCounters counters, const BrainCounterType type)
+{
+    return BRAIN_ALLOCATED(counters)
+    &&     (type < Counter_Last)
+    &&     (0 <= counters->_fds[type]);
+}
+
+void
+start_counters(BrainCounters counters)
+{
+    if (BRAIN_ALLOCATED(counters))
+    {
+        if (!pthread_equal(counters->_thread, pthread_self()))
+        {
+            close_counters(counters);
+            open_counters(counters);
+        }
+
+        if (!read_counters(counters, counters->_start))
+        {
+            BRAIN_SET(counters->_start, 0, BrainUlong, Counter_Last);
+        }
+    }
+}
+
+void
+stop_counters(BrainCounters counters, BrainUlong* values)
+{
+    if (BRAIN_ALLOCATED(counters)
+    &&  BRAIN_ALLOCATED(values))
+    {
+        BrainUlong now[Counter_Last];
+
+        if (pthread_equal(counters->_thread, pthread_self())
+        &&  read_counters(counters, now))
+        {
+            BrainUint i = 0;
+
+            for (i = 0; i < Counter_Last; ++i)
+            {
+                values[i] += now[i] - counters->_start[i];
+            }
+        }
+    }
+}
@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#define BRAIN_CSV_LINE_LENGTH 1000
+
 typedef struct CsvReader
 {
     BrainString     _path;
@@ -12,8 +14,32 @@ typedef struct CsvReader
     BrainUint       _number_of_fields;
     BrainDataFormat _format;
     BrainBool       _is_labelled;
+    /******************************************************************/
+    /**                       LINE BY LINE READING                   **/
+    /******************************************************************/
+    FILE*           _file;                          /*!< Opened CSV file      */
+    BrainChar       _line[BRAIN_CSV_LINE_LENGTH];   /*!< Current line         */
+    BrainChar       _label[BRAIN_CSV_LINE_LENGTH];  /*!< Current label        */
+    BrainReal*      _signal;                        /*!< Current signal       */
 } CsvReader;
 
+static void
+csv_reader_copy_label(BrainCsvReader reader, BrainString buffer)
+{
+    BrainUint length = 0;
+
+    strncpy(reader->_label, buffer, BRAIN_CSV_LINE_LENGTH - 1);
+    reader->_label[BRAIN_CSV_LINE_LENGTH - 1] = '\0';
+
+    length = strlen(reader->_label);
+    // remove the end of line from the label
+    while ((0 < length)
+    &&     ((reader->_label[length - 1] == '\n') || (reader->_label[length - 1] == '\r')))
+    {
+        reader->_label[--length] = '\0';
+    }
+}
+
 BrainCsvReader
 new_csv_reader( BrainString path,
                 BrainString tokenizer,
@@ -36,6 +62,9 @@ new_csv_reader( BrainString path,
         reader->_number_of_fields   = number_of_fields;
         reader->_is_labelled        = is_labelled;
         reader->_format             = format;
+        reader->_file               = NULL;
+
+        BRAIN_NEW_TAG(reader->_signal, BrainReal, number_of_fields, Memory_Dataset);
     }
 
     BRAIN_OUTPUT(new_csv_reader)
@@ -50,12 +79,140 @@ delete_csv_reader(BrainCsvReader reader)
 
     if (reader)
     {
+        csv_reader_close(reader);
+        BRAIN_DELETE(reader->_signal);
         BRAIN_DELETE(reader);
     }
 
     BRAIN_OUTPUT(delete_csv_reader)
 }
 
+void
+accumulate_csv_reader_memory(const BrainCsvReader reader, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(reader))
+    {
+        accumulate_memory_usage(usage, reader->_signal);
+        accumulate_memory_usage(usage, reader);
+    }
+}
+
+BrainBool
+csv_reader_open(BrainCsvReader reader)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(reader))
+    {
+        csv_reader_close(reader);
+
+        reader->_file = fopen(reader->_path, "r");
+
+        if (BRAIN_ALLOCATED(reader->_file))
+        {
+            ret = BRAIN_TRUE;
+        }
+        else
+        {
+            BRAIN_CRITICAL("Unable to open %s for reading\n", reader->_path);
+        }
+    }
+
+    return ret;
+}
+
+void
+csv_reader_close(BrainCsvReader reader)
+{
+    if (BRAIN_ALLOCATED(reader)
+    &&  BRAIN_ALLOCATED(reader->_file))
+    {
+        fclose(reader->_file);
+        reader->_file = NULL;
+    }
+}
+
+void
+csv_reader_rewind(BrainCsvReader reader)
+{
+    if (BRAIN_ALLOCATED(reader)
+    &&  BRAIN_ALLOCATED(reader->_file))
+    {
+        rewind(reader->_file);
+    }
+}
+
+BrainBool
+csv_reader_next(BrainCsvReader reader,
+                BrainString* label,
+                const BrainReal** signal)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(reader)
+    &&  BRAIN_ALLOCATED(reader->_file)
+    &&  BRAIN_ALLOCATED(reader->_tokenizer))
+    {
+        /****************************************************************/
+        /**             Skip lines until a valid one is found          **/
+        /****************************************************************/
+        while (!ret && fgets(reader->_line, BRAIN_CSV_LINE_LENGTH, reader->_file))
+        {
+            BrainChar* buffer = strtok(reader->_line, reader->_tokenizer);
+            BrainUint k = 0;
+
+            if (BRAIN_ALLOCATED(buffer))
+            {
+                reader->_label[0] = '\0';
+
+                if (reader->_is_labelled && reader->_format == Format_OutputFirst)
+                {
+                    csv_reader_copy_label(reader, buffer);
+                    // go to the next item
+                    buffer = strtok(NULL, reader->_tokenizer);
+                }
+
+                while ((k < reader->_number_of_fields)
+                &&     BRAIN_ALLOCATED(buffer))
+                {
+#ifdef BRAIN_ENABLE_DOUBLE_PRECISION
+                    sscanf(buffer, "%lf", &(reader->_signal[k]));
+#else
+                    sscanf(buffer, "%f", &(reader->_signal[k]));
+#endif
+                    buffer = strtok(NULL, reader->_tokenizer);
+                    ++k;
+                }
+
+                if (reader->_format == Format_InputFirst &&
+                    reader->_is_labelled &&
+                    BRAIN_ALLOCATED(buffer))
+                {
+                    // copy the buffer into the label
+                    csv_reader_copy_label(reader, buffer);
+                }
+
+                ret = (k == reader->_number_of_fields);
+            }
+        }
+
+        if (ret)
+        {
+            if (BRAIN_ALLOCATED(label))
+            {
+                *label = reader->_is_labelled ? reader->_label : NULL;
+            }
+
+            if (BRAIN_ALLOCATED(signal))
+            {
+                *signal = reader->_signal;
+            }
+        }
+    }
+
+    return ret;
+}
+
 void
 csv_reader_load(BrainCsvReader reader,
                 CsvLineCbk cbk,
@@ -68,73 +225,20 @@ csv_reader_load(BrainCsvReader reader,
         BRAIN_ALLOCATED(cbk)        &&
         BRAIN_ALLOCATED(data)       )
     {
-        BrainChar line[1000];
-        size_t     len  = 1000;
-
-        FILE* file = fopen(reader->_path, "r");
-
-        if (BRAIN_ALLOCATED(file))
+        if (csv_reader_open(reader))
         {
+            BrainString      label  = NULL;
+            const BrainReal* signal = NULL;
             /****************************************************************/
             /**                 Browse the repository file                 **/
             /****************************************************************/
-            while (fgets(line, len, file))
+            while (csv_reader_next(reader, &label, &signal))
             {
-                BrainReal* signal = NULL;
-                BrainChar* buffer = strtok(line, reader->_tokenizer);
-                BrainUint k = 0;
-
-                BRAIN_NEW(signal, BrainReal, reader->_number_of_fields);
-
-                if (BRAIN_ALLOCATED(buffer))
-                {
-                    BrainChar* label = NULL;
-                    BrainUint length = strlen(buffer);
-
-                    if (reader->_is_labelled && reader->_format == Format_OutputFirst)
-                    {
-                        BRAIN_NEW(label, BrainChar, length);
-
-                        buffer[length - 1] = '\0';
-                        label = strcpy(label, buffer);
-                        // go to the next item
-                        buffer = strtok(NULL, reader->_tokenizer);
-                    }
-
-                    printf("\n");
-                    while(k < reader->_number_of_fields)
-                    {
-#ifdef BRAIN_ENABLE_DOUBLE_PRECISION
-                        sscanf(buffer, "%lf", &(signal[k]));
-#else
-                        sscanf(buffer, "%f", &(signal[k]));
-#endif
-                        buffer = strtok(NULL, reader->_tokenizer);
-                        ++k;
-                    }
-
-                    if (reader->_format == Format_InputFirst &&
-                        reader->_is_labelled)
-                    {
-                        // copy the buffer into the label
-                        length = strlen(buffer);
-                        BRAIN_NEW(label, BrainChar, length);
-                        buffer[length - 1] = '\0';
-                        label = strcpy(label, buffer);
-                    }
-
-                    // Call the callback function
-                    cbk(data, label, signal);
-
-                    BRAIN_DELETE(signal);
-                    if (BRAIN_ALLOCATED(label))
-                    {
-                        BRAIN_DELETE(label)
-                    }
-                }
+                // Call the callback function
+                cbk(data, label, signal);
             }
 
-            fclose(file);
+            csv_reader_close(reader);
         }
     }
     else
@@ -7,11 +7,16 @@
 #include "brain_xml_utils.h"
 #include "brain_enum_utils.h"
 #include "brain_csv_utils.h"
+#include "brain_stream_utils.h"
+#include "brain_label_utils.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 #define TRAINING_DATASET_RATIO 0.80
+#define BRAIN_ROW_STORE_MIN_CAPACITY 64
+#define BRAIN_SAMPLING_BLOCK_SIZE 64
 
 static BrainString _parsers[] = {
     "csv"
@@ -20,35 +25,56 @@ static BrainString _formats[] = {
     "InputFirst",
     "OutputFirst"
 };
+static BrainString _samplings[] = {
+    "Random",
+    "Shuffle",
+    "BlockShuffle"
+};
 static BrainString _preprocessings[] = {
     "GaussianNormalization",
     "MinMaxNormalization"
 };
 
+/**
+ * \struct RowStore
+ * \brief  Backing storage of all loaded signals
+ *
+ * Signals are stored row after row. A labelled row only stores its class.
+ */
+typedef struct RowStore
+{
+    BrainSignal _inputs;         /*!< Contiguous input signals      */
+    BrainSignal _outputs;        /*!< Contiguous output signals     */
+    BrainUint*  _classes;        /*!< Class of each labelled row    */
+    BrainUint   _number_of_rows; /*!< Number of rows                */
+    BrainUint   _capacity;       /*!< Number of allocated rows      */
+} RowStore;
+
 /**
  * \struct Dataset
  * \brief  Internal model for a Dataset
  *
- * All protected fields for a Dataset
+ * A Dataset is a view over the RowStore rows
  */
 typedef struct Dataset
 {
-    BrainSignal* _input;    /*!< The input signal       */
-    BrainSignal* _output;   /*!< The output signal      */
+    BrainUint*   _index;    /*!< Rows of the view       */
     BrainUint    _children; /*!< The number of children */
 } Dataset;
 
-typedef struct GaussianModel
-{
-    BrainSignal _means;
-    BrainSignal _sigmas;
-} GaussianModel;
-
-typedef struct MinMaxModel
+/**
+ * \struct PreprocessingModel
+ * \brief  Parameters of a preprocessing applied to all input signals
+ *
+ * _first and _second are the means and the variances of a Gaussian
+ * normalization, or the min and max values of a MinMax normalization
+ */
+typedef struct PreprocessingModel
 {
-    BrainSignal _min;
-    BrainSignal _max;
-} MinMaxModel;
+    DataPreprocessing _type;    /*!< The preprocessing type    */
+    BrainSignal       _first;   /*!< means or min values       */
+    BrainSignal       _second;  /*!< variances or max values   */
+} PreprocessingModel;
 
 /**
  * \struct Data
@@ -58,18 +84,148 @@ typedef struct MinMaxModel
  */
 typedef struct Data
 {
+    RowStore    _rows;             /*!< All loaded signals            */
+    BrainUint*  _order;            /*!< Shuffled rows used to split   */
+    BrainReal   _training_ratio;   /*!< Ratio of training rows        */
+    BrainBool   _preprocessed;     /*!< Rows have been preprocessed   */
+    BrainSignal _scales;           /*!< Composed preprocessing scales */
+    BrainSignal _shifts;           /*!< Composed preprocessing shifts */
     Dataset     _training;         /*!< This is the training node     */
     Dataset     _evaluating;       /*!< This is the evaluating node   */
     BrainUint   _input_length;     /*!< input signal length           */
     BrainUint   _output_length;    /*!< output signal length          */
-    BrainUint   _labels_length;    /*!< output label length           */
-    BrainChar** _labels;           /*!< output label if needed        */
+    BrainLabelDictionary _labels;  /*!< output label if needed        */
+    BrainSignal _training_target;  /*!< One-hot training target       */
+    BrainUint   _training_class;   /*!< Class set in training target  */
+    BrainSignal _evaluating_target;/*!< One-hot evaluating target     */
+    BrainUint   _evaluating_class; /*!< Class set in evaluating target*/
     BrainBool   _is_labelled;      /*!< Data are labelled             */
     BrainDataFormat _format;       /*!< Data format                   */
+    BrainDataStream _stream;       /*!< Training rows read from disk  */
+    BrainUlong  _served;           /*!< Number of served samples      */
+    DataSampling _sampling;        /*!< How training samples are drawn*/
+    BrainUint   _block_size;       /*!< Rows per shuffled block       */
+    BrainUint*  _epoch;            /*!< Training samples of the epoch */
+    BrainUint*  _blocks;           /*!< Shuffled blocks of the epoch  */
+    BrainUint   _cursor;           /*!< Next sample of the epoch      */
+    BrainUint   _number_of_preprocessing; /*!< Number of preprocessing */
+    PreprocessingModel* _preprocessings;  /*!< Preprocessing models    */
 } Data;
 
+/**
+ * \struct StreamPreparation
+ * \brief  State of the preparation pass of a streamed BrainData
+ *
+ * Statistics of all training rows are accumulated in one pass, so the
+ * preprocessing models are exact in bounded memory
+ */
+typedef struct StreamPreparation
+{
+    BrainData             _data;       /*!< The streamed data            */
+    BrainSignalStatistics _statistics; /*!< Training rows statistics     */
+} StreamPreparation;
+
+static BrainUint
+append_row(RowStore* store,
+           const BrainUint input_length,
+           const BrainUint output_length,
+           const BrainBool is_labelled)
+{
+    const BrainUint row = store->_number_of_rows;
+
+    if (store->_capacity <= row)
+    {
+        /************************************************************/
+        /**          Grow geometrically to amortize realloc        **/
+        /************************************************************/
+        store->_capacity = (store->_capacity == 0) ? BRAIN_ROW_STORE_MIN_CAPACITY : 2 * store->_capacity;
+
+        BRAIN_RESIZE_TAG(store->_inputs, BrainReal, store->_capacity * input_length, Memory_Dataset);
+
+        if (is_labelled)
+        {
+            BRAIN_RESIZE_TAG(store->_classes, BrainUint, store->_capacity, Memory_Labels);
+        }
+        else
+        {
+            BRAIN_RESIZE_TAG(store->_outputs, BrainReal, store->_capacity * output_length, Memory_Dataset);
+        }
+    }
+
+    BRAIN_SET(store->_inputs + row * input_length, 0, BrainReal, input_length);
+
+    if (is_labelled)
+    {
+        store->_classes[row] = 0;
+    }
+    else
+    {
+        BRAIN_SET(store->_outputs + row * output_length, 0, BrainReal, output_length);
+    }
+
+    ++store->_number_of_rows;
+
+    return row;
+}
+
+static BrainSignal
+get_row_input(const BrainData data, const BrainUint row)
+{
+    return data->_rows._inputs + row * data->_input_length;
+}
+
+static BrainSignal*
+get_row_pointers(BrainSignal rows,
+                 const BrainUint* index,
+                 const BrainUint number_of_rows,
+                 const BrainUint length)
+{
+    BrainSignal* ret = NULL;
+    BrainUint i = 0;
+
+    BRAIN_NEW_TAG(ret, BrainSignal, number_of_rows, Memory_Dataset);
+
+    for (i = 0; i < number_of_rows; ++i)
+    {
+        const BrainUint row = BRAIN_ALLOCATED(index) ? index[i] : i;
+
+        ret[i] = rows + row * length;
+    }
+
+    return ret;
+}
+
+static BrainSignal
+expand_class(const BrainData data,
+             BrainSignal target,
+             BrainUint* current,
+             const BrainUint class)
+{
+    /****************************************************************/
+    /**    Only the previous and the new class are written, so     **/
+    /**    the expansion does not depend on the output length      **/
+    /****************************************************************/
+    if (*current < data->_output_length)
+    {
+        target[*current] = 0.;
+    }
+
+    if (class < data->_output_length)
+    {
+        target[class] = 1.;
+    }
+
+    *current = class;
+
+    return target;
+}
+
 static void
-csv_line_callback(void* data, BrainString label, const BrainReal* signal)
+decode_signal(void* data,
+              BrainString label,
+              const BrainReal* signal,
+              BrainSignal input,
+              BrainSignal output)
 {
     if (BRAIN_ALLOCATED(data) &&
         BRAIN_ALLOCATED(signal))
@@ -78,53 +234,25 @@ csv_line_callback(void* data, BrainString label, const BrainReal* signal)
         const BrainUint input_length        = pData->_input_length;
         const BrainUint output_length       = pData->_output_length;
         /****************************************************************/
-        /**              Randomly choose signal storage                **/
-        /****************************************************************/
-        Dataset* dataset = &(pData->_evaluating);
-        if (BRAIN_RAND_UNIT < TRAINING_DATASET_RATIO)
-        {
-            dataset = &(pData->_training);
-        }
-        /****************************************************************/
-        /**                        Append new signals                  **/
-        /****************************************************************/
-        ++(dataset->_children);
-        BRAIN_RESIZE(dataset->_input, BrainSignal, dataset->_children);
-        BRAIN_RESIZE(dataset->_output, BrainSignal, dataset->_children);
-        BRAIN_NEW(dataset->_input[dataset->_children - 1], BrainReal, input_length);
-        BRAIN_NEW(dataset->_output[dataset->_children - 1], BrainReal, output_length);
-        /****************************************************************/
         /**                COPY THE LABEL AND SIGNAL                    */
         /****************************************************************/
         if (pData->_is_labelled)
         {
             if (BRAIN_ALLOCATED(label))
             {
-                BrainUint i = 0;
-                BrainBool found = BRAIN_FALSE;
+                const BrainUint known = get_label_dictionary_size(pData->_labels);
+                const BrainUint id    = label_dictionary_intern(pData->_labels, label);
 
-                for (i = 0; i < pData->_labels_length; ++i)
-                {
-                    if (BRAIN_ALLOCATED(pData->_labels[i])
-                    &&  !strcmp(pData->_labels[i], label))
-                    {
-                        found = BRAIN_TRUE;
-                        dataset->_output[dataset->_children - 1][i] = 1.;
-                        break;
-                    }
-                }
+                // labelled outputs are stored as a class index
+                output[0] = (BrainReal)id;
 
-                if (!found)
+                if ((output_length <= id)
+                &&  (known <= id))
                 {
-                    const BrainUint length = strlen(label);
-                    ++pData->_labels_length;
-                    BRAIN_RESIZE(pData->_labels, BrainChar*, pData->_labels_length);
-                    BRAIN_NEW(pData->_labels[pData->_labels_length - 1], BrainChar, length);
-                    pData->_labels[pData->_labels_length - 1] = strcpy(pData->_labels[pData->_labels_length - 1], label);
-                    dataset->_output[dataset->_children - 1][pData->_labels_length - 1] = 1.;
+                    BRAIN_WARNING("Label %s has no output neuron\n", label);
                 }
 
-                BRAIN_COPY(signal, dataset->_input[dataset->_children - 1],BrainReal,input_length);
+                BRAIN_COPY(signal, input, BrainReal, input_length);
             }
         }
         else
@@ -137,11 +265,11 @@ csv_line_callback(void* data, BrainString label, const BrainReal* signal)
                 case Format_InputFirst:
                 {
                     BRAIN_COPY(signal,
-                                dataset->_input[dataset->_children - 1],
+                                input,
                                 BrainReal,
                                 input_length);
                     BRAIN_COPY(signal + input_length,
-                                dataset->_output[dataset->_children - 1],
+                                output,
                                 BrainReal,
                                 output_length);
                 }
@@ -149,11 +277,11 @@ csv_line_callback(void* data, BrainString label, const BrainReal* signal)
                 case Format_OutputFirst:
                 {
                     BRAIN_COPY(signal,
-                                dataset->_output[dataset->_children - 1],
+                                output,
                                 BrainReal,
                                 output_length);
                     BRAIN_COPY(signal + output_length,
-                                dataset->_input[dataset->_children - 1],
+                                input,
                                 BrainReal,
                                 input_length);
                 }
@@ -165,6 +293,426 @@ csv_line_callback(void* data, BrainString label, const BrainReal* signal)
     }
 }
 
+static void
+csv_line_callback(void* data, BrainString label, const BrainReal* signal)
+{
+    if (BRAIN_ALLOCATED(data) &&
+        BRAIN_ALLOCATED(signal))
+    {
+        BrainData pData = (BrainData)data;
+        RowStore* store = &(pData->_rows);
+        /****************************************************************/
+        /**      Append new signals, the split is done after loading   **/
+        /****************************************************************/
+        const BrainUint row = append_row(store, pData->_input_length, pData->_output_length, pData->_is_labelled);
+
+        if (pData->_is_labelled)
+        {
+            BrainReal class = 0.;
+
+            decode_signal(data,
+                          label,
+                          signal,
+                          get_row_input(pData, row),
+                          &class);
+
+            store->_classes[row] = (BrainUint)class;
+        }
+        else
+        {
+            decode_signal(data,
+                          label,
+                          signal,
+                          get_row_input(pData, row),
+                          store->_outputs + row * pData->_output_length);
+        }
+    }
+}
+
+static void
+stream_row_callback(void* data,
+                    const BrainSignal input,
+                    const BrainSignal output,
+                    const BrainBool holdout)
+{
+    if (BRAIN_ALLOCATED(data))
+    {
+        StreamPreparation* preparation = (StreamPreparation*)data;
+        BrainData pData = preparation->_data;
+        const BrainUint input_length  = pData->_input_length;
+        const BrainUint output_length = pData->_output_length;
+
+        if (holdout)
+        {
+            /************************************************************/
+            /**          Held out rows are kept for the evaluation     **/
+            /************************************************************/
+            RowStore* store = &(pData->_rows);
+            const BrainUint row = append_row(store, input_length, output_length, pData->_is_labelled);
+
+            BRAIN_COPY(input, get_row_input(pData, row), BrainReal, input_length);
+
+            if (pData->_is_labelled)
+            {
+                store->_classes[row] = (BrainUint)output[0];
+            }
+            else
+            {
+                BRAIN_COPY(output, store->_outputs + row * output_length, BrainReal, output_length);
+            }
+        }
+        else
+        {
+            /************************************************************/
+            /**      Accumulate statistics of the training signals     **/
+            /************************************************************/
+            accumulate_signal_statistics(preparation->_statistics, input);
+        }
+    }
+}
+
+static void
+compose_preprocessings(BrainData data,
+                       const BrainSignalStatistics statistics,
+                       const BrainReal* measured_scales,
+                       const BrainReal* measured_shifts)
+{
+    const BrainUint size = data->_input_length;
+    BrainSignal means     = NULL;
+    BrainSignal variances = NULL;
+    BrainSignal min       = NULL;
+    BrainSignal max       = NULL;
+    BrainSignal scales    = NULL;
+    BrainSignal shifts    = NULL;
+    BrainUint i = 0;
+    BrainUint j = 0;
+
+    BRAIN_NEW(means,     BrainReal, size);
+    BRAIN_NEW(variances, BrainReal, size);
+    BRAIN_NEW(min,       BrainReal, size);
+    BRAIN_NEW(max,       BrainReal, size);
+    BRAIN_NEW(scales,    BrainReal, size);
+    BRAIN_NEW(shifts,    BrainReal, size);
+
+    get_signal_statistics(statistics, means, variances, min, max);
+    /****************************************************************/
+    /**  Statistics measured on already preprocessed signals are   **/
+    /**  brought back to the raw signals through the inverse model **/
+    /****************************************************************/
+    if (BRAIN_ALLOCATED(measured_scales)
+    &&  BRAIN_ALLOCATED(measured_shifts))
+    {
+        for (j = 0; j < size; ++j)
+        {
+            const BrainDouble scale = (BrainDouble)measured_scales[j];
+            const BrainDouble shift = (BrainDouble)measured_shifts[j];
+
+            means[j]     = (BrainReal)(((BrainDouble)means[j] - shift) / scale);
+            variances[j] = (BrainReal)((BrainDouble)variances[j] / (scale * scale));
+            min[j]       = (BrainReal)(((BrainDouble)min[j] - shift) / scale);
+            max[j]       = (BrainReal)(((BrainDouble)max[j] - shift) / scale);
+        }
+    }
+
+    for (j = 0; j < size; ++j)
+    {
+        data->_scales[j] = 1.;
+        data->_shifts[j] = 0.;
+    }
+    /****************************************************************/
+    /**  Each model is affine, so the statistics of the signals    **/
+    /**  seen by the next model are derived from the current ones, **/
+    /**  and all models compose into a single scale and shift      **/
+    /****************************************************************/
+    for (i = 0; i < data->_number_of_preprocessing; ++i)
+    {
+        PreprocessingModel* model = &(data->_preprocessings[i]);
+
+        switch(model->_type)
+        {
+            case Preprocessing_GaussianNormalization:
+            {
+                BRAIN_COPY(means,     model->_first,  BrainReal, size);
+                BRAIN_COPY(variances, model->_second, BrainReal, size);
+                GetGaussianScale(means, variances, scales, shifts, size);
+            }
+                break;
+            case Preprocessing_MinMaxNormalization:
+            {
+                BRAIN_COPY(min, model->_first,  BrainReal, size);
+                BRAIN_COPY(max, model->_second, BrainReal, size);
+                GetMinMaxScale(min, max, scales, shifts, size);
+            }
+                break;
+            default:
+            {
+                for (j = 0; j < size; ++j)
+                {
+                    scales[j] = 1.;
+                    shifts[j] = 0.;
+                }
+            }
+                break;
+        }
+
+        for (j = 0; j < size; ++j)
+        {
+            // scales are always positive so min and max keep their order
+            means[j]     = means[j] * scales[j] + shifts[j];
+            variances[j] = variances[j] * scales[j] * scales[j];
+            min[j]       = min[j] * scales[j] + shifts[j];
+            max[j]       = max[j] * scales[j] + shifts[j];
+
+            data->_scales[j] *= scales[j];
+            data->_shifts[j]  = data->_shifts[j] * scales[j] + shifts[j];
+        }
+    }
+
+    BRAIN_DELETE(means);
+    BRAIN_DELETE(variances);
+    BRAIN_DELETE(min);
+    BRAIN_DELETE(max);
+    BRAIN_DELETE(scales);
+    BRAIN_DELETE(shifts);
+}
+
+static void
+apply_preprocessings(const BrainData data, BrainSignal signal)
+{
+    const BrainReal* scales = data->_scales;
+    const BrainReal* shifts = data->_shifts;
+    BrainUint j = 0;
+
+    for (j = 0; j < data->_input_length; ++j)
+    {
+        signal[j] = signal[j] * scales[j] + shifts[j];
+    }
+}
+
+static void
+fit_preprocessings(BrainData data)
+{
+    if (0 < data->_number_of_preprocessing)
+    {
+        RowStore* store = &(data->_rows);
+        BrainSignal* rows = get_row_pointers(store->_inputs, NULL, store->_number_of_rows, data->_input_length);
+        BrainSignal* training = get_row_pointers(store->_inputs,
+                                                 data->_training._index,
+                                                 data->_training._children,
+                                                 data->_input_length);
+        BrainSignalStatistics statistics = new_signal_statistics(data->_input_length);
+        BrainSignal former_scales = NULL;
+        BrainSignal former_shifts = NULL;
+        BrainUint j = 0;
+
+        BRAIN_NEW(former_scales, BrainReal, data->_input_length);
+        BRAIN_NEW(former_shifts, BrainReal, data->_input_length);
+
+        if (data->_preprocessed)
+        {
+            BRAIN_COPY(data->_scales, former_scales, BrainReal, data->_input_length);
+            BRAIN_COPY(data->_shifts, former_shifts, BrainReal, data->_input_length);
+        }
+        else
+        {
+            for (j = 0; j < data->_input_length; ++j)
+            {
+                former_scales[j] = 1.;
+                former_shifts[j] = 0.;
+            }
+        }
+        /************************************************************/
+        /**  Models are fitted on the training view in one pass,   **/
+        /**  from the statistics of the rows as they are stored    **/
+        /************************************************************/
+        find_signal_statistics(statistics, training, data->_training._children);
+        compose_preprocessings(data, statistics, former_scales, former_shifts);
+        /************************************************************/
+        /**  Rows go from the former model to the new one in a     **/
+        /**  single pass and are rounded once per refit, so they   **/
+        /**  stay within an ulp of the new model applied to the    **/
+        /**  raw signals, plus at worst an ulp per former refit    **/
+        /************************************************************/
+        ReplaceAffineModel(rows,
+                           former_scales,
+                           former_shifts,
+                           data->_scales,
+                           data->_shifts,
+                           store->_number_of_rows,
+                           data->_input_length);
+
+        data->_preprocessed = BRAIN_TRUE;
+
+        BRAIN_DELETE(former_scales);
+        BRAIN_DELETE(former_shifts);
+        delete_signal_statistics(statistics);
+        BRAIN_DELETE(training);
+        BRAIN_DELETE(rows);
+    }
+}
+
+static void
+set_dataset_view(Dataset* dataset, const BrainUint* rows, const BrainUint number_of_rows)
+{
+    BRAIN_RESIZE_TAG(dataset->_index, BrainUint, number_of_rows, Memory_Dataset);
+    if (0 < number_of_rows)
+    {
+        BRAIN_COPY(rows, dataset->_index, BrainUint, number_of_rows);
+    }
+    dataset->_children = number_of_rows;
+}
+
+static void
+shuffle_indices(BrainRandom random, BrainUint* indices, const BrainUint number_of_indices)
+{
+    BrainUint i = 0;
+    /****************************************************************/
+    /**                    Fisher-Yates shuffle                    **/
+    /****************************************************************/
+    for (i = number_of_indices; 1 < i; --i)
+    {
+        const BrainUint j = random_index(random, i);
+        BrainUint tmp = 0;
+
+        tmp = indices[i - 1];
+        indices[i - 1] = indices[j];
+        indices[j]     = tmp;
+    }
+}
+
+static void
+shuffle_order(BrainData data)
+{
+    const BrainUint number_of_rows = data->_rows._number_of_rows;
+    BrainUint i = 0;
+
+    for (i = 0; i < number_of_rows; ++i)
+    {
+        data->_order[i] = i;
+    }
+
+    shuffle_indices(get_thread_random(), data->_order, number_of_rows);
+}
+
+static void
+reset_sampler(BrainData data)
+{
+    const BrainUint number_of_training = data->_training._children;
+
+    if ((data->_sampling == Sampling_BlockShuffle)
+    &&  (0 < number_of_training))
+    {
+        /************************************************************/
+        /**   Sort the training view by row, so that a block of    **/
+        /**   samples is a block of neighbour rows in the store    **/
+        /************************************************************/
+        const BrainUint number_of_rows = data->_rows._number_of_rows;
+        BrainBool* is_training = NULL;
+        BrainUint i = 0;
+        BrainUint k = 0;
+
+        BRAIN_NEW(is_training, BrainBool, number_of_rows);
+
+        for (i = 0; i < number_of_training; ++i)
+        {
+            is_training[data->_training._index[i]] = BRAIN_TRUE;
+        }
+
+        for (i = 0; i < number_of_rows; ++i)
+        {
+            if (is_training[i])
+            {
+                data->_training._index[k] = i;
+                ++k;
+            }
+        }
+
+        BRAIN_DELETE(is_training);
+    }
+
+    data->_cursor = 0;
+    data->_served = 0;
+}
+
+static void
+shuffle_epoch(BrainData data)
+{
+    const BrainUint number_of_training = data->_training._children;
+    BrainRandom random = get_thread_random();
+    BrainUint i = 0;
+
+    BRAIN_RESIZE_TAG(data->_epoch, BrainUint, number_of_training, Memory_Dataset);
+
+    if (data->_sampling == Sampling_BlockShuffle)
+    {
+        /************************************************************/
+        /**  Visit the blocks in a random order, and the samples   **/
+        /**  of a block in a random order too                      **/
+        /************************************************************/
+        const BrainUint block_size = data->_block_size;
+        const BrainUint number_of_blocks = (number_of_training + block_size - 1) / block_size;
+        BrainUint k = 0;
+
+        BRAIN_RESIZE_TAG(data->_blocks, BrainUint, number_of_blocks, Memory_Dataset);
+
+        for (i = 0; i < number_of_blocks; ++i)
+        {
+            data->_blocks[i] = i;
+        }
+
+        shuffle_indices(random, data->_blocks, number_of_blocks);
+
+        for (i = 0; i < number_of_blocks; ++i)
+        {
+            const BrainUint begin = data->_blocks[i] * block_size;
+            BrainUint end = begin + block_size;
+            BrainUint j = 0;
+
+            if (number_of_training < end)
+            {
+                end = number_of_training;
+            }
+
+            for (j = begin; j < end; ++j)
+            {
+                data->_epoch[k + j - begin] = j;
+            }
+
+            shuffle_indices(random, data->_epoch + k, end - begin);
+            k += end - begin;
+        }
+    }
+    else
+    {
+        for (i = 0; i < number_of_training; ++i)
+        {
+            data->_epoch[i] = i;
+        }
+
+        shuffle_indices(random, data->_epoch, number_of_training);
+    }
+}
+
+static void
+split_order(BrainData data)
+{
+    const BrainUint number_of_rows     = data->_rows._number_of_rows;
+    const BrainUint number_of_training = (BrainUint)(data->_training_ratio * (BrainReal)number_of_rows + 0.5);
+    const BrainUint number_of_evaluating = number_of_rows - number_of_training;
+
+    set_dataset_view(&(data->_training),   data->_order, number_of_training);
+    set_dataset_view(&(data->_evaluating), data->_order + number_of_training, number_of_evaluating);
+
+    reset_sampler(data);
+}
+
+static void
+delete_dataset(Dataset* dataset)
+{
+    BRAIN_DELETE(dataset->_index);
+    dataset->_children = 0;
+}
+
 static BrainData
 new_data(BrainString repository_path,
          BrainString tokenizer,
@@ -174,21 +722,53 @@ new_data(BrainString repository_path,
          const BrainBool is_labedelled,
          const BrainDataFormat format,
          const BrainUint number_of_preprocessing,
-         const DataPreprocessing* preprocessings)
+         const DataPreprocessing* preprocessings,
+         const BrainUint stream_buffer_size,
+         const BrainUint evaluating_size,
+         BrainString cache_path,
+         const BrainReal training_ratio,
+         Context labels_context)
 {
     BrainData _data = NULL;
 
     if (repository_path)
     {
+        StreamPreparation preparation;
         BrainUint i = 0;
 
         BRAIN_NEW(_data, Data, 1);
 
         _data->_input_length    = input_length;
         _data->_output_length   = output_length;
-        _data->_labels_length   = 0;
+        _data->_labels          = NULL;
         _data->_is_labelled     = is_labedelled;
         _data->_format          = format;
+        _data->_stream          = NULL;
+        _data->_served          = 0;
+        _data->_sampling        = Sampling_Shuffle;
+        _data->_block_size      = BRAIN_SAMPLING_BLOCK_SIZE;
+        _data->_epoch           = NULL;
+        _data->_blocks          = NULL;
+        _data->_cursor          = 0;
+        _data->_order           = NULL;
+        _data->_training_ratio  = training_ratio;
+        _data->_preprocessed    = BRAIN_FALSE;
+        _data->_training_class  = output_length;
+        _data->_evaluating_class= output_length;
+
+        BRAIN_NEW_TAG(_data->_training_target,   BrainReal, output_length, Memory_Dataset);
+        BRAIN_NEW_TAG(_data->_evaluating_target, BrainReal, output_length, Memory_Dataset);
+
+        memset(&preparation, 0, sizeof(StreamPreparation));
+
+        if (_data->_is_labelled)
+        {
+            /************************************************************/
+            /**     Labels listed with the data keep their position    **/
+            /************************************************************/
+            _data->_labels = new_label_dictionary();
+            deserialize_label_dictionary(_data->_labels, labels_context);
+        }
 
         printf("Format: %d", format);
 
@@ -197,79 +777,97 @@ new_data(BrainString repository_path,
         {
             case Parser_CSV:
             {
-                const BrainUint number_of_fields = _data->_is_labelled ? _data->_input_length: _data->_input_length + _data->_output_length;
-                // Create a CSV reader
-                BrainCsvReader reader = new_csv_reader(repository_path,
-                                                       tokenizer,
-                                                       number_of_fields,
-                                                       _data->_format,
-                                                       _data->_is_labelled);
-                // Load the CSV file
-                csv_reader_load(reader, csv_line_callback, _data);
-                // Delete the CSV reader
-                delete_csv_reader(reader);
+                if (0 < stream_buffer_size)
+                {
+                    /****************************************************/
+                    /**   Training rows are streamed from the disk     **/
+                    /****************************************************/
+                    // labelled rows are streamed with their class index only
+                    _data->_stream = new_data_stream(repository_path,
+                                                     tokenizer,
+                                                     _data->_format,
+                                                     _data->_is_labelled,
+                                                     _data->_input_length,
+                                                     _data->_is_labelled ? 1 : _data->_output_length,
+                                                     stream_buffer_size,
+                                                     cache_path,
+                                                     decode_signal,
+                                                     _data);
+
+                    set_data_stream_labels(_data->_stream, _data->_labels);
+                    set_data_stream_holdout(_data->_stream,
+                                            training_ratio,
+                                            evaluating_size);
+
+                    preparation._data       = _data;
+                    preparation._statistics = new_signal_statistics(_data->_input_length);
+
+                    data_stream_prepare(_data->_stream, stream_row_callback, &preparation);
+                }
+                else
+                {
+                    const BrainUint number_of_fields = _data->_is_labelled ? _data->_input_length: _data->_input_length + _data->_output_length;
+                    // Create a CSV reader
+                    BrainCsvReader reader = new_csv_reader(repository_path,
+                                                           tokenizer,
+                                                           number_of_fields,
+                                                           _data->_format,
+                                                           _data->_is_labelled);
+                    // Load the CSV file
+                    csv_reader_load(reader, csv_line_callback, _data);
+                    // Delete the CSV reader
+                    delete_csv_reader(reader);
+                }
             }
                 break;
             default:
                 break;
         }
 
+        _data->_number_of_preprocessing = number_of_preprocessing;
+        BRAIN_NEW(_data->_preprocessings, PreprocessingModel, number_of_preprocessing);
+        BRAIN_NEW(_data->_scales, BrainReal, _data->_input_length);
+        BRAIN_NEW(_data->_shifts, BrainReal, _data->_input_length);
+
         for (i = 0; i < number_of_preprocessing; ++i)
         {
-            switch(preprocessings[i])
+            PreprocessingModel* model = &(_data->_preprocessings[i]);
+
+            model->_type = preprocessings[i];
+            BRAIN_NEW(model->_first,  BrainReal, _data->_input_length);
+            BRAIN_NEW(model->_second, BrainReal, _data->_input_length);
+        }
+
+        BRAIN_NEW_TAG(_data->_order, BrainUint, _data->_rows._number_of_rows, Memory_Dataset);
+        shuffle_order(_data);
+
+        if (BRAIN_ALLOCATED(_data->_stream))
+        {
+            /************************************************************/
+            /**   The store only contains the held out rows and the    **/
+            /**   streamed rows are normalized when served             **/
+            /************************************************************/
+            const BrainUint number_of_rows = _data->_rows._number_of_rows;
+            BrainSignal* rows = get_row_pointers(_data->_rows._inputs, NULL, number_of_rows, _data->_input_length);
+
+            set_dataset_view(&(_data->_evaluating), _data->_order, number_of_rows);
+
+            if (0 < number_of_preprocessing)
             {
-                case Preprocessing_GaussianNormalization:
-                {
-                    GaussianModel model;
-
-                    BRAIN_NEW(model._means, BrainReal,  _data->_input_length);
-                    BRAIN_NEW(model._sigmas, BrainReal, _data->_input_length);
-
-                    FindGaussianModel(_data->_training._input,
-                                      model._means,
-                                      model._sigmas,
-                                      _data->_training._children,
-                                      _data->_input_length);
-                    ApplyGaussianModel(_data->_training._input,
-                                       model._means,
-                                       model._sigmas,
-                                       _data->_training._children,
-                                       _data->_input_length);
-                    ApplyGaussianModel(_data->_evaluating._input,
-                                       model._means,
-                                       model._sigmas,
-                                       _data->_evaluating._children,
-                                       _data->_input_length);
-                }
-                    break;
-                case Preprocessing_MinMaxNormalization:
-                {
-                    MinMaxModel model;
-
-                    BRAIN_NEW(model._min, BrainReal, _data->_input_length);
-                    BRAIN_NEW(model._max, BrainReal, _data->_input_length);
-
-                    FindMinMaxModel(_data->_training._input,
-                                    model._min,
-                                    model._max,
-                                    _data->_training._children,
-                                    _data->_input_length);
-                    ApplyMinMaxModel(_data->_training._input,
-                                       model._min,
-                                       model._max,
-                                       _data->_training._children,
-                                       _data->_input_length);
-                    ApplyMinMaxModel(_data->_evaluating._input,
-                                       model._min,
-                                       model._max,
-                                       _data->_evaluating._children,
-                                       _data->_input_length);
-                }
-                    break;
-                default:
-                    break;
+                compose_preprocessings(_data, preparation._statistics, NULL, NULL);
+                ApplyAffineModel(rows, _data->_scales, _data->_shifts, number_of_rows, _data->_input_length);
+                _data->_preprocessed = BRAIN_TRUE;
             }
+
+            BRAIN_DELETE(rows);
         }
+        else
+        {
+            split_order(_data);
+            fit_preprocessings(_data);
+        }
+
+        delete_signal_statistics(preparation._statistics);
     }
 
     return _data;
@@ -304,17 +902,29 @@ new_data_from_context(BrainString filepath)
                 const BrainUint output_length   = node_get_int(context, "output-length", 1);
                 buffer = (BrainChar *)node_get_prop(context, "format");
                 const BrainDataFormat format = get_enum_values(_formats, Format_First, Format_Last, buffer);
-                //BRAIN_DELETE(buffer);
+                xmlFree(buffer);
                 buffer = (BrainChar *)node_get_prop(context, "parser");
                 const DataParser parser = get_enum_values(_parsers, Parser_First, Parser_Last, buffer);
-                //BRAIN_DELETE(buffer);
+                xmlFree(buffer);
                 if (parser == Parser_CSV)
                 {
                     tokenizer = (BrainChar *)node_get_prop(context, "tokenizer");
                 }
 
                 const BrainBool labelled = node_get_bool(context, "labels", BRAIN_FALSE);
+                const BrainReal training_ratio = (BrainReal)node_get_double(context, "training-ratio", TRAINING_DATASET_RATIO);
                 const BrainUint number_of_preprocessing = get_number_of_node_with_name(context, "preprocess");
+                Context stream_context = get_node_with_name_and_index(context, "stream", 0);
+                BrainUint stream_buffer_size = 0;
+                BrainUint evaluating_size = 0;
+                BrainChar* cache = NULL;
+
+                if (BRAIN_ALLOCATED(stream_context))
+                {
+                    stream_buffer_size = node_get_int(stream_context, "buffer-size", 4096);
+                    evaluating_size    = node_get_int(stream_context, "evaluating-size", stream_buffer_size);
+                    cache              = (BrainChar*)node_get_prop(stream_context, "cache");
+                }
 
                 BRAIN_NEW(preprocessings, DataPreprocessing, number_of_preprocessing);
                 for (i = 0; i < number_of_preprocessing; ++i)
@@ -322,6 +932,7 @@ new_data_from_context(BrainString filepath)
                     Context preprocessings_context = get_node_with_name_and_index(context, "preprocess", i);
                     buffer = (BrainChar*)node_get_prop(preprocessings_context, "type");
                     preprocessings[i] = get_enum_values(_preprocessings, Preprocessing_First, Preprocessing_Last, buffer);
+                    xmlFree(buffer);
                 }
 
                 data = new_data(repository,
@@ -332,12 +943,21 @@ new_data_from_context(BrainString filepath)
                                 labelled,
                                 format,
                                 number_of_preprocessing,
-                                preprocessings);
+                                preprocessings,
+                                stream_buffer_size,
+                                evaluating_size,
+                                cache,
+                                training_ratio,
+                                context);
 
                 BRAIN_DELETE(preprocessings);
-                //BRAIN_DELETE(tokenizer);
-                //BRAIN_DELETE(repository);
+                // attributes come from libxml2, not from BRAIN_NEW
+                xmlFree(cache);
+                xmlFree(tokenizer);
+                xmlFree(repository);
             }
+
+            close_document(data_document);
         }
     }
     else
@@ -374,7 +994,12 @@ new_data_with_parameters(const BrainDataParameters parameters)
                         parameters->is_labedelled,
                         format,
                         1,
-                        preprocessings);
+                        preprocessings,
+                        0,
+                        0,
+                        NULL,
+                        TRAINING_DATASET_RATIO,
+                        NULL);
     }
 
     BRAIN_OUTPUT(new_data_with_parameters)
@@ -388,41 +1013,63 @@ delete_data(BrainData data)
     if (BRAIN_ALLOCATED(data))
     {
         BrainUint k = 0;
-        BrainUint m = data->_training._children;
-        if (m < data->_evaluating._children)
-        {
-            m = data->_evaluating._children;
 
-            if (m < data->_labels_length)
-            {
-                m = data->_labels_length;
-            }
+        for (k = 0; k < data->_number_of_preprocessing; ++k)
+        {
+            BRAIN_DELETE(data->_preprocessings[k]._first);
+            BRAIN_DELETE(data->_preprocessings[k]._second);
         }
 
-        for (k = 0; k < m; ++k)
+        delete_data_stream(data->_stream);
+        delete_dataset(&(data->_evaluating));
+        delete_dataset(&(data->_training));
+
+        BRAIN_DELETE(data->_rows._inputs);
+        BRAIN_DELETE(data->_rows._outputs);
+        BRAIN_DELETE(data->_rows._classes);
+        BRAIN_DELETE(data->_order);
+        BRAIN_DELETE(data->_epoch);
+        BRAIN_DELETE(data->_blocks);
+        delete_label_dictionary(data->_labels);
+        BRAIN_DELETE(data->_training_target);
+        BRAIN_DELETE(data->_evaluating_target);
+        BRAIN_DELETE(data->_preprocessings);
+        BRAIN_DELETE(data->_scales);
+        BRAIN_DELETE(data->_shifts);
+        BRAIN_DELETE(data);
+    }
+}
+
+void
+accumulate_data_memory(const BrainData data, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(data))
+    {
+        BrainUint k = 0;
+
+        for (k = 0; k < data->_number_of_preprocessing; ++k)
         {
-            if (k < data->_evaluating._children)
-            {
-                BRAIN_DELETE(data->_evaluating._input[k]);
-                BRAIN_DELETE(data->_evaluating._output[k]);
-            }
-            if (k < data->_training._children)
-            {
-                BRAIN_DELETE(data->_training._input[k]);
-                BRAIN_DELETE(data->_training._output[k]);
-            }
-            if (k < data->_labels_length)
-            {
-                BRAIN_DELETE(data->_labels[k]);
-            }
+            accumulate_memory_usage(usage, data->_preprocessings[k]._first);
+            accumulate_memory_usage(usage, data->_preprocessings[k]._second);
         }
 
-        BRAIN_DELETE(data->_labels);
-        BRAIN_DELETE(data->_evaluating._input);
-        BRAIN_DELETE(data->_evaluating._output);
-        BRAIN_DELETE(data->_training._input);
-        BRAIN_DELETE(data->_training._output);
-        BRAIN_DELETE(data);
+        accumulate_data_stream_memory(data->_stream, usage);
+        accumulate_label_dictionary_memory(data->_labels, usage);
+
+        accumulate_memory_usage(usage, data->_evaluating._index);
+        accumulate_memory_usage(usage, data->_training._index);
+        accumulate_memory_usage(usage, data->_rows._inputs);
+        accumulate_memory_usage(usage, data->_rows._outputs);
+        accumulate_memory_usage(usage, data->_rows._classes);
+        accumulate_memory_usage(usage, data->_order);
+        accumulate_memory_usage(usage, data->_epoch);
+        accumulate_memory_usage(usage, data->_blocks);
+        accumulate_memory_usage(usage, data->_training_target);
+        accumulate_memory_usage(usage, data->_evaluating_target);
+        accumulate_memory_usage(usage, data->_preprocessings);
+        accumulate_memory_usage(usage, data->_scales);
+        accumulate_memory_usage(usage, data->_shifts);
+        accumulate_memory_usage(usage, data);
     }
 }
 
@@ -447,7 +1094,7 @@ get_evaluating_input_signal(const BrainData data, const BrainUint index)
     if (BRAIN_ALLOCATED(data)
     &&  (index < data->_evaluating._children))
     {
-        ret = data->_evaluating._input[index];
+        ret = get_row_input(data, data->_evaluating._index[index]);
     }
 
     return ret;
@@ -461,7 +1108,17 @@ get_evaluating_output_signal(const BrainData data, const BrainUint index)
     if (BRAIN_ALLOCATED(data)
     &&  (index < data->_evaluating._children))
     {
-        ret = data->_evaluating._output[index];
+        if (data->_is_labelled)
+        {
+            ret = expand_class(data,
+                               data->_evaluating_target,
+                               &(data->_evaluating_class),
+                               data->_rows._classes[data->_evaluating._index[index]]);
+        }
+        else
+        {
+            ret = data->_rows._outputs + data->_evaluating._index[index] * data->_output_length;
+        }
     }
 
     return ret;
@@ -474,7 +1131,132 @@ get_number_of_training_sample(const BrainData data)
 
     if (BRAIN_ALLOCATED(data))
     {
-        ret = data->_training._children;
+        if (BRAIN_ALLOCATED(data->_stream))
+        {
+            ret = (BrainUint)get_data_stream_number_of_rows(data->_stream);
+        }
+        else
+        {
+            ret = data->_training._children;
+        }
+    }
+
+    return ret;
+}
+
+BrainBool
+get_next_training_sample(BrainData data, BrainSignal* input, BrainSignal* output)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(data)
+    &&  BRAIN_ALLOCATED(input)
+    &&  BRAIN_ALLOCATED(output))
+    {
+        if (BRAIN_ALLOCATED(data->_stream))
+        {
+            ret = data_stream_next(data->_stream, input, output);
+
+            if (ret)
+            {
+                if (data->_is_labelled)
+                {
+                    *output = expand_class(data,
+                                           data->_training_target,
+                                           &(data->_training_class),
+                                           (BrainUint)((*output)[0]));
+                }
+
+                if (data->_preprocessed)
+                {
+                    apply_preprocessings(data, *input);
+                }
+            }
+        }
+        else if (0 < data->_training._children)
+        {
+            BrainUint index = 0;
+
+            if (data->_sampling == Sampling_Random)
+            {
+                index = random_index(get_thread_random(), data->_training._children);
+            }
+            else
+            {
+                /****************************************************/
+                /**  Walk a permutation of the training samples,   **/
+                /**  which is drawn again at each epoch            **/
+                /****************************************************/
+                if (data->_cursor == 0)
+                {
+                    shuffle_epoch(data);
+                }
+
+                index = data->_epoch[data->_cursor];
+
+                ++data->_cursor;
+                if (data->_training._children <= data->_cursor)
+                {
+                    data->_cursor = 0;
+                }
+            }
+
+            *input  = get_training_input_signal(data, index);
+            *output = get_training_output_signal(data, index);
+            ret = BRAIN_TRUE;
+        }
+
+        if (ret)
+        {
+            // the epoch may be read by another thread than the loader
+            __atomic_store_n(&(data->_served), data->_served + 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    return ret;
+}
+
+void
+set_data_sampling(BrainData data, BrainString sampling, const BrainUint block_size)
+{
+    BRAIN_INPUT(set_data_sampling)
+
+    if (BRAIN_ALLOCATED(data)
+    &&  BRAIN_ALLOCATED(sampling))
+    {
+        const DataSampling value = get_enum_values(_samplings, Sampling_First, Sampling_Last, sampling);
+
+        if (value == Sampling_Invalide)
+        {
+            BRAIN_WARNING("Unknown sampling %s\n", sampling);
+        }
+        else
+        {
+            data->_sampling   = value;
+            data->_block_size = (0 < block_size) ? block_size : BRAIN_SAMPLING_BLOCK_SIZE;
+
+            reset_sampler(data);
+        }
+    }
+
+    BRAIN_OUTPUT(set_data_sampling)
+}
+
+BrainUint
+get_data_epoch(const BrainData data)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(data))
+    {
+        if (BRAIN_ALLOCATED(data->_stream))
+        {
+            ret = get_data_stream_epoch(data->_stream);
+        }
+        else if (0 < data->_training._children)
+        {
+            ret = (BrainUint)(__atomic_load_n(&(data->_served), __ATOMIC_RELAXED) / data->_training._children);
+        }
     }
 
     return ret;
@@ -488,7 +1270,7 @@ get_training_input_signal(const BrainData data, const BrainUint index)
     if (BRAIN_ALLOCATED(data)
     &&  (index < data->_training._children))
     {
-        ret = data->_training._input[index];
+        ret = get_row_input(data, data->_training._index[index]);
     }
 
     return ret;
@@ -502,7 +1284,17 @@ get_training_output_signal(const BrainData data, const BrainUint index)
     if (BRAIN_ALLOCATED(data)
     &&  (index < data->_training._children))
     {
-        ret = data->_training._output[index];
+        if (data->_is_labelled)
+        {
+            ret = expand_class(data,
+                               data->_training_target,
+                               &(data->_training_class),
+                               data->_rows._classes[data->_training._index[index]]);
+        }
+        else
+        {
+            ret = data->_rows._outputs + data->_training._index[index] * data->_output_length;
+        }
     }
 
     return ret;
@@ -529,3 +1321,148 @@ get_output_signal_length(const BrainData data)
 
     return 0;
 }
+
+BrainLabelDictionary
+get_data_labels(const BrainData data)
+{
+    BrainLabelDictionary ret = NULL;
+
+    if (BRAIN_ALLOCATED(data))
+    {
+        ret = data->_labels;
+    }
+
+    return ret;
+}
+
+BrainReal
+get_data_training_ratio(const BrainData data)
+{
+    BrainReal ret = 0.;
+
+    if (BRAIN_ALLOCATED(data))
+    {
+        ret = data->_training_ratio;
+    }
+
+    return ret;
+}
+
+BrainBool
+is_data_streamed(const BrainData data)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(data))
+    {
+        ret = BRAIN_ALLOCATED(data->_stream);
+    }
+
+    return ret;
+}
+
+BrainSignal
+get_data_preprocessing_scales(const BrainData data)
+{
+    BrainSignal ret = NULL;
+
+    if (BRAIN_ALLOCATED(data)
+    &&  data->_preprocessed)
+    {
+        ret = data->_scales;
+    }
+
+    return ret;
+}
+
+BrainSignal
+get_data_preprocessing_shifts(const BrainData data)
+{
+    BrainSignal ret = NULL;
+
+    if (BRAIN_ALLOCATED(data)
+    &&  data->_preprocessed)
+    {
+        ret = data->_shifts;
+    }
+
+    return ret;
+}
+
+void
+split_data(BrainData data, const BrainReal training_ratio)
+{
+    BRAIN_INPUT(split_data)
+
+    if (BRAIN_ALLOCATED(data)
+    &&  (0. <= training_ratio)
+    &&  (training_ratio <= 1.))
+    {
+        if (BRAIN_ALLOCATED(data->_stream))
+        {
+            BRAIN_WARNING("A streamed data can not be split again\n");
+        }
+        else
+        {
+            data->_training_ratio = training_ratio;
+
+            shuffle_order(data);
+            split_order(data);
+            fit_preprocessings(data);
+        }
+    }
+
+    BRAIN_OUTPUT(split_data)
+}
+
+BrainBool
+select_data_fold(BrainData data, const BrainUint number_of_folds, const BrainUint fold)
+{
+    BRAIN_INPUT(select_data_fold)
+
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(data)
+    &&  (1 < number_of_folds)
+    &&  (fold < number_of_folds))
+    {
+        if (BRAIN_ALLOCATED(data->_stream))
+        {
+            BRAIN_WARNING("A streamed data can not be folded\n");
+        }
+        else if (data->_rows._number_of_rows < number_of_folds)
+        {
+            // some folds would be empty and evaluate nothing
+            BRAIN_WARNING("%u folds of %u rows\n", number_of_folds, data->_rows._number_of_rows);
+        }
+        else
+        {
+            const BrainUint number_of_rows = data->_rows._number_of_rows;
+            const BrainUint begin = (BrainUint)(((BrainUlong)fold * number_of_rows) / number_of_folds);
+            const BrainUint end   = (BrainUint)(((BrainUlong)(fold + 1) * number_of_rows) / number_of_folds);
+            const BrainUint number_of_training = number_of_rows - (end - begin);
+            const BrainUint number_of_tail     = number_of_rows - end;
+            /************************************************************/
+            /**   The fold is a slice of the shuffled order, and the   **/
+            /**   training view is made of the two surrounding slices  **/
+            /************************************************************/
+            set_dataset_view(&(data->_evaluating), data->_order + begin, end - begin);
+            set_dataset_view(&(data->_training),   data->_order, begin);
+
+            BRAIN_RESIZE_TAG(data->_training._index, BrainUint, number_of_training, Memory_Dataset);
+            if (0 < number_of_tail)
+            {
+                BRAIN_COPY(data->_order + end, data->_training._index + begin, BrainUint, number_of_tail);
+            }
+            data->_training._children = number_of_training;
+
+            reset_sampler(data);
+            fit_preprocessings(data);
+            ret = BRAIN_TRUE;
+        }
+    }
+
+    BRAIN_OUTPUT(select_data_fold)
+
+    return ret;
+}
@@ -28,6 +28,23 @@ static BrainActivationFunction _activation_functions[][2] = {{identity,
                                                        {sinusoid,           sinusoid_derivative},
                                                        {relu,               relu_derivative}};
 
+static BrainActivationFunction _fast_activation_functions[] = {identity,
+                                                               fast_sigmoid,
+                                                               fast_tangeant_hyperbolic,
+                                                               fast_co_tangeant,
+                                                               fast_softplus,
+                                                               sinusoid,
+                                                               relu};
+
+// ArcTan and Sinus derivatives can not be cheaply written from the output
+static BrainGradientFunction _gradient_functions[] = {identity_gradient,
+                                                      sigmoid_gradient,
+                                                      tangeant_hyperbolic_gradient,
+                                                      NULL,
+                                                      softplus_gradient,
+                                                      NULL,
+                                                      relu_gradient};
+
 static BrainCostFunction _cost_functions[][2] = {{quadratic_cost,     quadratic_cost_derivative},
                                            {crossentropy_cost,  crossentropy_cost_derivative}};
 
@@ -90,6 +107,23 @@ brain_activation_function(BrainString name)
     return function;
 }
 
+BrainActivationFunction
+brain_fast_activation_function(BrainString name)
+{
+    BrainActivationFunction function = NULL;
+    BrainActivationType activation = Sigmoid;
+
+    if (BRAIN_ALLOCATED(name))
+    {
+        initialize_fast_activations();
+
+        activation  = get_enum_values(activation_name, First_Activation, Last_Activation, name);
+        function    = _fast_activation_functions[activation];
+    }
+
+    return function;
+}
+
 BrainActivationFunction
 brain_derivative_function(BrainString name)
 {
@@ -105,6 +139,21 @@ brain_derivative_function(BrainString name)
     return function;
 }
 
+BrainGradientFunction
+brain_gradient_function(BrainString name)
+{
+    BrainGradientFunction function = NULL;
+    BrainActivationType activation = Sigmoid;
+
+    if (BRAIN_ALLOCATED(name))
+    {
+        activation  = get_enum_values(activation_name, First_Activation, Last_Activation, name);
+        function    = _gradient_functions[activation];
+    }
+
+    return function;
+}
+
 BrainCostFunction
 brain_cost_function(BrainString name)
 {
@@ -0,0 +1,1041 @@
+#include "brain_kmeans_utils.h"
+#include "brain_signal_utils.h"
+#include "brain_thread_utils.h"
+#include "brain_random_utils.h"
+#include "brain_loader_utils.h"
+#include "brain_data_utils.h"
+#include "brain_logging_utils.h"
+#include "brain_memory_utils.h"
+
+#include <math.h>
+#include <float.h>
+
+#define BRAIN_KMEANS_GRAIN          1024
+#define BRAIN_KMEANS_CENTER_GRAIN   16
+#define BRAIN_KMEANS_BLOCK          64
+#define BRAIN_KMEANS_MAX_ITERATIONS 300
+#define BRAIN_KMEANS_TOLERANCE      1e-4
+
+/**
+ * \struct KMeans
+ * \brief  Internal model for a BrainKMeans
+ */
+typedef struct KMeans
+{
+    BrainUint    _number_of_clusters; /*!< Number of clusters              */
+    BrainUint    _size;               /*!< Signal length                   */
+    BrainUint    _max_iterations;     /*!< Maximum number of iterations    */
+    BrainReal    _tolerance;          /*!< Relative convergence tolerance  */
+    BrainReal*   _centers;            /*!< Centers, one row per cluster    */
+    BrainDouble* _counts;             /*!< Signals seen by each center     */
+    BrainBool    _seeded;             /*!< Centers have been initialized   */
+    BrainDouble  _inertia;            /*!< Inertia of the last fit         */
+} KMeans;
+
+/**
+ * \struct KMeansWorkspace
+ * \brief  Per thread buffers of a fit
+ *
+ * Cluster sums are not recomputed each iteration, each thread records
+ * the contribution of the signals it moved and the deltas are merged
+ */
+typedef struct KMeansWorkspace
+{
+    BrainDouble* _sums;       /*!< Delta of the cluster sums            */
+    BrainDouble* _counts;     /*!< Delta of the cluster sizes           */
+    BrainDouble* _distances;  /*!< Block of squared distances           */
+    BrainUint*   _rows;       /*!< Signals of the current block         */
+    BrainUint    _changed;    /*!< Number of signals that moved         */
+    BrainDouble  _cost;       /*!< Partial sum of squared distances     */
+} KMeansWorkspace;
+
+/**
+ * \struct KMeansTask
+ * \brief  State shared by all threads during a fit
+ *
+ * Bounds are Euclidean distances: _upper is at least the distance of a
+ * signal to its center, _lower is at most its distance to any other
+ * center. A signal whose upper bound is below both its lower bound and
+ * half the gap between its center and the closest other one can not
+ * change of cluster.
+ */
+typedef struct KMeansTask
+{
+    BrainKMeans      _kmeans;            /*!< The fitted model                */
+    BrainReal**      _signals;           /*!< Signals to cluster              */
+    BrainUint*       _labels;            /*!< Cluster of each signal          */
+    BrainDouble*     _row_norms;         /*!< Squared norm of each signal     */
+    BrainDouble*     _center_norms;      /*!< Squared norm of each center     */
+    BrainDouble*     _upper;             /*!< Upper bound of each signal      */
+    BrainDouble*     _lower;             /*!< Lower bound of each signal      */
+    BrainDouble*     _half_gaps;         /*!< Half distance to closest center */
+    BrainDouble*     _movements;         /*!< Last movement of each center    */
+    BrainDouble*     _nearest;           /*!< Seeding squared distances       */
+    BrainDouble*     _sums;              /*!< Cluster sums                    */
+    BrainDouble*     _counts;            /*!< Cluster sizes                   */
+    BrainUint        _seed;              /*!< Last seeded center              */
+    BrainUint        _farthest;          /*!< Center with the largest move    */
+    BrainDouble      _largest_movement;  /*!< Largest center movement         */
+    BrainDouble      _second_movement;   /*!< Second largest center movement  */
+    KMeansWorkspace* _workspaces;        /*!< One workspace per thread        */
+    BrainUint        _number_of_threads; /*!< Number of threads               */
+} KMeansTask;
+
+static BrainDouble
+squared_distance(const BrainReal* a, const BrainReal* b, const BrainUint size)
+{
+    BrainDouble ret = 0.;
+    BrainUint i = 0;
+
+    for (i = 0; i < size; ++i)
+    {
+        const BrainDouble t = (BrainDouble)a[i] - (BrainDouble)b[i];
+        ret += t * t;
+    }
+
+    return ret;
+}
+
+static void
+compute_squared_distances(const KMeansTask* task,
+                          const BrainUint* rows,
+                          const BrainUint number_of_rows,
+                          BrainDouble* distances)
+{
+    const BrainUint number_of_clusters = task->_kmeans->_number_of_clusters;
+    const BrainUint size               = task->_kmeans->_size;
+    const BrainReal* centers           = task->_kmeans->_centers;
+    BrainUint r = 0;
+    BrainUint j = 0;
+    BrainUint l = 0;
+    /******************************************************************/
+    /**  |x - c|^2 = |x|^2 + |c|^2 - 2 <x, c>, the dot products are  **/
+    /**  computed like a matrix product: a tile of four centers is   **/
+    /**  kept in cache while the whole block of signals goes by      **/
+    /******************************************************************/
+    for (j = 0; j + 4 <= number_of_clusters; j += 4)
+    {
+        const BrainReal* c0 = centers + (j + 0) * size;
+        const BrainReal* c1 = centers + (j + 1) * size;
+        const BrainReal* c2 = centers + (j + 2) * size;
+        const BrainReal* c3 = centers + (j + 3) * size;
+
+        for (r = 0; r < number_of_rows; ++r)
+        {
+            const BrainReal* x = task->_signals[rows[r]];
+            BrainDouble* out = distances + r * number_of_clusters + j;
+            BrainDouble d0 = 0., d1 = 0., d2 = 0., d3 = 0.;
+
+            for (l = 0; l < size; ++l)
+            {
+                const BrainDouble v = x[l];
+
+                d0 += v * c0[l];
+                d1 += v * c1[l];
+                d2 += v * c2[l];
+                d3 += v * c3[l];
+            }
+
+            out[0] = -2. * d0;
+            out[1] = -2. * d1;
+            out[2] = -2. * d2;
+            out[3] = -2. * d3;
+        }
+    }
+
+    for (; j < number_of_clusters; ++j)
+    {
+        const BrainReal* c = centers + j * size;
+
+        for (r = 0; r < number_of_rows; ++r)
+        {
+            const BrainReal* x = task->_signals[rows[r]];
+            BrainDouble d = 0.;
+
+            for (l = 0; l < size; ++l)
+            {
+                d += (BrainDouble)x[l] * c[l];
+            }
+
+            distances[r * number_of_clusters + j] = -2. * d;
+        }
+    }
+
+    for (r = 0; r < number_of_rows; ++r)
+    {
+        const BrainDouble norm = task->_row_norms[rows[r]];
+        BrainDouble* out = distances + r * number_of_clusters;
+
+        for (j = 0; j < number_of_clusters; ++j)
+        {
+            out[j] += norm + task->_center_norms[j];
+
+            // cancellation may give a tiny negative value
+            if (out[j] < 0.)
+            {
+                out[j] = 0.;
+            }
+        }
+    }
+}
+
+static void
+move_signal(const KMeansTask* task,
+            KMeansWorkspace* workspace,
+            const BrainUint row,
+            const BrainUint from,
+            const BrainUint to)
+{
+    const BrainUint number_of_clusters = task->_kmeans->_number_of_clusters;
+    const BrainUint size = task->_kmeans->_size;
+    const BrainReal* x = task->_signals[row];
+    BrainUint l = 0;
+
+    if (from < number_of_clusters)
+    {
+        BrainDouble* sums = workspace->_sums + from * size;
+
+        for (l = 0; l < size; ++l)
+        {
+            sums[l] -= x[l];
+        }
+
+        workspace->_counts[from] -= 1.;
+    }
+
+    {
+        BrainDouble* sums = workspace->_sums + to * size;
+
+        for (l = 0; l < size; ++l)
+        {
+            sums[l] += x[l];
+        }
+
+        workspace->_counts[to] += 1.;
+    }
+
+    ++workspace->_changed;
+}
+
+static void
+assign_block(const KMeansTask* task,
+             KMeansWorkspace* workspace,
+             const BrainUint number_of_rows)
+{
+    const BrainUint number_of_clusters = task->_kmeans->_number_of_clusters;
+    BrainUint r = 0;
+
+    compute_squared_distances(task, workspace->_rows, number_of_rows, workspace->_distances);
+
+    for (r = 0; r < number_of_rows; ++r)
+    {
+        const BrainUint row = workspace->_rows[r];
+        const BrainDouble* distances = workspace->_distances + r * number_of_clusters;
+        BrainDouble best = DBL_MAX;
+        BrainDouble second = DBL_MAX;
+        BrainUint label = 0;
+        BrainUint j = 0;
+
+        for (j = 0; j < number_of_clusters; ++j)
+        {
+            if (distances[j] < best)
+            {
+                second = best;
+                best   = distances[j];
+                label  = j;
+            }
+            else if (distances[j] < second)
+            {
+                second = distances[j];
+            }
+        }
+
+        if (label != task->_labels[row])
+        {
+            move_signal(task, workspace, row, task->_labels[row], label);
+            task->_labels[row] = label;
+        }
+
+        task->_upper[row] = sqrt(best);
+        task->_lower[row] = (second < DBL_MAX) ? sqrt(second) : DBL_MAX;
+    }
+}
+
+static void
+norm_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    const BrainUint size = task->_kmeans->_size;
+    BrainUint i = 0;
+    BrainUint l = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        const BrainReal* x = task->_signals[i];
+        BrainDouble norm = 0.;
+
+        for (l = 0; l < size; ++l)
+        {
+            norm += (BrainDouble)x[l] * x[l];
+        }
+
+        task->_row_norms[i] = norm;
+    }
+}
+
+static void
+seed_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    const BrainUint size = task->_kmeans->_size;
+    const BrainReal* center = task->_kmeans->_centers + task->_seed * size;
+    KMeansWorkspace* workspace = &(task->_workspaces[thread]);
+    BrainUint i = 0;
+
+    workspace->_cost = 0.;
+
+    for (i = begin; i < end; ++i)
+    {
+        const BrainDouble d = squared_distance(task->_signals[i], center, size);
+
+        if ((task->_seed == 0)
+        ||  (d < task->_nearest[i]))
+        {
+            task->_nearest[i] = d;
+        }
+
+        workspace->_cost += task->_nearest[i];
+    }
+}
+
+static void
+full_assign_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    KMeansWorkspace* workspace = &(task->_workspaces[thread]);
+    BrainUint i = begin;
+
+    while (i < end)
+    {
+        BrainUint number_of_rows = 0;
+
+        while ((number_of_rows < BRAIN_KMEANS_BLOCK)
+        &&     (i < end))
+        {
+            workspace->_rows[number_of_rows] = i;
+            ++number_of_rows;
+            ++i;
+        }
+
+        assign_block(task, workspace, number_of_rows);
+    }
+}
+
+static void
+bounded_assign_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    KMeansWorkspace* workspace = &(task->_workspaces[thread]);
+    const BrainUint size = task->_kmeans->_size;
+    const BrainReal* centers = task->_kmeans->_centers;
+    BrainUint number_of_rows = 0;
+    BrainUint i = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        const BrainUint label = task->_labels[i];
+        const BrainDouble bound = (task->_half_gaps[label] < task->_lower[i]) ? task->_lower[i] : task->_half_gaps[label];
+
+        if (bound < task->_upper[i])
+        {
+            /**********************************************************/
+            /**     Tighten the upper bound before the full search   **/
+            /**********************************************************/
+            task->_upper[i] = sqrt(squared_distance(task->_signals[i], centers + label * size, size));
+
+            if (bound < task->_upper[i])
+            {
+                workspace->_rows[number_of_rows] = i;
+                ++number_of_rows;
+
+                if (number_of_rows == BRAIN_KMEANS_BLOCK)
+                {
+                    assign_block(task, workspace, number_of_rows);
+                    number_of_rows = 0;
+                }
+            }
+        }
+    }
+
+    if (0 < number_of_rows)
+    {
+        assign_block(task, workspace, number_of_rows);
+    }
+}
+
+static void
+bounds_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    BrainUint i = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        const BrainUint label = task->_labels[i];
+
+        task->_upper[i] += task->_movements[label];
+
+        if (task->_lower[i] < DBL_MAX)
+        {
+            task->_lower[i] -= (label == task->_farthest) ? task->_second_movement : task->_largest_movement;
+        }
+    }
+}
+
+static void
+gap_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    const BrainUint number_of_clusters = task->_kmeans->_number_of_clusters;
+    const BrainUint size = task->_kmeans->_size;
+    const BrainReal* centers = task->_kmeans->_centers;
+    BrainUint j = 0;
+    BrainUint k = 0;
+
+    for (j = begin; j < end; ++j)
+    {
+        BrainDouble gap = DBL_MAX;
+
+        for (k = 0; k < number_of_clusters; ++k)
+        {
+            if (k != j)
+            {
+                const BrainDouble d = squared_distance(centers + j * size, centers + k * size, size);
+
+                if (d < gap)
+                {
+                    gap = d;
+                }
+            }
+        }
+
+        task->_half_gaps[j] = (gap < DBL_MAX) ? 0.5 * sqrt(gap) : DBL_MAX;
+    }
+}
+
+static void
+inertia_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    KMeansTask* task = (KMeansTask*)data;
+    KMeansWorkspace* workspace = &(task->_workspaces[thread]);
+    const BrainUint size = task->_kmeans->_size;
+    BrainUint i = 0;
+
+    workspace->_cost = 0.;
+
+    for (i = begin; i < end; ++i)
+    {
+        workspace->_cost += squared_distance(task->_signals[i],
+                                             task->_kmeans->_centers + task->_labels[i] * size,
+                                             size);
+    }
+}
+
+static BrainUint
+merge_workspaces(KMeansTask* task)
+{
+    const BrainUint number_of_clusters = task->_kmeans->_number_of_clusters;
+    const BrainUint size = task->_kmeans->_size;
+    BrainUint ret = 0;
+    BrainUint t = 0;
+    BrainUint j = 0;
+
+    for (t = 0; t < task->_number_of_threads; ++t)
+    {
+        KMeansWorkspace* workspace = &(task->_workspaces[t]);
+
+        if (0 < workspace->_changed)
+        {
+            for (j = 0; j < number_of_clusters * size; ++j)
+            {
+                task->_sums[j] += workspace->_sums[j];
+            }
+
+            for (j = 0; j < number_of_clusters; ++j)
+            {
+                task->_counts[j] += workspace->_counts[j];
+            }
+
+            BRAIN_SET(workspace->_sums, 0, BrainDouble, number_of_clusters * size);
+            BRAIN_SET(workspace->_counts, 0, BrainDouble, number_of_clusters);
+        }
+
+        ret += workspace->_changed;
+        workspace->_changed = 0;
+    }
+
+    return ret;
+}
+
+static BrainDouble
+sum_costs(const KMeansTask* task)
+{
+    BrainDouble ret = 0.;
+    BrainUint t = 0;
+
+    for (t = 0; t < task->_number_of_threads; ++t)
+    {
+        ret += task->_workspaces[t]._cost;
+    }
+
+    return ret;
+}
+
+static void
+update_center_norms(KMeansTask* task)
+{
+    const BrainUint size = task->_kmeans->_size;
+    BrainUint j = 0;
+
+    for (j = 0; j < task->_kmeans->_number_of_clusters; ++j)
+    {
+        const BrainReal* center = task->_kmeans->_centers + j * size;
+        BrainDouble norm = 0.;
+        BrainUint l = 0;
+
+        for (l = 0; l < size; ++l)
+        {
+            norm += (BrainDouble)center[l] * center[l];
+        }
+
+        task->_center_norms[j] = norm;
+    }
+}
+
+static BrainDouble
+move_centers(KMeansTask* task)
+{
+    const BrainUint size = task->_kmeans->_size;
+    BrainDouble ret = 0.;
+    BrainUint j = 0;
+    BrainUint l = 0;
+
+    task->_farthest         = 0;
+    task->_largest_movement = 0.;
+    task->_second_movement  = 0.;
+
+    for (j = 0; j < task->_kmeans->_number_of_clusters; ++j)
+    {
+        BrainReal* center = task->_kmeans->_centers + j * size;
+        BrainDouble movement = 0.;
+
+        // an empty cluster keeps its center
+        if (0.5 < task->_counts[j])
+        {
+            const BrainDouble* sums = task->_sums + j * size;
+
+            for (l = 0; l < size; ++l)
+            {
+                const BrainReal value = (BrainReal)(sums[l] / task->_counts[j]);
+                const BrainDouble t = (BrainDouble)value - (BrainDouble)center[l];
+
+                movement += t * t;
+                center[l] = value;
+            }
+        }
+
+        ret += movement;
+        movement = sqrt(movement);
+        task->_movements[j] = movement;
+
+        if (task->_largest_movement < movement)
+        {
+            task->_second_movement  = task->_largest_movement;
+            task->_largest_movement = movement;
+            task->_farthest         = j;
+        }
+        else if (task->_second_movement < movement)
+        {
+            task->_second_movement = movement;
+        }
+    }
+
+    update_center_norms(task);
+
+    return ret;
+}
+
+static BrainUint
+draw_seed(const KMeansTask* task, const BrainUint number_of_signals, const BrainDouble total)
+{
+    BrainRandom random = get_thread_random();
+    BrainUint ret = random_index(random, number_of_signals);
+
+    if (0. < total)
+    {
+        /**************************************************************/
+        /**  k-means++: draw a signal with a probability proportional **/
+        /**  to its squared distance to the closest seeded center     **/
+        /**************************************************************/
+        const BrainDouble target = random_unit(random) * total;
+        BrainDouble cumulated = 0.;
+        BrainUint i = 0;
+
+        for (i = 0; i < number_of_signals; ++i)
+        {
+            cumulated += task->_nearest[i];
+
+            if ((target <= cumulated)
+            &&  (0. < task->_nearest[i]))
+            {
+                break;
+            }
+        }
+
+        ret = i;
+    }
+
+    if (number_of_signals <= ret)
+    {
+        ret = number_of_signals - 1;
+    }
+
+    return ret;
+}
+
+static void
+seed_centers(KMeansTask* task, const BrainUint number_of_signals)
+{
+    const BrainUint size = task->_kmeans->_size;
+    BrainUint row = draw_seed(task, number_of_signals, 0.);
+    BrainUint j = 0;
+
+    for (j = 0; j < task->_kmeans->_number_of_clusters; ++j)
+    {
+        BRAIN_COPY(task->_signals[row], task->_kmeans->_centers + j * size, BrainReal, size);
+
+        if (j + 1 < task->_kmeans->_number_of_clusters)
+        {
+            task->_seed = j;
+            parallel_for(number_of_signals, task->_number_of_threads, seed_worker, task);
+            row = draw_seed(task, number_of_signals, sum_costs(task));
+        }
+    }
+}
+
+static BrainDouble
+get_tolerance_threshold(const BrainKMeans kmeans,
+                        BrainReal** signals,
+                        const BrainUint number_of_signals)
+{
+    BrainSignalStatistics statistics = new_signal_statistics(kmeans->_size);
+    BrainReal* variances = NULL;
+    BrainDouble ret = 0.;
+    BrainUint l = 0;
+
+    BRAIN_NEW(variances, BrainReal, kmeans->_size);
+
+    find_signal_statistics(statistics, signals, number_of_signals);
+    get_signal_statistics(statistics, NULL, variances, NULL, NULL);
+
+    for (l = 0; l < kmeans->_size; ++l)
+    {
+        ret += variances[l];
+    }
+
+    ret = kmeans->_tolerance * ret / (BrainDouble)kmeans->_size;
+
+    BRAIN_DELETE(variances);
+    delete_signal_statistics(statistics);
+
+    return ret;
+}
+
+static void
+new_kmeans_task(KMeansTask* task,
+                BrainKMeans kmeans,
+                BrainReal** signals,
+                const BrainUint number_of_signals,
+                BrainUint* labels)
+{
+    const BrainUint number_of_clusters = kmeans->_number_of_clusters;
+    const BrainUint number_of_sums = number_of_clusters * kmeans->_size;
+    const BrainUint number_of_distances = BRAIN_KMEANS_BLOCK * number_of_clusters;
+    BrainUint t = 0;
+
+    memset(task, 0, sizeof(KMeansTask));
+
+    task->_kmeans            = kmeans;
+    task->_signals           = signals;
+    task->_labels            = labels;
+    task->_number_of_threads = get_number_of_threads(number_of_signals, BRAIN_KMEANS_GRAIN);
+
+    BRAIN_NEW(task->_row_norms,    BrainDouble, number_of_signals);
+    BRAIN_NEW(task->_upper,        BrainDouble, number_of_signals);
+    BRAIN_NEW(task->_lower,        BrainDouble, number_of_signals);
+    BRAIN_NEW(task->_nearest,      BrainDouble, number_of_signals);
+    BRAIN_NEW(task->_center_norms, BrainDouble, number_of_clusters);
+    BRAIN_NEW(task->_half_gaps,    BrainDouble, number_of_clusters);
+    BRAIN_NEW(task->_movements,    BrainDouble, number_of_clusters);
+    BRAIN_NEW(task->_counts,       BrainDouble, number_of_clusters);
+    BRAIN_NEW(task->_sums,         BrainDouble, number_of_sums);
+    BRAIN_NEW(task->_workspaces,   KMeansWorkspace, task->_number_of_threads);
+
+    for (t = 0; t < task->_number_of_threads; ++t)
+    {
+        BRAIN_NEW(task->_workspaces[t]._sums,      BrainDouble, number_of_sums);
+        BRAIN_NEW(task->_workspaces[t]._counts,    BrainDouble, number_of_clusters);
+        BRAIN_NEW(task->_workspaces[t]._distances, BrainDouble, number_of_distances);
+        BRAIN_NEW(task->_workspaces[t]._rows,      BrainUint,   BRAIN_KMEANS_BLOCK);
+    }
+
+    for (t = 0; t < number_of_signals; ++t)
+    {
+        // no signal belongs to a cluster yet
+        labels[t] = number_of_clusters;
+    }
+
+    parallel_for(number_of_signals, task->_number_of_threads, norm_worker, task);
+}
+
+static void
+delete_kmeans_task(KMeansTask* task)
+{
+    BrainUint t = 0;
+
+    for (t = 0; t < task->_number_of_threads; ++t)
+    {
+        BRAIN_DELETE(task->_workspaces[t]._sums);
+        BRAIN_DELETE(task->_workspaces[t]._counts);
+        BRAIN_DELETE(task->_workspaces[t]._distances);
+        BRAIN_DELETE(task->_workspaces[t]._rows);
+    }
+
+    BRAIN_DELETE(task->_workspaces);
+    BRAIN_DELETE(task->_sums);
+    BRAIN_DELETE(task->_counts);
+    BRAIN_DELETE(task->_movements);
+    BRAIN_DELETE(task->_half_gaps);
+    BRAIN_DELETE(task->_center_norms);
+    BRAIN_DELETE(task->_nearest);
+    BRAIN_DELETE(task->_lower);
+    BRAIN_DELETE(task->_upper);
+    BRAIN_DELETE(task->_row_norms);
+}
+
+BrainKMeans
+new_kmeans(const BrainUint number_of_clusters, const BrainUint size)
+{
+    BrainKMeans kmeans = NULL;
+
+    if ((0 < number_of_clusters)
+    &&  (0 < size))
+    {
+        BRAIN_NEW(kmeans, KMeans, 1);
+
+        kmeans->_number_of_clusters = number_of_clusters;
+        kmeans->_size               = size;
+        kmeans->_max_iterations     = BRAIN_KMEANS_MAX_ITERATIONS;
+        kmeans->_tolerance          = BRAIN_KMEANS_TOLERANCE;
+        kmeans->_seeded             = BRAIN_FALSE;
+        kmeans->_inertia            = 0.;
+
+        BRAIN_NEW(kmeans->_centers, BrainReal,   number_of_clusters * size);
+        BRAIN_NEW(kmeans->_counts,  BrainDouble, number_of_clusters);
+    }
+
+    return kmeans;
+}
+
+void
+delete_kmeans(BrainKMeans kmeans)
+{
+    if (BRAIN_ALLOCATED(kmeans))
+    {
+        BRAIN_DELETE(kmeans->_centers);
+        BRAIN_DELETE(kmeans->_counts);
+        BRAIN_DELETE(kmeans);
+    }
+}
+
+void
+configure_kmeans(BrainKMeans kmeans,
+                 const BrainUint max_iterations,
+                 const BrainReal tolerance)
+{
+    if (BRAIN_ALLOCATED(kmeans))
+    {
+        kmeans->_max_iterations = max_iterations;
+        kmeans->_tolerance      = tolerance;
+    }
+}
+
+BrainUint
+fit_kmeans(BrainKMeans kmeans,
+           BrainReal** signals,
+           const BrainUint number_of_signals,
+           BrainUint* labels)
+{
+    BRAIN_INPUT(fit_kmeans)
+
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(kmeans)
+    &&  BRAIN_ALLOCATED(signals)
+    &&  (kmeans->_number_of_clusters <= number_of_signals))
+    {
+        const BrainUint number_of_clusters = kmeans->_number_of_clusters;
+        const BrainDouble threshold = get_tolerance_threshold(kmeans, signals, number_of_signals);
+        BrainUint* own_labels = NULL;
+        KMeansTask task;
+
+        if (!BRAIN_ALLOCATED(labels))
+        {
+            BRAIN_NEW(own_labels, BrainUint, number_of_signals);
+            labels = own_labels;
+        }
+
+        new_kmeans_task(&task, kmeans, signals, number_of_signals, labels);
+        /**************************************************************/
+        /**              SEED AND ASSIGN ALL SIGNALS                 **/
+        /**************************************************************/
+        seed_centers(&task, number_of_signals);
+        update_center_norms(&task);
+
+        parallel_for(number_of_signals, task._number_of_threads, full_assign_worker, &task);
+        merge_workspaces(&task);
+        /**************************************************************/
+        /**                    LLOYD ITERATIONS                      **/
+        /**************************************************************/
+        while (ret < kmeans->_max_iterations)
+        {
+            BrainDouble movement = 0.;
+            BrainUint changed = 0;
+
+            ++ret;
+
+            movement = move_centers(&task);
+
+            parallel_for(number_of_signals, task._number_of_threads, bounds_worker, &task);
+            parallel_for(number_of_clusters,
+                         get_number_of_threads(number_of_clusters, BRAIN_KMEANS_CENTER_GRAIN),
+                         gap_worker,
+                         &task);
+            parallel_for(number_of_signals, task._number_of_threads, bounded_assign_worker, &task);
+
+            changed = merge_workspaces(&task);
+
+            if ((changed == 0)
+            ||  (movement <= threshold))
+            {
+                break;
+            }
+        }
+
+        parallel_for(number_of_signals, task._number_of_threads, inertia_worker, &task);
+        kmeans->_inertia = sum_costs(&task);
+        kmeans->_seeded  = BRAIN_TRUE;
+        BRAIN_COPY(task._counts, kmeans->_counts, BrainDouble, number_of_clusters);
+
+        delete_kmeans_task(&task);
+        BRAIN_DELETE(own_labels);
+    }
+    else
+    {
+        BRAIN_CRITICAL("Unable to fit %u clusters\n", BRAIN_ALLOCATED(kmeans) ? kmeans->_number_of_clusters : 0);
+    }
+
+    BRAIN_OUTPUT(fit_kmeans)
+
+    return ret;
+}
+
+void
+partial_fit_kmeans(BrainKMeans kmeans,
+                   BrainReal** signals,
+                   const BrainUint number_of_signals)
+{
+    BRAIN_INPUT(partial_fit_kmeans)
+
+    if (BRAIN_ALLOCATED(kmeans)
+    &&  BRAIN_ALLOCATED(signals)
+    &&  (0 < number_of_signals))
+    {
+        if (kmeans->_seeded
+        ||  (kmeans->_number_of_clusters <= number_of_signals))
+        {
+            const BrainUint size = kmeans->_size;
+            BrainUint* labels = NULL;
+            KMeansTask task;
+            BrainUint j = 0;
+            BrainUint l = 0;
+
+            BRAIN_NEW(labels, BrainUint, number_of_signals);
+
+            new_kmeans_task(&task, kmeans, signals, number_of_signals, labels);
+
+            if (!kmeans->_seeded)
+            {
+                seed_centers(&task, number_of_signals);
+                kmeans->_seeded = BRAIN_TRUE;
+            }
+
+            update_center_norms(&task);
+
+            parallel_for(number_of_signals, task._number_of_threads, full_assign_worker, &task);
+            merge_workspaces(&task);
+            /**********************************************************/
+            /**  Sculley's per center learning rate 1 / count makes  **/
+            /**  each center the running mean of all signals it has  **/
+            /**  been given, so the minibatch is applied at once     **/
+            /**********************************************************/
+            for (j = 0; j < kmeans->_number_of_clusters; ++j)
+            {
+                if (0.5 < task._counts[j])
+                {
+                    const BrainDouble count = kmeans->_counts[j] + task._counts[j];
+                    BrainReal* center = kmeans->_centers + j * size;
+                    const BrainDouble* sums = task._sums + j * size;
+
+                    for (l = 0; l < size; ++l)
+                    {
+                        center[l] = (BrainReal)((kmeans->_counts[j] * center[l] + sums[l]) / count);
+                    }
+
+                    kmeans->_counts[j] = count;
+                }
+            }
+
+            parallel_for(number_of_signals, task._number_of_threads, inertia_worker, &task);
+            kmeans->_inertia = sum_costs(&task);
+
+            delete_kmeans_task(&task);
+            BRAIN_DELETE(labels);
+        }
+        else
+        {
+            BRAIN_CRITICAL("The first minibatch needs at least %u signals\n", kmeans->_number_of_clusters);
+        }
+    }
+
+    BRAIN_OUTPUT(partial_fit_kmeans)
+}
+
+void
+partial_fit_kmeans_with_data(BrainKMeans kmeans,
+                             BrainData data,
+                             const BrainUint batch_size,
+                             const BrainUint number_of_batches)
+{
+    BRAIN_INPUT(partial_fit_kmeans_with_data)
+
+    if (BRAIN_ALLOCATED(kmeans)
+    &&  BRAIN_ALLOCATED(data)
+    &&  (get_input_signal_length(data) == kmeans->_size))
+    {
+        BrainBatchLoader loader = new_batch_loader(data, batch_size, 2);
+
+        if (BRAIN_ALLOCATED(loader))
+        {
+            const BrainUint size = kmeans->_size;
+            BrainSignal* signals = NULL;
+            BrainUint b = 0;
+
+            BRAIN_NEW(signals, BrainSignal, batch_size);
+            /**********************************************************/
+            /**   The loader thread reads the next minibatch while   **/
+            /**   the current one is clustered                       **/
+            /**********************************************************/
+            for (b = 0; b < number_of_batches; ++b)
+            {
+                BrainSignal inputs = NULL;
+                const BrainUint number_of_signals = batch_loader_acquire(loader, &inputs, NULL);
+                BrainUint i = 0;
+
+                if (number_of_signals == 0)
+                {
+                    break;
+                }
+
+                for (i = 0; i < number_of_signals; ++i)
+                {
+                    signals[i] = inputs + i * size;
+                }
+
+                partial_fit_kmeans(kmeans, signals, number_of_signals);
+                batch_loader_release(loader);
+            }
+
+            BRAIN_DELETE(signals);
+            delete_batch_loader(loader);
+        }
+    }
+
+    BRAIN_OUTPUT(partial_fit_kmeans_with_data)
+}
+
+void
+predict_kmeans(const BrainKMeans kmeans,
+               BrainReal** signals,
+               const BrainUint number_of_signals,
+               BrainUint* labels)
+{
+    BRAIN_INPUT(predict_kmeans)
+
+    if (BRAIN_ALLOCATED(kmeans)
+    &&  BRAIN_ALLOCATED(signals)
+    &&  BRAIN_ALLOCATED(labels)
+    &&  (0 < number_of_signals))
+    {
+        KMeansTask task;
+
+        new_kmeans_task(&task, kmeans, signals, number_of_signals, labels);
+        update_center_norms(&task);
+
+        parallel_for(number_of_signals, task._number_of_threads, full_assign_worker, &task);
+
+        delete_kmeans_task(&task);
+    }
+
+    BRAIN_OUTPUT(predict_kmeans)
+}
+
+BrainUint
+get_kmeans_number_of_cluster(const BrainKMeans kmeans)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(kmeans))
+    {
+        ret = kmeans->_number_of_clusters;
+    }
+
+    return ret;
+}
+
+BrainSignal
+get_kmeans_center(const BrainKMeans kmeans, const BrainUint cluster)
+{
+    BrainSignal ret = NULL;
+
+    if (BRAIN_ALLOCATED(kmeans)
+    &&  (cluster < kmeans->_number_of_clusters))
+    {
+        ret = kmeans->_centers + cluster * kmeans->_size;
+    }
+
+    return ret;
+}
+
+BrainReal
+get_kmeans_inertia(const BrainKMeans kmeans)
+{
+    BrainReal ret = 0.;
+
+    if (BRAIN_ALLOCATED(kmeans))
+    {
+        ret = (BrainReal)kmeans->_inertia;
+    }
+
+    return ret;
+}
@@ -0,0 +1,393 @@
+#include "brain_label_utils.h"
+#include "brain_logging_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_xml_utils.h"
+
+#define BRAIN_LABEL_MIN_CAPACITY 16
+#define BRAIN_LABEL_EMPTY_SLOT   0
+
+/**
+ * \struct LabelDictionary
+ * \brief  Internal model for a BrainLabelDictionary
+ *
+ * Labels are stored by id. The open addressing table stores id + 1 so that
+ * 0 marks an empty slot, and is probed linearly from the label hash. Its
+ * capacity is a power of two and it is kept at most half full.
+ */
+typedef struct LabelDictionary
+{
+    BrainChar** _labels;            /*!< Labels indexed by id           */
+    BrainUint*  _hashes;            /*!< Label hashes indexed by id     */
+    BrainUint   _number_of_labels;  /*!< Number of labels               */
+    BrainUint   _labels_capacity;   /*!< Allocated labels               */
+    BrainUint*  _slots;             /*!< Open addressing table          */
+    BrainUint   _capacity;          /*!< Number of slots                */
+} LabelDictionary;
+
+static BrainUint
+hash_label(BrainString label)
+{
+    // 32 bits FNV-1a
+    BrainUint hash = 2166136261U;
+
+    while (*label)
+    {
+        hash ^= (unsigned char)(*label);
+        hash *= 16777619U;
+        ++label;
+    }
+
+    return hash;
+}
+
+static BrainUint
+find_slot(const BrainLabelDictionary dictionary, BrainString label, const BrainUint hash)
+{
+    const BrainUint mask = dictionary->_capacity - 1;
+    BrainUint slot = hash & mask;
+
+    while (dictionary->_slots[slot] != BRAIN_LABEL_EMPTY_SLOT)
+    {
+        const BrainUint id = dictionary->_slots[slot] - 1;
+
+        if ((dictionary->_hashes[id] == hash)
+        &&  !strcmp(dictionary->_labels[id], label))
+        {
+            break;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static void
+grow_slots(BrainLabelDictionary dictionary)
+{
+    BrainUint id = 0;
+
+    BRAIN_DELETE(dictionary->_slots);
+    dictionary->_capacity *= 2;
+    BRAIN_NEW_TAG(dictionary->_slots, BrainUint, dictionary->_capacity, Memory_Labels);
+
+    for (id = 0; id < dictionary->_number_of_labels; ++id)
+    {
+        const BrainUint mask = dictionary->_capacity - 1;
+        BrainUint slot = dictionary->_hashes[id] & mask;
+
+        while (dictionary->_slots[slot] != BRAIN_LABEL_EMPTY_SLOT)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        dictionary->_slots[slot] = id + 1;
+    }
+}
+
+static void
+clear_label_dictionary(BrainLabelDictionary dictionary)
+{
+    BrainUint id = 0;
+
+    for (id = 0; id < dictionary->_number_of_labels; ++id)
+    {
+        BRAIN_DELETE(dictionary->_labels[id]);
+    }
+
+    dictionary->_number_of_labels = 0;
+    BRAIN_SET(dictionary->_slots, 0, BrainUint, dictionary->_capacity);
+}
+
+BrainLabelDictionary
+new_label_dictionary()
+{
+    BrainLabelDictionary dictionary = NULL;
+
+    BRAIN_NEW_TAG(dictionary, LabelDictionary, 1, Memory_Labels);
+
+    dictionary->_number_of_labels = 0;
+    dictionary->_labels_capacity  = BRAIN_LABEL_MIN_CAPACITY;
+    dictionary->_capacity         = 2 * BRAIN_LABEL_MIN_CAPACITY;
+
+    BRAIN_NEW_TAG(dictionary->_labels, BrainChar*, dictionary->_labels_capacity, Memory_Labels);
+    BRAIN_NEW_TAG(dictionary->_hashes, BrainUint,  dictionary->_labels_capacity, Memory_Labels);
+    BRAIN_NEW_TAG(dictionary->_slots,  BrainUint,  dictionary->_capacity, Memory_Labels);
+
+    return dictionary;
+}
+
+void
+delete_label_dictionary(BrainLabelDictionary dictionary)
+{
+    if (BRAIN_ALLOCATED(dictionary))
+    {
+        clear_label_dictionary(dictionary);
+
+        BRAIN_DELETE(dictionary->_labels);
+        BRAIN_DELETE(dictionary->_hashes);
+        BRAIN_DELETE(dictionary->_slots);
+        BRAIN_DELETE(dictionary);
+    }
+}
+
+void
+accumulate_label_dictionary_memory(const BrainLabelDictionary dictionary, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(dictionary))
+    {
+        BrainUint id = 0;
+
+        for (id = 0; id < dictionary->_number_of_labels; ++id)
+        {
+            accumulate_memory_usage(usage, dictionary->_labels[id]);
+        }
+
+        accumulate_memory_usage(usage, dictionary->_labels);
+        accumulate_memory_usage(usage, dictionary->_hashes);
+        accumulate_memory_usage(usage, dictionary->_slots);
+        accumulate_memory_usage(usage, dictionary);
+    }
+}
+
+BrainUint
+label_dictionary_intern(BrainLabelDictionary dictionary, BrainString label)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(label))
+    {
+        const BrainUint hash = hash_label(label);
+        BrainUint slot = find_slot(dictionary, label, hash);
+
+        if (dictionary->_slots[slot] != BRAIN_LABEL_EMPTY_SLOT)
+        {
+            ret = dictionary->_slots[slot] - 1;
+        }
+        else
+        {
+            /**********************************************************/
+            /**                   ADD A NEW LABEL                    **/
+            /**********************************************************/
+            ret = dictionary->_number_of_labels;
+
+            if (dictionary->_labels_capacity <= ret)
+            {
+                dictionary->_labels_capacity *= 2;
+                BRAIN_RESIZE(dictionary->_labels, BrainChar*, dictionary->_labels_capacity);
+                BRAIN_RESIZE(dictionary->_hashes, BrainUint,  dictionary->_labels_capacity);
+            }
+
+            BRAIN_NEW_TAG(dictionary->_labels[ret], BrainChar, strlen(label) + 1, Memory_Labels);
+            strcpy(dictionary->_labels[ret], label);
+            dictionary->_hashes[ret] = hash;
+            ++dictionary->_number_of_labels;
+
+            if (dictionary->_capacity < 2 * dictionary->_number_of_labels)
+            {
+                grow_slots(dictionary);
+            }
+            else
+            {
+                dictionary->_slots[slot] = ret + 1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+BrainBool
+label_dictionary_find(const BrainLabelDictionary dictionary, BrainString label, BrainUint* id)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(label))
+    {
+        const BrainUint slot = find_slot(dictionary, label, hash_label(label));
+
+        if (dictionary->_slots[slot] != BRAIN_LABEL_EMPTY_SLOT)
+        {
+            ret = BRAIN_TRUE;
+
+            if (BRAIN_ALLOCATED(id))
+            {
+                *id = dictionary->_slots[slot] - 1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+BrainUint
+get_label_dictionary_size(const BrainLabelDictionary dictionary)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(dictionary))
+    {
+        ret = dictionary->_number_of_labels;
+    }
+
+    return ret;
+}
+
+BrainString
+get_label_dictionary_label(const BrainLabelDictionary dictionary, const BrainUint id)
+{
+    BrainString ret = NULL;
+
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  (id < dictionary->_number_of_labels))
+    {
+        ret = dictionary->_labels[id];
+    }
+
+    return ret;
+}
+
+void
+copy_label_dictionary(const BrainLabelDictionary src, BrainLabelDictionary dst)
+{
+    if (BRAIN_ALLOCATED(src)
+    &&  BRAIN_ALLOCATED(dst)
+    &&  (src != dst))
+    {
+        BrainUint id = 0;
+
+        clear_label_dictionary(dst);
+
+        for (id = 0; id < src->_number_of_labels; ++id)
+        {
+            label_dictionary_intern(dst, src->_labels[id]);
+        }
+    }
+}
+
+void
+serialize_label_dictionary(const BrainLabelDictionary dictionary, Writer writer)
+{
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(writer))
+    {
+        BrainUint id = 0;
+
+        for (id = 0; id < dictionary->_number_of_labels; ++id)
+        {
+            if (start_element(writer, "label"))
+            {
+                add_attribute(writer, "name", dictionary->_labels[id]);
+                stop_element(writer);
+            }
+        }
+    }
+}
+
+void
+deserialize_label_dictionary(BrainLabelDictionary dictionary, Context context)
+{
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(context))
+    {
+        const BrainUint number_of_labels = get_number_of_node_with_name(context, "label");
+        BrainUint i = 0;
+
+        for (i = 0; i < number_of_labels; ++i)
+        {
+            Context label_context = get_node_with_name_and_index(context, "label", i);
+            Buffer  name = node_get_prop(label_context, "name");
+
+            if (BRAIN_ALLOCATED(name))
+            {
+                label_dictionary_intern(dictionary, (BrainString)name);
+                xmlFree(name);
+            }
+        }
+    }
+}
+
+BrainBool
+write_label_dictionary(const BrainLabelDictionary dictionary, FILE* file)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(file))
+    {
+        BrainUint id = 0;
+
+        ret = (fwrite(&(dictionary->_number_of_labels), sizeof(BrainUint), 1, file) == 1);
+
+        for (id = 0; ret && (id < dictionary->_number_of_labels); ++id)
+        {
+            const BrainUint length = strlen(dictionary->_labels[id]);
+
+            ret = (fwrite(&length, sizeof(BrainUint), 1, file) == 1)
+               && (fwrite(dictionary->_labels[id], sizeof(BrainChar), length, file) == length);
+        }
+    }
+
+    return ret;
+}
+
+BrainBool
+read_label_dictionary(BrainLabelDictionary dictionary, FILE* file)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(dictionary)
+    &&  BRAIN_ALLOCATED(file))
+    {
+        BrainUint number_of_labels = 0;
+        BrainChar* label = NULL;
+        BrainUint  label_capacity = 0;
+        BrainUint  i = 0;
+        const long start = ftell(file);
+        long       end   = -1;
+
+        // a label cannot be longer than the rest of the file
+        if ((0 <= start)
+        &&  (fseek(file, 0, SEEK_END) == 0))
+        {
+            end = ftell(file);
+        }
+
+        ret = (start <= end)
+        &&    (fseek(file, start, SEEK_SET) == 0)
+        &&    (fread(&number_of_labels, sizeof(BrainUint), 1, file) == 1);
+
+        for (i = 0; ret && (i < number_of_labels); ++i)
+        {
+            BrainUint length = 0;
+
+            ret = (fread(&length, sizeof(BrainUint), 1, file) == 1)
+            &&    (length < (BrainUint)-1)
+            &&    ((BrainUlong)length <= (BrainUlong)(end - ftell(file)));
+
+            if (ret)
+            {
+                if (label_capacity <= length)
+                {
+                    label_capacity = length + 1;
+                    BRAIN_RESIZE_TAG(label, BrainChar, label_capacity, Memory_Labels);
+                }
+
+                ret = (fread(label, sizeof(BrainChar), length, file) == length);
+            }
+
+            if (ret)
+            {
+                label[length] = '\0';
+                // a duplicated label means a corrupted file
+                ret = (label_dictionary_intern(dictionary, label) == i);
+            }
+        }
+
+        BRAIN_DELETE(label);
+    }
+
+    return ret;
+}
@@ -0,0 +1,282 @@
+#include "brain_loader_utils.h"
+#include "brain_data_utils.h"
+#include "brain_logging_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_timeline_utils.h"
+#include <pthread.h>
+
+/**
+ * \struct Batch
+ * \brief  A slot of the ring buffer
+ */
+typedef struct Batch
+{
+    BrainSignal _inputs;    /*!< Contiguous input signals   */
+    BrainSignal _outputs;   /*!< Contiguous output signals  */
+    BrainUint   _size;      /*!< Number of gathered samples */
+} Batch;
+
+/**
+ * \struct BatchLoader
+ * \brief  Internal model for a BrainBatchLoader
+ *
+ * Single producer, single consumer ring: the loader thread only writes
+ * the slot at _tail, the trainer only reads the slot at _head
+ */
+typedef struct BatchLoader
+{
+    BrainData       _data;              /*!< Data to read                   */
+    BrainUint       _batch_size;        /*!< Samples per minibatch          */
+    BrainUint       _number_of_batches; /*!< Ring capacity                  */
+    Batch*          _batches;           /*!< Ring slots                     */
+    BrainUint       _head;              /*!< Next slot to consume           */
+    BrainUint       _tail;              /*!< Next slot to fill              */
+    BrainUint       _ready;             /*!< Number of filled slots         */
+    BrainBool       _stop;              /*!< Ask the thread to stop         */
+    BrainBool       _finished;          /*!< The thread has no more sample  */
+    pthread_t       _thread;            /*!< Loader thread                  */
+    pthread_mutex_t _mutex;             /*!< Protect the ring counters      */
+    pthread_cond_t  _not_empty;         /*!< A slot has been filled         */
+    pthread_cond_t  _not_full;          /*!< A slot has been released       */
+} BatchLoader;
+
+static void
+gather_batch(BrainBatchLoader loader, Batch* batch)
+{
+    const BrainUint input_length  = get_input_signal_length(loader->_data);
+    const BrainUint output_length = get_output_signal_length(loader->_data);
+    BrainSignal input  = NULL;
+    BrainSignal output = NULL;
+
+    batch->_size = 0;
+
+    while ((batch->_size < loader->_batch_size)
+    &&     get_next_training_sample(loader->_data, &input, &output))
+    {
+        BRAIN_COPY(input,  batch->_inputs  + batch->_size * input_length,  BrainReal, input_length);
+        BRAIN_COPY(output, batch->_outputs + batch->_size * output_length, BrainReal, output_length);
+        ++batch->_size;
+    }
+}
+
+static void*
+batch_loader_thread(void* parameter)
+{
+    BrainBatchLoader loader = (BrainBatchLoader)parameter;
+    BrainBool running = BRAIN_TRUE;
+
+    while (running)
+    {
+        Batch* batch = NULL;
+        /**************************************************************/
+        /**                   WAIT FOR A FREE SLOT                   **/
+        /**************************************************************/
+        pthread_mutex_lock(&loader->_mutex);
+        while ((loader->_ready == loader->_number_of_batches)
+        &&     !loader->_stop)
+        {
+            pthread_cond_wait(&loader->_not_full, &loader->_mutex);
+        }
+        running = !loader->_stop;
+        batch   = &(loader->_batches[loader->_tail]);
+        pthread_mutex_unlock(&loader->_mutex);
+
+        if (running)
+        {
+            /**********************************************************/
+            /**     GATHER THE MINIBATCH OUTSIDE OF THE LOCK         **/
+            /**********************************************************/
+            const BrainUlong span = brain_timeline_begin();
+
+            gather_batch(loader, batch);
+
+            brain_timeline_end("load", "io", span, -1);
+
+            pthread_mutex_lock(&loader->_mutex);
+            if (batch->_size == 0)
+            {
+                loader->_finished = BRAIN_TRUE;
+                running = BRAIN_FALSE;
+            }
+            else
+            {
+                loader->_tail = (loader->_tail + 1) % loader->_number_of_batches;
+                ++loader->_ready;
+            }
+            pthread_cond_signal(&loader->_not_empty);
+            pthread_mutex_unlock(&loader->_mutex);
+        }
+    }
+
+    return NULL;
+}
+
+BrainBatchLoader
+new_batch_loader(BrainData data,
+                 const BrainUint batch_size,
+                 const BrainUint number_of_batches)
+{
+    BRAIN_INPUT(new_batch_loader)
+
+    BrainBatchLoader loader = NULL;
+
+    if (BRAIN_ALLOCATED(data)
+    &&  (0 < batch_size)
+    &&  (0 < number_of_batches))
+    {
+        const BrainUint input_length  = get_input_signal_length(data);
+        const BrainUint output_length = get_output_signal_length(data);
+        BrainUint i = 0;
+
+        BRAIN_NEW(loader, BatchLoader, 1);
+
+        loader->_data               = data;
+        loader->_batch_size         = batch_size;
+        loader->_number_of_batches  = number_of_batches;
+        loader->_head               = 0;
+        loader->_tail               = 0;
+        loader->_ready              = 0;
+        loader->_stop               = BRAIN_FALSE;
+        loader->_finished           = BRAIN_FALSE;
+
+        BRAIN_NEW(loader->_batches, Batch, number_of_batches);
+        for (i = 0; i < number_of_batches; ++i)
+        {
+            BRAIN_NEW_TAG(loader->_batches[i]._inputs,  BrainReal, batch_size * input_length, Memory_Dataset);
+            BRAIN_NEW_TAG(loader->_batches[i]._outputs, BrainReal, batch_size * output_length, Memory_Dataset);
+        }
+
+        pthread_mutex_init(&loader->_mutex, NULL);
+        pthread_cond_init(&loader->_not_empty, NULL);
+        pthread_cond_init(&loader->_not_full, NULL);
+
+        if (pthread_create(&loader->_thread, NULL, batch_loader_thread, loader) != 0)
+        {
+            BRAIN_CRITICAL("Unable to start the minibatch loader thread\n");
+            loader->_finished = BRAIN_TRUE;
+            loader->_stop     = BRAIN_TRUE;
+        }
+    }
+
+    BRAIN_OUTPUT(new_batch_loader)
+
+    return loader;
+}
+
+void
+delete_batch_loader(BrainBatchLoader loader)
+{
+    if (BRAIN_ALLOCATED(loader))
+    {
+        BrainUint i = 0;
+        const BrainBool started = !loader->_stop;
+
+        pthread_mutex_lock(&loader->_mutex);
+        loader->_stop = BRAIN_TRUE;
+        pthread_cond_signal(&loader->_not_full);
+        pthread_mutex_unlock(&loader->_mutex);
+
+        if (started)
+        {
+            pthread_join(loader->_thread, NULL);
+        }
+
+        pthread_cond_destroy(&loader->_not_full);
+        pthread_cond_destroy(&loader->_not_empty);
+        pthread_mutex_destroy(&loader->_mutex);
+
+        for (i = 0; i < loader->_number_of_batches; ++i)
+        {
+            BRAIN_DELETE(loader->_batches[i]._inputs);
+            BRAIN_DELETE(loader->_batches[i]._outputs);
+        }
+
+        BRAIN_DELETE(loader->_batches);
+        BRAIN_DELETE(loader);
+    }
+}
+
+void
+accumulate_batch_loader_memory(const BrainBatchLoader loader, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(loader))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < loader->_number_of_batches; ++i)
+        {
+            accumulate_memory_usage(usage, loader->_batches[i]._inputs);
+            accumulate_memory_usage(usage, loader->_batches[i]._outputs);
+        }
+
+        accumulate_memory_usage(usage, loader->_batches);
+        accumulate_memory_usage(usage, loader);
+    }
+}
+
+BrainUint
+batch_loader_acquire(BrainBatchLoader loader,
+                     BrainSignal* inputs,
+                     BrainSignal* outputs)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(loader))
+    {
+        pthread_mutex_lock(&loader->_mutex);
+        while ((loader->_ready == 0)
+        &&     !loader->_finished)
+        {
+            pthread_cond_wait(&loader->_not_empty, &loader->_mutex);
+        }
+
+        if (0 < loader->_ready)
+        {
+            const Batch* batch = &(loader->_batches[loader->_head]);
+
+            ret = batch->_size;
+
+            if (BRAIN_ALLOCATED(inputs))
+            {
+                *inputs = batch->_inputs;
+            }
+
+            if (BRAIN_ALLOCATED(outputs))
+            {
+                *outputs = batch->_outputs;
+            }
+        }
+        pthread_mutex_unlock(&loader->_mutex);
+    }
+
+    return ret;
+}
+
+void
+batch_loader_release(BrainBatchLoader loader)
+{
+    if (BRAIN_ALLOCATED(loader))
+    {
+        pthread_mutex_lock(&loader->_mutex);
+        if (0 < loader->_ready)
+        {
+            loader->_head = (loader->_head + 1) % loader->_number_of_batches;
+            --loader->_ready;
+            pthread_cond_signal(&loader->_not_full);
+        }
+        pthread_mutex_unlock(&loader->_mutex);
+    }
+}
+
+BrainUint
+get_batch_loader_batch_size(const BrainBatchLoader loader)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(loader))
+    {
+        ret = loader->_batch_size;
+    }
+
+    return ret;
+}
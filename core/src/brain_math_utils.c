@@ -1,6 +1,23 @@
 #include "brain_math_utils.h"
 #include "brain_memory_utils.h"
 #include "brain_random_utils.h"
+#include <pthread.h>
+
+/**********************************************************************/
+/**  Fast activations interpolate tables sampled every 1/64, linear  **/
+/**  interpolation error is below h² max|f''| / 8                    **/
+/**********************************************************************/
+#define BRAIN_FAST_STEPS_PER_UNIT 64
+#define BRAIN_FAST_TANH_RANGE     8
+#define BRAIN_FAST_SOFTPLUS_RANGE 16
+#define BRAIN_FAST_TANH_SIZE      (2 * BRAIN_FAST_TANH_RANGE * BRAIN_FAST_STEPS_PER_UNIT)
+#define BRAIN_FAST_SOFTPLUS_SIZE  (BRAIN_FAST_SOFTPLUS_RANGE * BRAIN_FAST_STEPS_PER_UNIT)
+#define BRAIN_FAST_ATAN_SIZE      (4 * BRAIN_FAST_STEPS_PER_UNIT)
+
+static pthread_once_t _fast_once = PTHREAD_ONCE_INIT;
+static BrainReal      _fast_tanh[BRAIN_FAST_TANH_SIZE + 1];
+static BrainReal      _fast_softplus[BRAIN_FAST_SOFTPLUS_SIZE + 1];
+static BrainReal      _fast_atan[BRAIN_FAST_ATAN_SIZE + 1];
 /**********************************************************************/
 /**                       ACTIVATION FUNCTIONS                       **/
 /**********************************************************************/
@@ -91,6 +108,209 @@ relu_derivative(const BrainReal value)
     return value > 0. ? 1. : 0.;
 }
 
+/**********************************************************************/
+/**                     FAST ACTIVATION FUNCTIONS                    **/
+/**********************************************************************/
+static void
+fill_fast_tables()
+{
+    BrainUint i = 0;
+
+    // tanh on [-8, 8], saturated outside
+    for (i = 0; i <= BRAIN_FAST_TANH_SIZE; ++i)
+    {
+        const BrainDouble x = (BrainDouble)i / BRAIN_FAST_STEPS_PER_UNIT - BRAIN_FAST_TANH_RANGE;
+
+        _fast_tanh[i] = (BrainReal)tanh(x);
+    }
+
+    // log(1 + exp(-t)) on [0, 16], null outside
+    for (i = 0; i <= BRAIN_FAST_SOFTPLUS_SIZE; ++i)
+    {
+        const BrainDouble t = (BrainDouble)i / BRAIN_FAST_STEPS_PER_UNIT;
+
+        _fast_softplus[i] = (BrainReal)log1p(exp(-t));
+    }
+    _fast_softplus[BRAIN_FAST_SOFTPLUS_SIZE] = 0.;
+
+    // atan on [0, 1], larger values use atan(x) = pi/2 - atan(1/x)
+    for (i = 0; i <= BRAIN_FAST_ATAN_SIZE; ++i)
+    {
+        const BrainDouble x = (BrainDouble)i / BRAIN_FAST_ATAN_SIZE;
+
+        _fast_atan[i] = (BrainReal)atan(x);
+    }
+}
+
+static BrainReal
+interpolate(const BrainReal* table, const BrainUint size, BrainReal t)
+{
+    BrainUint i = 0;
+
+    // t is clamped so that both ends of the table saturate
+    t = MAX(t, (BrainReal)0.);
+    t = MIN(t, (BrainReal)size);
+    i = MIN((BrainUint)t, size - 1);
+
+    return table[i] + (t - (BrainReal)i) * (table[i + 1] - table[i]);
+}
+
+void
+initialize_fast_activations()
+{
+    pthread_once(&_fast_once, fill_fast_tables);
+}
+
+BrainReal
+fast_tangeant_hyperbolic(const BrainReal value)
+{
+    const BrainReal t = (value + BRAIN_FAST_TANH_RANGE) * BRAIN_FAST_STEPS_PER_UNIT;
+
+    return interpolate(_fast_tanh, BRAIN_FAST_TANH_SIZE, t);
+}
+
+BrainReal
+fast_sigmoid(const BrainReal value)
+{
+    // sigmoid(x) = (1 + tanh(x / 2)) / 2
+    return (BrainReal)0.5 + (BrainReal)0.5 * fast_tangeant_hyperbolic((BrainReal)0.5 * value);
+}
+
+BrainReal
+fast_softplus(const BrainReal value)
+{
+    // log(1 + exp(x)) = max(x, 0) + log(1 + exp(-|x|))
+    const BrainReal t = (BrainReal)fabs(value) * BRAIN_FAST_STEPS_PER_UNIT;
+
+    return MAX(value, (BrainReal)0.) + interpolate(_fast_softplus, BRAIN_FAST_SOFTPLUS_SIZE, t);
+}
+
+BrainReal
+fast_co_tangeant(const BrainReal value)
+{
+    const BrainReal x = (BrainReal)fabs(value);
+    BrainReal ret = 0.;
+
+    if (x <= (BrainReal)1.)
+    {
+        ret = interpolate(_fast_atan, BRAIN_FAST_ATAN_SIZE, x * BRAIN_FAST_ATAN_SIZE);
+    }
+    else
+    {
+        ret = (BrainReal)M_PI_2 - interpolate(_fast_atan, BRAIN_FAST_ATAN_SIZE, BRAIN_FAST_ATAN_SIZE / x);
+    }
+
+    return (value < (BrainReal)0.) ? -ret : ret;
+}
+
+/**********************************************************************/
+/**                        GRADIENT FUNCTIONS                        **/
+/**                                                                  **/
+/**  The derivative is computed from the output y = A(x) cached by   **/
+/**  the forward pass, outputs are y * scale under inverted dropout  **/
+/**********************************************************************/
+void
+identity_gradient(const BrainReal* outputs,
+                  const BrainReal* losses,
+                  const BrainReal  scale,
+                  BrainReal*       gradients,
+                  const BrainUint  number_of_outputs)
+{
+    BrainUint i = 0;
+
+    (void)outputs;
+
+#if defined(__GNUC__)
+    #pragma GCC ivdep
+#endif
+    for (i = 0; i < number_of_outputs; ++i)
+    {
+        gradients[i] = losses[i] * scale;
+    }
+}
+
+void
+sigmoid_gradient(const BrainReal* outputs,
+                 const BrainReal* losses,
+                 const BrainReal  scale,
+                 BrainReal*       gradients,
+                 const BrainUint  number_of_outputs)
+{
+    const BrainReal inverse = (BrainReal)1. / scale;
+    BrainUint i = 0;
+
+#if defined(__GNUC__)
+    #pragma GCC ivdep
+#endif
+    for (i = 0; i < number_of_outputs; ++i)
+    {
+        // A' = y * (1 - y)
+        const BrainReal y = outputs[i] * inverse;
+
+        gradients[i] = losses[i] * scale * y * ((BrainReal)1. - y);
+    }
+}
+
+void
+tangeant_hyperbolic_gradient(const BrainReal* outputs,
+                             const BrainReal* losses,
+                             const BrainReal  scale,
+                             BrainReal*       gradients,
+                             const BrainUint  number_of_outputs)
+{
+    const BrainReal inverse = (BrainReal)1. / scale;
+    BrainUint i = 0;
+
+#if defined(__GNUC__)
+    #pragma GCC ivdep
+#endif
+    for (i = 0; i < number_of_outputs; ++i)
+    {
+        // A' = 1 - y²
+        const BrainReal y = outputs[i] * inverse;
+
+        gradients[i] = losses[i] * scale * ((BrainReal)1. - y * y);
+    }
+}
+
+void
+softplus_gradient(const BrainReal* outputs,
+                  const BrainReal* losses,
+                  const BrainReal  scale,
+                  BrainReal*       gradients,
+                  const BrainUint  number_of_outputs)
+{
+    const BrainReal inverse = (BrainReal)1. / scale;
+    BrainUint i = 0;
+
+    for (i = 0; i < number_of_outputs; ++i)
+    {
+        // A' = sigmoid(x) = 1 - exp(-y)
+        const BrainReal y = outputs[i] * inverse;
+
+        gradients[i] = -losses[i] * scale * (BrainReal)expm1(-y);
+    }
+}
+
+void
+relu_gradient(const BrainReal* outputs,
+              const BrainReal* losses,
+              const BrainReal  scale,
+              BrainReal*       gradients,
+              const BrainUint  number_of_outputs)
+{
+    BrainUint i = 0;
+
+#if defined(__GNUC__)
+    #pragma GCC ivdep
+#endif
+    for (i = 0; i < number_of_outputs; ++i)
+    {
+        // A' = 1 if y > 0, the scale does not change the sign
+        gradients[i] = (0. < outputs[i]) ? losses[i] * scale : (BrainReal)0.;
+    }
+}
+
 /**********************************************************************/
 /**                        COST FUNCTION                             **/
 /**********************************************************************/
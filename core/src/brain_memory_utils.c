@@ -0,0 +1,576 @@
+#include "brain_memory_utils.h"
+#include <libxml/xmlmemory.h>
+
+/**
+ * \struct MemoryHeader
+ * \brief  Written just before every block, keeps the blocks 16 bytes aligned
+ */
+typedef struct MemoryHeader
+{
+    BrainUlong _size;    /*!< Usable size in bytes             */
+    BrainUint  _tag;     /*!< Accounted subsystem              */
+    BrainUint  _offset;  /*!< From the allocation to the block */
+} MemoryHeader;
+
+/**
+ * \struct MemoryArena
+ * \brief  Written at the start of an arena, its blocks follow
+ */
+typedef struct MemoryArena
+{
+    BrainChar* _memory;  /*!< Allocation holding the arena      */
+    size_t     _size;    /*!< From the arena to its end         */
+    size_t     _used;    /*!< From the arena to the free bytes  */
+    BrainUint  _blocks;  /*!< Allocated blocks, one more if open */
+} MemoryArena;
+
+/**
+ * \def MEMORY_ARENA_BLOCK
+ * \brief set in the tag of a block carved out of an arena
+ */
+#define MEMORY_ARENA_BLOCK 0x80000000u
+
+static void*
+default_allocate(void* context, size_t size)
+{
+    return malloc(size);
+}
+
+static void*
+default_reallocate(void* context, void* pointer, size_t size)
+{
+    return realloc(pointer, size);
+}
+
+static void
+default_release(void* context, void* pointer)
+{
+    free(pointer);
+}
+
+static void*
+default_allocate_aligned(void* context, size_t alignment, size_t size)
+{
+    void* ret = NULL;
+
+    if (posix_memalign(&ret, alignment, size) != 0)
+    {
+        ret = NULL;
+    }
+
+    return ret;
+}
+
+static BrainAllocator _allocator = {default_allocate,
+                                    default_reallocate,
+                                    default_release,
+                                    default_allocate_aligned,
+                                    NULL};
+
+static BrainUlong _live_bytes[Memory_Last];
+static BrainUlong _peak_bytes[Memory_Last];
+static BrainUlong _allocations[Memory_Last];
+static BrainUlong _frees[Memory_Last];
+static BrainUlong _total_live_bytes = 0;
+static BrainUlong _total_peak_bytes = 0;
+
+static void
+raise_peak(BrainUlong* peak, const BrainUlong value)
+{
+    BrainUlong current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+
+    while ((current < value)
+    &&     !__atomic_compare_exchange_n(peak, &current, value, BRAIN_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void
+account_allocation(const BrainUint tag, const BrainUlong size)
+{
+    const BrainUlong live  = __atomic_add_fetch(&_live_bytes[tag], size, __ATOMIC_RELAXED);
+    const BrainUlong total = __atomic_add_fetch(&_total_live_bytes, size, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&_allocations[tag], 1, __ATOMIC_RELAXED);
+    raise_peak(&_peak_bytes[tag], live);
+    raise_peak(&_total_peak_bytes, total);
+}
+
+static void
+account_release(const BrainUint tag, const BrainUlong size)
+{
+    __atomic_sub_fetch(&_live_bytes[tag], size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&_total_live_bytes, size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_frees[tag], 1, __ATOMIC_RELAXED);
+}
+
+static MemoryHeader*
+get_memory_header(const void* pointer)
+{
+    return (MemoryHeader*)pointer - 1;
+}
+
+static BrainBool
+is_aligned_tag(const BrainUint tag)
+{
+    return (tag == Memory_Weights)
+    ||     (tag == Memory_Activations);
+}
+
+static BrainUint
+get_memory_tag(const MemoryHeader* header)
+{
+    return header->_tag & ~MEMORY_ARENA_BLOCK;
+}
+
+static size_t
+round_up(const size_t bytes, const size_t alignment)
+{
+    return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+static BrainBool
+get_memory_size(const size_t number, const size_t size, size_t* bytes)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    // room for the header, the alignment and the padding
+    if ((size == 0)
+    ||  (number <= (((size_t)-1) - 3 * BRAIN_MEMORY_ALIGNMENT) / size))
+    {
+        *bytes = number * size;
+        ret    = BRAIN_TRUE;
+    }
+
+    return ret;
+}
+
+static BrainChar*
+allocate_aligned_memory(const size_t size, BrainChar** memory)
+{
+    BrainChar* ret = NULL;
+
+    /******************************************************************/
+    /**   The returned bytes start on an aligned boundary and follow **/
+    /**   at least BRAIN_MEMORY_ALIGNMENT bytes of the allocation    **/
+    /******************************************************************/
+    if (BRAIN_ALLOCATED(_allocator.allocate_aligned))
+    {
+        *memory = (BrainChar*)_allocator.allocate_aligned(_allocator.context, BRAIN_MEMORY_ALIGNMENT, BRAIN_MEMORY_ALIGNMENT + size);
+        ret     = *memory + BRAIN_MEMORY_ALIGNMENT;
+    }
+    else
+    {
+        *memory = (BrainChar*)_allocator.allocate(_allocator.context, 2 * BRAIN_MEMORY_ALIGNMENT + size);
+        ret     = (BrainChar*)round_up((size_t)*memory + BRAIN_MEMORY_ALIGNMENT, BRAIN_MEMORY_ALIGNMENT);
+    }
+
+    return BRAIN_ALLOCATED(*memory) ? ret : NULL;
+}
+
+static void*
+allocate_block(const size_t bytes, const BrainUint tag)
+{
+    void*      ret    = NULL;
+    BrainChar* memory = NULL;
+    BrainChar* block  = NULL;
+
+    if (is_aligned_tag(tag))
+    {
+        /**************************************************************/
+        /**   The header lives in the last bytes of an aligned       **/
+        /**   prefix, and the padding is zeroed for the kernels      **/
+        /**************************************************************/
+        const size_t usable = round_up(bytes, BRAIN_MEMORY_ALIGNMENT);
+
+        block = allocate_aligned_memory(usable, &memory);
+
+        if (BRAIN_ALLOCATED(memory))
+        {
+            get_memory_header(block)->_size = usable;
+        }
+    }
+    else
+    {
+        memory = (BrainChar*)_allocator.allocate(_allocator.context, sizeof(MemoryHeader) + bytes);
+        block  = memory + sizeof(MemoryHeader);
+
+        if (BRAIN_ALLOCATED(memory))
+        {
+            get_memory_header(block)->_size = bytes;
+        }
+    }
+
+    if (BRAIN_ALLOCATED(memory))
+    {
+        MemoryHeader* header = get_memory_header(block);
+
+        header->_tag    = tag;
+        header->_offset = (BrainUint)(block - memory);
+        account_allocation(tag, header->_size);
+        ret = block;
+    }
+
+    return ret;
+}
+
+static void*
+carve_block(MemoryArena* arena, const size_t bytes, const BrainUint tag)
+{
+    void*        ret    = NULL;
+    const size_t usable = is_aligned_tag(tag) ? round_up(bytes, BRAIN_MEMORY_ALIGNMENT) : bytes;
+    const size_t start  = is_aligned_tag(tag) ? round_up(arena->_used + sizeof(MemoryHeader), BRAIN_MEMORY_ALIGNMENT)
+                                              : arena->_used + sizeof(MemoryHeader);
+
+    if ((start <= arena->_size)
+    &&  (usable <= arena->_size - start))
+    {
+        /**************************************************************/
+        /**   The header of a carved block gives its distance to the **/
+        /**   arena, the next block starts on a header boundary      **/
+        /**************************************************************/
+        BrainChar*    block  = (BrainChar*)arena + start;
+        MemoryHeader* header = get_memory_header(block);
+
+        header->_size   = usable;
+        header->_tag    = tag | MEMORY_ARENA_BLOCK;
+        header->_offset = (BrainUint)start;
+        arena->_used    = round_up(start + usable, sizeof(MemoryHeader));
+        ++arena->_blocks;
+        account_allocation(tag, usable);
+        ret = block;
+    }
+
+    return ret;
+}
+
+static void
+release_arena(MemoryArena* arena)
+{
+    --arena->_blocks;
+
+    if (arena->_blocks == 0)
+    {
+        _allocator.release(_allocator.context, arena->_memory);
+    }
+}
+
+static void
+release_block(void* pointer)
+{
+    MemoryHeader* header = get_memory_header(pointer);
+
+    account_release(get_memory_tag(header), header->_size);
+
+    if (header->_tag & MEMORY_ARENA_BLOCK)
+    {
+        release_arena((MemoryArena*)((BrainChar*)pointer - header->_offset));
+    }
+    else
+    {
+        _allocator.release(_allocator.context, (BrainChar*)pointer - header->_offset);
+    }
+}
+
+void*
+brain_memory_allocate(const size_t number, const size_t size, const BrainMemoryTag tag)
+{
+    void*  ret   = NULL;
+    size_t bytes = 0;
+
+    if (get_memory_size(number, size, &bytes))
+    {
+        ret = allocate_block(bytes, tag);
+
+        if (BRAIN_ALLOCATED(ret))
+        {
+            memset(ret, 0, brain_memory_size(ret));
+        }
+    }
+
+    return ret;
+}
+
+void*
+brain_memory_resize(void* pointer, const size_t number, const size_t size, const BrainMemoryTag tag)
+{
+    void*  ret   = NULL;
+    size_t bytes = 0;
+
+    if (!BRAIN_ALLOCATED(pointer))
+    {
+        ret = brain_memory_allocate(number, size, (tag == Memory_Last) ? Memory_Other : tag);
+    }
+    else if (get_memory_size(number, size, &bytes))
+    {
+        if (bytes == 0)
+        {
+            brain_memory_free(pointer);
+        }
+        else
+        {
+            MemoryHeader*    header = get_memory_header(pointer);
+            const BrainUlong former = header->_size;
+            const BrainUint  from   = get_memory_tag(header);
+            const BrainUint  to     = (tag == Memory_Last) ? from : (BrainUint)tag;
+
+            if (!(header->_tag & MEMORY_ARENA_BLOCK)
+            &&  !is_aligned_tag(from)
+            &&  !is_aligned_tag(to)
+            &&  BRAIN_ALLOCATED(_allocator.reallocate))
+            {
+                BrainChar* memory = (BrainChar*)_allocator.reallocate(_allocator.context,
+                                                                      (BrainChar*)pointer - sizeof(MemoryHeader),
+                                                                      sizeof(MemoryHeader) + bytes);
+
+                if (BRAIN_ALLOCATED(memory))
+                {
+                    ret    = memory + sizeof(MemoryHeader);
+                    header = get_memory_header(ret);
+                    header->_size = bytes;
+                    header->_tag  = to;
+                    // a resize is accounted as a release and an allocation
+                    account_release(from, former);
+                    account_allocation(to, bytes);
+                }
+            }
+            else
+            {
+                /**********************************************************/
+                /**  An aligned or carved block cannot be reallocated in **/
+                /**  place: move it, like realloc the new bytes are not  **/
+                /**  zeroed but the padding is                           **/
+                /**********************************************************/
+                ret = allocate_block(bytes, to);
+
+                if (BRAIN_ALLOCATED(ret))
+                {
+                    const size_t usable = brain_memory_size(ret);
+
+                    memcpy(ret, pointer, (former < bytes) ? former : bytes);
+                    memset((BrainChar*)ret + bytes, 0, usable - bytes);
+                    release_block(pointer);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+void
+brain_memory_free(void* pointer)
+{
+    if (BRAIN_ALLOCATED(pointer))
+    {
+        release_block(pointer);
+    }
+}
+
+size_t
+brain_memory_size(const void* pointer)
+{
+    size_t ret = 0;
+
+    if (BRAIN_ALLOCATED(pointer))
+    {
+        ret = get_memory_header(pointer)->_size;
+    }
+
+    return ret;
+}
+
+size_t
+get_memory_arena_footprint(const size_t number, const size_t size, const BrainMemoryTag tag)
+{
+    size_t ret   = 0;
+    size_t bytes = 0;
+
+    // the worst alignment of the block and the padding up to the next header
+    if (get_memory_size(number, size, &bytes))
+    {
+        ret = is_aligned_tag(tag) ? BRAIN_MEMORY_ALIGNMENT + round_up(bytes, BRAIN_MEMORY_ALIGNMENT)
+                                  : sizeof(MemoryHeader)   + round_up(bytes, sizeof(MemoryHeader));
+    }
+
+    return ret;
+}
+
+BrainMemoryArena
+new_memory_arena(const size_t size)
+{
+    BrainMemoryArena ret    = NULL;
+    BrainChar*       memory = NULL;
+
+    // the offset of a block is kept on 32 bits
+    if (size <= (size_t)0xFFFFFFFFu - BRAIN_MEMORY_ALIGNMENT)
+    {
+        ret = (BrainMemoryArena)allocate_aligned_memory(BRAIN_MEMORY_ALIGNMENT + size, &memory);
+
+        if (BRAIN_ALLOCATED(ret))
+        {
+            ret->_memory = memory;
+            ret->_size   = BRAIN_MEMORY_ALIGNMENT + size;
+            ret->_used   = BRAIN_MEMORY_ALIGNMENT;
+            ret->_blocks = 1;
+        }
+    }
+
+    return ret;
+}
+
+void*
+brain_memory_arena_allocate(BrainMemoryArena arena, const size_t number, const size_t size, const BrainMemoryTag tag)
+{
+    void*  ret   = NULL;
+    size_t bytes = 0;
+
+    if (BRAIN_ALLOCATED(arena)
+    &&  get_memory_size(number, size, &bytes))
+    {
+        ret = carve_block(arena, bytes, tag);
+
+        if (BRAIN_ALLOCATED(ret))
+        {
+            memset(ret, 0, brain_memory_size(ret));
+        }
+    }
+
+    if (!BRAIN_ALLOCATED(ret))
+    {
+        ret = brain_memory_allocate(number, size, tag);
+    }
+
+    return ret;
+}
+
+void
+close_memory_arena(BrainMemoryArena arena)
+{
+    if (BRAIN_ALLOCATED(arena))
+    {
+        // nothing more can be carved
+        arena->_size = arena->_used;
+        release_arena(arena);
+    }
+}
+
+BrainBool
+brain_memory_set_allocator(const BrainAllocator* allocator)
+{
+    BrainBool ret = BRAIN_TRUE;
+    BrainUint i   = 0;
+
+    for (i = 0; i < Memory_Last; ++i)
+    {
+        if (__atomic_load_n(&_allocations[i], __ATOMIC_RELAXED) != __atomic_load_n(&_frees[i], __ATOMIC_RELAXED))
+        {
+            ret = BRAIN_FALSE;
+        }
+    }
+
+    if (ret
+    &&  BRAIN_ALLOCATED(allocator))
+    {
+        ret = BRAIN_ALLOCATED(allocator->allocate)
+        &&    BRAIN_ALLOCATED(allocator->release);
+
+        if (ret)
+        {
+            _allocator = *allocator;
+        }
+    }
+    else if (ret)
+    {
+        _allocator.allocate         = default_allocate;
+        _allocator.reallocate       = default_reallocate;
+        _allocator.release          = default_release;
+        _allocator.allocate_aligned = default_allocate_aligned;
+        _allocator.context          = NULL;
+    }
+
+    return ret;
+}
+
+void
+get_memory_stats(MemoryStats* stats)
+{
+    if (BRAIN_ALLOCATED(stats))
+    {
+        BrainUint i = 0;
+
+        for (i = 0; i < Memory_Last; ++i)
+        {
+            stats->live_bytes[i]  = __atomic_load_n(&_live_bytes[i],  __ATOMIC_RELAXED);
+            stats->peak_bytes[i]  = __atomic_load_n(&_peak_bytes[i],  __ATOMIC_RELAXED);
+            stats->allocations[i] = __atomic_load_n(&_allocations[i], __ATOMIC_RELAXED);
+            stats->frees[i]       = __atomic_load_n(&_frees[i],       __ATOMIC_RELAXED);
+        }
+
+        stats->total_live_bytes = __atomic_load_n(&_total_live_bytes, __ATOMIC_RELAXED);
+        stats->total_peak_bytes = __atomic_load_n(&_total_peak_bytes, __ATOMIC_RELAXED);
+    }
+}
+
+void
+reset_memory_peaks()
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < Memory_Last; ++i)
+    {
+        __atomic_store_n(&_peak_bytes[i], __atomic_load_n(&_live_bytes[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&_total_peak_bytes, __atomic_load_n(&_total_live_bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void
+accumulate_memory_usage(MemoryUsage* usage, const void* pointer)
+{
+    if (BRAIN_ALLOCATED(usage)
+    &&  BRAIN_ALLOCATED(pointer))
+    {
+        const MemoryHeader* header = get_memory_header(pointer);
+        const BrainUint     tag    = get_memory_tag(header);
+
+        usage->bytes[tag]  += header->_size;
+        usage->blocks[tag] += 1;
+        usage->total_bytes          += header->_size;
+    }
+}
+
+/**********************************************************************/
+/**                    LIBXML2 ACCOUNTED ALLOCATORS                  **/
+/**********************************************************************/
+static void*
+xml_malloc(size_t size)
+{
+    return brain_memory_allocate(size, 1, Memory_XML);
+}
+
+static void*
+xml_realloc(void* pointer, size_t size)
+{
+    return brain_memory_resize(pointer, size, 1, Memory_XML);
+}
+
+static char*
+xml_strdup(const char* string)
+{
+    const size_t length = strlen(string) + 1;
+    char*        ret    = (char*)brain_memory_allocate(length, 1, Memory_XML);
+
+    if (BRAIN_ALLOCATED(ret))
+    {
+        memcpy(ret, string, length);
+    }
+
+    return ret;
+}
+
+BrainBool
+brain_memory_track_xml()
+{
+    return (xmlMemSetup(brain_memory_free, xml_malloc, xml_realloc, xml_strdup) == 0);
+}
@@ -0,0 +1,12 @@
+#include "brain_probe.h"
+#include <time.h>
+
+BrainDouble
+brain_probe_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (BrainDouble)now.tv_sec + 1e-9 * (BrainDouble)now.tv_nsec;
+}
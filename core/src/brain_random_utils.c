@@ -1,65 +1,83 @@
 #include "brain_random_utils.h"
 #include "brain_memory_utils.h"
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 
-#define BRAIN_MASK_SIZE (8 * sizeof(BrainUint))
-#define BRAIN_ACTIVATION(mask,j,k) ((mask[j] >> k) & 0x00000001)
+#define BRAIN_MASK_LANES 65536
 
+/**
+ * \struct Random
+ * \brief  Internal model for a BrainRandom, a xoshiro256** state
+ */
+typedef struct Random
+{
+    BrainUlong _s[4]; /*!< Generator state, never all zero */
+} Random;
+
+static pthread_mutex_t _random_mutex = PTHREAD_MUTEX_INITIALIZER;
+static Random          _random_base;
+static BrainUint       _random_generation = 0;
+static __thread Random    _thread_random;
+static __thread BrainUint _thread_generation = 0;
+
+static BrainUlong
+rotl(const BrainUlong x, const BrainInt k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static BrainUlong
+splitmix64(BrainUlong* x)
+{
+    BrainUlong z = (*x += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
+
+/**
+ * \struct RandomMask
+ * \brief  Internal model for a BrainRandomMask
+ *
+ * The mask is the compacted list of kept elements, so its users only
+ * loop over the kept ones. Each 64 bits draw gives four 16 bits lanes,
+ * one per element, which is kept when its lane is not under the rate.
+ */
 typedef struct RandomMask
 {
-    BrainUint  _number_of_elements;
-    BrainUint  _mask_size;
-    BrainUint* _mask_node;
-    BrainUint* _mask_slot;
-    BrainUint* _mask_max;
-    BrainUint* _mask;
+    BrainUint  _number_of_elements; /*!< Number of elements            */
+    BrainUint  _number_of_kept;     /*!< Number of kept elements       */
+    BrainUint  _threshold;          /*!< Rate scaled on 16 bits        */
+    BrainUint* _kept;               /*!< Kept elements, in order       */
 } RandomMask;
 
 BrainRandomMask
-new_random_mask(const BrainUint number_of_elements)
+new_random_mask(const BrainUint number_of_elements, const BrainReal rate)
 {
-    BrainUint i = 0;
     BrainRandomMask _random_mask = NULL;
+    BrainDouble     threshold    = 0.;
 
     BRAIN_NEW(_random_mask, RandomMask, 1);
+    // the lanes are padded to a multiple of four elements
+    BRAIN_NEW(_random_mask->_kept, BrainUint, number_of_elements + 4);
 
-    _random_mask->_number_of_elements = number_of_elements;
-    _random_mask->_mask_size  = (BrainUint)(number_of_elements / BRAIN_MASK_SIZE);
-    if (_random_mask->_mask_size == 0)
-    {
-        _random_mask->_mask_size = 1;
-    }
-    else
+    if (0. < rate)
     {
-        if ((number_of_elements - _random_mask->_mask_size * BRAIN_MASK_SIZE) >= 1)
-        {
-            ++_random_mask->_mask_size;
-        }
+        threshold = (BrainDouble)rate * (BrainDouble)BRAIN_MASK_LANES + 0.5;
     }
 
-    BRAIN_NEW(_random_mask->_mask,      BrainUint, _random_mask->_mask_size);
-    BRAIN_NEW(_random_mask->_mask_max,  BrainUint, _random_mask->_mask_size);
-    BRAIN_NEW(_random_mask->_mask_node, BrainUint, number_of_elements);
-    BRAIN_NEW(_random_mask->_mask_slot, BrainUint, number_of_elements);
-
-    BRAIN_SET(_random_mask->_mask_max, UINT_MAX, BrainUint, _random_mask->_mask_size);
-    if (_random_mask->_mask_size == 1)
-    {
-        _random_mask->_mask_max[0] = pow(2, number_of_elements) - 1;
-    }
-    else
+    if ((BrainDouble)(BRAIN_MASK_LANES - 1) < threshold)
     {
-        if (_random_mask->_mask_size > 1)
-        {
-            _random_mask->_mask_max[_random_mask->_mask_size - 1] = pow(2, number_of_elements - _random_mask->_mask_size * BRAIN_MASK_SIZE) - 1;
-        }
+        threshold = (BrainDouble)(BRAIN_MASK_LANES - 1);
     }
 
-    for (i = 0; i < number_of_elements; ++i)
-    {
-        _random_mask->_mask_node[i] = i / BRAIN_MASK_SIZE;
-        _random_mask->_mask_slot[i] = i % BRAIN_MASK_SIZE;
-    }
+    _random_mask->_number_of_elements = number_of_elements;
+    _random_mask->_threshold          = (BrainUint)threshold;
+
+    generate_unit_mask(_random_mask);
 
     return _random_mask;
 }
@@ -69,14 +87,21 @@ delete_random_mask(BrainRandomMask random_mask)
 {
     if (BRAIN_ALLOCATED(random_mask))
     {
-        BRAIN_DELETE(random_mask->_mask);
-        BRAIN_DELETE(random_mask->_mask_slot);
-        BRAIN_DELETE(random_mask->_mask_node);
-        BRAIN_DELETE(random_mask->_mask_max);
+        BRAIN_DELETE(random_mask->_kept);
         BRAIN_DELETE(random_mask);
     }
 }
 
+void
+accumulate_random_mask_memory(const BrainRandomMask random_mask, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(random_mask))
+    {
+        accumulate_memory_usage(usage, random_mask->_kept);
+        accumulate_memory_usage(usage, random_mask);
+    }
+}
+
 BrainUint
 generate_random_mask(BrainRandomMask random_mask)
 {
@@ -84,18 +109,36 @@ generate_random_mask(BrainRandomMask random_mask)
 
     if (BRAIN_ALLOCATED(random_mask))
     {
+        BrainRandom     random    = get_thread_random();
+        const BrainUint threshold = random_mask->_threshold;
+        BrainUint*      kept      = random_mask->_kept;
         BrainUint i = 0;
-        BrainUint j = 0;
 
-        for (i = 0; i < random_mask->_mask_size; ++i)
+        for (i = 0; i < random_mask->_number_of_elements; i += 4)
         {
-            random_mask->_mask[i] = (BrainUint)BRAIN_RAND_RANGE(0, random_mask->_mask_max[i]);
+            const BrainUlong bits = random_next(random);
+            /**********************************************************/
+            /**  Write every index and only move forward on a kept   **/
+            /**  one, so there is no branch to mispredict            **/
+            /**********************************************************/
+            kept[ret] = i;
+            ret += ((BrainUint)( bits        & 0xFFFF) >= threshold);
+            kept[ret] = i + 1;
+            ret += ((BrainUint)((bits >> 16) & 0xFFFF) >= threshold);
+            kept[ret] = i + 2;
+            ret += ((BrainUint)((bits >> 32) & 0xFFFF) >= threshold);
+            kept[ret] = i + 3;
+            ret += ((BrainUint)((bits >> 48) & 0xFFFF) >= threshold);
+        }
 
-            for (j = 0; j < BRAIN_MASK_SIZE; ++j)
-            {
-                ret += BRAIN_ACTIVATION(random_mask->_mask, i, j);
-            }
+        // forget the padding lanes
+        while ((0 < ret)
+        &&     (random_mask->_number_of_elements <= kept[ret - 1]))
+        {
+            --ret;
         }
+
+        random_mask->_number_of_kept = ret;
     }
 
     return ret;
@@ -106,24 +149,277 @@ generate_unit_mask(BrainRandomMask random_mask)
 {
     if (BRAIN_ALLOCATED(random_mask))
     {
-        BRAIN_SET(random_mask->_mask, UINT_MAX, BrainUint, random_mask->_mask_size);
+        BrainUint i = 0;
+
+        for (i = 0; i < random_mask->_number_of_elements; ++i)
+        {
+            random_mask->_kept[i] = i;
+        }
+
+        random_mask->_number_of_kept = random_mask->_number_of_elements;
+    }
+}
+
+const BrainUint*
+get_random_mask_indices(const BrainRandomMask random_mask)
+{
+    const BrainUint* ret = NULL;
+
+    if (BRAIN_ALLOCATED(random_mask))
+    {
+        ret = random_mask->_kept;
+    }
+
+    return ret;
+}
+
+BrainUint
+get_random_mask_size(const BrainRandomMask random_mask)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(random_mask))
+    {
+        ret = random_mask->_number_of_kept;
     }
+
+    return ret;
 }
 
+BrainRandom
+new_random(const BrainUlong seed)
+{
+    BrainRandom random = NULL;
+
+    BRAIN_NEW(random, Random, 1);
+    seed_random(random, seed);
+
+    return random;
+}
 
-BrainBool
-get_random_state(const BrainRandomMask random_mask, const BrainUint index)
+void
+delete_random(BrainRandom random)
 {
-    BrainBool ret = BRAIN_TRUE;
+    BRAIN_DELETE(random);
+}
 
-    if (BRAIN_ALLOCATED(random_mask) &&
-        (index < random_mask->_number_of_elements))
+void
+seed_random(BrainRandom random, const BrainUlong seed)
+{
+    if (BRAIN_ALLOCATED(random))
     {
-        const BrainUint j = random_mask->_mask_node[index];
-        const BrainUint k = random_mask->_mask_slot[index];
+        // splitmix64 spreads any seed, even 0, over the whole state
+        BrainUlong x = seed;
+
+        random->_s[0] = splitmix64(&x);
+        random->_s[1] = splitmix64(&x);
+        random->_s[2] = splitmix64(&x);
+        random->_s[3] = splitmix64(&x);
+    }
+}
 
-        ret = BRAIN_ACTIVATION(random_mask->_mask, j, k);
+void
+copy_random(const BrainRandom src, BrainRandom dst)
+{
+    if (BRAIN_ALLOCATED(src)
+    &&  BRAIN_ALLOCATED(dst))
+    {
+        BRAIN_COPY(src->_s, dst->_s, BrainUlong, 4);
     }
+}
+
+BrainUlong
+random_next(BrainRandom random)
+{
+    BrainUlong* s = random->_s;
+    const BrainUlong ret = rotl(s[1] * 5, 7) * 9;
+    const BrainUlong t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
 
     return ret;
 }
+
+void
+jump_random(BrainRandom random)
+{
+    static const BrainUlong jump[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                       0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    if (BRAIN_ALLOCATED(random))
+    {
+        BrainUlong s[4] = {0, 0, 0, 0};
+        BrainUint i = 0;
+        BrainInt b = 0;
+        /**************************************************************/
+        /**      Equivalent to 2^128 calls to random_next            **/
+        /**************************************************************/
+        for (i = 0; i < 4; ++i)
+        {
+            for (b = 0; b < 64; ++b)
+            {
+                if (jump[i] & (1ULL << b))
+                {
+                    s[0] ^= random->_s[0];
+                    s[1] ^= random->_s[1];
+                    s[2] ^= random->_s[2];
+                    s[3] ^= random->_s[3];
+                }
+
+                random_next(random);
+            }
+        }
+
+        BRAIN_COPY(s, random->_s, BrainUlong, 4);
+    }
+}
+
+BrainDouble
+random_unit(BrainRandom random)
+{
+    // 53 random bits in [0, 1)
+    return (BrainDouble)(random_next(random) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+BrainDouble
+random_range(BrainRandom random, const BrainDouble min, const BrainDouble max)
+{
+    return min + random_unit(random) * (max - min);
+}
+
+BrainUint
+random_index(BrainRandom random, const BrainUint number_of_elements)
+{
+    // multiply and shift: uniform enough for 32 bits ranges, no division
+    return (BrainUint)(((random_next(random) >> 32) * (BrainUlong)number_of_elements) >> 32);
+}
+
+BrainDouble
+random_normal(BrainRandom random)
+{
+    const BrainDouble u = 1. - random_unit(random);
+    const BrainDouble v = random_unit(random);
+
+    return sqrt(-2. * log(u)) * cos(2. * M_PI * v);
+}
+
+void
+fill_random_uniform(BrainRandom random,
+                    BrainReal* values,
+                    const BrainUint number_of_values,
+                    const BrainReal min,
+                    const BrainReal max)
+{
+    if (BRAIN_ALLOCATED(random)
+    &&  BRAIN_ALLOCATED(values))
+    {
+        const BrainDouble scale = ((BrainDouble)max - (BrainDouble)min) * (1.0 / 9007199254740992.0);
+        BrainUint i = 0;
+
+        for (i = 0; i < number_of_values; ++i)
+        {
+            values[i] = (BrainReal)(min + (BrainDouble)(random_next(random) >> 11) * scale);
+        }
+    }
+}
+
+void
+fill_random_normal(BrainRandom random,
+                   BrainReal* values,
+                   const BrainUint number_of_values,
+                   const BrainReal mean,
+                   const BrainReal sigma)
+{
+    if (BRAIN_ALLOCATED(random)
+    &&  BRAIN_ALLOCATED(values))
+    {
+        BrainUint i = 0;
+        /**************************************************************/
+        /**       Box-Muller gives two values per pair of draws      **/
+        /**************************************************************/
+        for (i = 0; i + 1 < number_of_values; i += 2)
+        {
+            const BrainDouble u = 1. - random_unit(random);
+            const BrainDouble v = 2. * M_PI * random_unit(random);
+            const BrainDouble r = sigma * sqrt(-2. * log(u));
+
+            values[i]     = (BrainReal)(mean + r * cos(v));
+            values[i + 1] = (BrainReal)(mean + r * sin(v));
+        }
+
+        if (i < number_of_values)
+        {
+            values[i] = (BrainReal)(mean + sigma * random_normal(random));
+        }
+    }
+}
+
+void
+initialize_random()
+{
+    pthread_mutex_lock(&_random_mutex);
+
+    if (_random_generation == 0)
+    {
+        const char* value = getenv("BRAIN_SEED");
+        BrainUlong seed = 0;
+
+        if (BRAIN_ALLOCATED(value))
+        {
+            seed = strtoull(value, NULL, 10);
+        }
+        else
+        {
+            seed = ((BrainUlong)time(NULL) << 20) ^ (BrainUlong)getpid();
+        }
+
+        seed_random(&_random_base, seed);
+        __atomic_store_n(&_random_generation, 1, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&_random_mutex);
+}
+
+void
+set_random_seed(const BrainUlong seed)
+{
+    pthread_mutex_lock(&_random_mutex);
+
+    seed_random(&_random_base, seed);
+    // threads take a new stream on their next draw
+    __atomic_store_n(&_random_generation, _random_generation + 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&_random_mutex);
+}
+
+BrainRandom
+get_thread_random()
+{
+    BrainUint generation = __atomic_load_n(&_random_generation, __ATOMIC_ACQUIRE);
+
+    if (generation == 0)
+    {
+        initialize_random();
+        generation = __atomic_load_n(&_random_generation, __ATOMIC_ACQUIRE);
+    }
+
+    if (_thread_generation != generation)
+    {
+        /**************************************************************/
+        /**   Streams are handed out in order, each one is the base  **/
+        /**   state before a jump                                    **/
+        /**************************************************************/
+        pthread_mutex_lock(&_random_mutex);
+        copy_random(&_random_base, &_thread_random);
+        jump_random(&_random_base);
+        _thread_generation = _random_generation;
+        pthread_mutex_unlock(&_random_mutex);
+    }
+
+    return &_thread_random;
+}
@@ -2,6 +2,8 @@
 #include "brain_memory_utils.h"
 #include "brain_random_utils.h"
 #include "brain_math_utils.h"
+#include "brain_thread_utils.h"
+#include "brain_kmeans_utils.h"
 
 #include <math.h>
 
@@ -67,55 +69,460 @@ norm2(const BrainReal* a, const BrainUint size)
     return ret;
 }
 
+/**
+ * \struct SignalStatistics
+ * \brief  Internal model for a BrainSignalStatistics
+ *
+ * Running mean and sum of squared deviations (Welford), min and max of
+ * each component. Accumulators are kept in double precision.
+ */
+typedef struct SignalStatistics
+{
+    BrainUint    _size;  /*!< Signal length                       */
+    BrainUlong   _count; /*!< Number of accumulated signals       */
+    BrainDouble* _mean;  /*!< Running means                       */
+    BrainDouble* _m2;    /*!< Running sums of squared deviations  */
+    BrainReal*   _min;   /*!< Minimum values                      */
+    BrainReal*   _max;   /*!< Maximum values                      */
+} SignalStatistics;
+
+/**
+ * \struct StatisticsTask
+ * \brief  Per thread partial statistics
+ */
+typedef struct StatisticsTask
+{
+    BrainReal**            _signals;  /*!< Signals to accumulate  */
+    BrainSignalStatistics* _partials; /*!< One result per thread  */
+} StatisticsTask;
+
+/**
+ * \struct AffineTask
+ * \brief  Arguments of the parallel affine kernel
+ */
+typedef struct AffineTask
+{
+    BrainReal**      _signals;  /*!< Signals to transform   */
+    const BrainReal* _scales;   /*!< Scale of each column   */
+    const BrainReal* _shifts;   /*!< Shift of each column   */
+    BrainUint        _size;     /*!< Signal length          */
+} AffineTask;
+
+/**
+ * \struct ComposedAffineTask
+ * \brief  Arguments of the parallel composed affine kernel
+ */
+typedef struct ComposedAffineTask
+{
+    BrainReal**        _signals;  /*!< Signals to transform   */
+    const BrainDouble* _scales;   /*!< Scale of each column   */
+    const BrainDouble* _shifts;   /*!< Shift of each column   */
+    BrainUint          _size;     /*!< Signal length          */
+} ComposedAffineTask;
+
+#define BRAIN_SIGNAL_GRAIN 4096
+
+BrainSignalStatistics
+new_signal_statistics(const BrainUint size)
+{
+    BrainSignalStatistics statistics = NULL;
+
+    BRAIN_NEW(statistics, SignalStatistics, 1);
+    statistics->_size = size;
+    BRAIN_NEW(statistics->_mean, BrainDouble, size);
+    BRAIN_NEW(statistics->_m2,   BrainDouble, size);
+    BRAIN_NEW(statistics->_min,  BrainReal,   size);
+    BRAIN_NEW(statistics->_max,  BrainReal,   size);
+
+    return statistics;
+}
+
 void
-FindGaussianModel(BrainReal** signals,
-                      BrainReal* means,
-                      BrainReal* sigmas,
-                      const BrainUint number_of_signals,
-                      const BrainUint size)
+delete_signal_statistics(BrainSignalStatistics statistics)
 {
-    if (BRAIN_ALLOCATED(signals)
-    &&  BRAIN_ALLOCATED(means)
-    &&  BRAIN_ALLOCATED(sigmas)
-    &&  (0 < size)
-    &&  (number_of_signals))
+    if (BRAIN_ALLOCATED(statistics))
     {
-        BrainUint i = 0;
+        BRAIN_DELETE(statistics->_mean);
+        BRAIN_DELETE(statistics->_m2);
+        BRAIN_DELETE(statistics->_min);
+        BRAIN_DELETE(statistics->_max);
+        BRAIN_DELETE(statistics);
+    }
+}
+
+void
+reset_signal_statistics(BrainSignalStatistics statistics)
+{
+    if (BRAIN_ALLOCATED(statistics))
+    {
+        statistics->_count = 0;
+        BRAIN_SET(statistics->_mean, 0, BrainDouble, statistics->_size);
+        BRAIN_SET(statistics->_m2,   0, BrainDouble, statistics->_size);
+    }
+}
+
+void
+accumulate_signal_statistics(BrainSignalStatistics statistics, const BrainReal* signal)
+{
+    if (BRAIN_ALLOCATED(statistics)
+    &&  BRAIN_ALLOCATED(signal))
+    {
+        const BrainUint size = statistics->_size;
+        BrainDouble* mean = statistics->_mean;
+        BrainDouble* m2   = statistics->_m2;
         BrainUint j = 0;
+
+        ++statistics->_count;
+
+        if (statistics->_count == 1)
+        {
+            BRAIN_COPY(signal, statistics->_min, BrainReal, size);
+            BRAIN_COPY(signal, statistics->_max, BrainReal, size);
+        }
+        else
+        {
+            for (j = 0; j < size; ++j)
+            {
+                statistics->_min[j] = MIN(statistics->_min[j], signal[j]);
+                statistics->_max[j] = MAX(statistics->_max[j], signal[j]);
+            }
+        }
         /**************************************************************/
-        /**                       GET THE MEAN                       **/
+        /**                   WELFORD ONE PASS UPDATE                **/
         /**************************************************************/
-        for (j = 0; j < size; ++j)
         {
-            means[j] = 0.;
-            for (i = 0; i < number_of_signals; ++i)
+            const BrainDouble inv_count = 1.0 / (BrainDouble)statistics->_count;
+
+            for (j = 0; j < size; ++j)
+            {
+                const BrainDouble delta = (BrainDouble)signal[j] - mean[j];
+
+                mean[j] += delta * inv_count;
+                m2[j]   += delta * ((BrainDouble)signal[j] - mean[j]);
+            }
+        }
+    }
+}
+
+void
+merge_signal_statistics(BrainSignalStatistics statistics, const BrainSignalStatistics other)
+{
+    if (BRAIN_ALLOCATED(statistics)
+    &&  BRAIN_ALLOCATED(other)
+    &&  (statistics->_size == other->_size)
+    &&  (0 < other->_count))
+    {
+        if (statistics->_count == 0)
+        {
+            statistics->_count = other->_count;
+            BRAIN_COPY(other->_mean, statistics->_mean, BrainDouble, statistics->_size);
+            BRAIN_COPY(other->_m2,   statistics->_m2,   BrainDouble, statistics->_size);
+            BRAIN_COPY(other->_min,  statistics->_min,  BrainReal,   statistics->_size);
+            BRAIN_COPY(other->_max,  statistics->_max,  BrainReal,   statistics->_size);
+        }
+        else
+        {
+            /**********************************************************/
+            /**              CHAN PAIRWISE COMBINATION               **/
+            /**********************************************************/
+            const BrainDouble na = (BrainDouble)statistics->_count;
+            const BrainDouble nb = (BrainDouble)other->_count;
+            const BrainDouble n  = na + nb;
+            BrainUint j = 0;
+
+            for (j = 0; j < statistics->_size; ++j)
             {
-                if (BRAIN_ALLOCATED(signals[i]))
-                {
-                    means[j] += signals[i][j];
-                }
+                const BrainDouble delta = other->_mean[j] - statistics->_mean[j];
+
+                statistics->_mean[j] += delta * nb / n;
+                statistics->_m2[j]   += other->_m2[j] + delta * delta * na * nb / n;
+                statistics->_min[j]   = MIN(statistics->_min[j], other->_min[j]);
+                statistics->_max[j]   = MAX(statistics->_max[j], other->_max[j]);
             }
-            means[j] /= (BrainReal)number_of_signals;
+
+            statistics->_count += other->_count;
+        }
+    }
+}
+
+static void
+statistics_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    StatisticsTask* task = (StatisticsTask*)data;
+    BrainSignalStatistics partial = task->_partials[thread];
+    BrainUint i = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        accumulate_signal_statistics(partial, task->_signals[i]);
+    }
+}
+
+void
+find_signal_statistics(BrainSignalStatistics statistics,
+                       BrainReal** signals,
+                       const BrainUint number_of_signals)
+{
+    if (BRAIN_ALLOCATED(statistics)
+    &&  BRAIN_ALLOCATED(signals)
+    &&  (0 < number_of_signals))
+    {
+        const BrainUint number_of_threads = get_number_of_threads(number_of_signals, BRAIN_SIGNAL_GRAIN);
+        StatisticsTask task;
+        BrainUint i = 0;
+
+        task._signals = signals;
+        BRAIN_NEW(task._partials, BrainSignalStatistics, number_of_threads);
+
+        for (i = 0; i < number_of_threads; ++i)
+        {
+            task._partials[i] = new_signal_statistics(statistics->_size);
         }
         /**************************************************************/
-        /**                      GET THE VARIANCE                    **/
+        /**   Each thread walks its rows once, partials are merged   **/
         /**************************************************************/
-        for (j = 0; j < size; ++j)
+        parallel_for(number_of_signals, number_of_threads, statistics_worker, &task);
+
+        for (i = 0; i < number_of_threads; ++i)
+        {
+            merge_signal_statistics(statistics, task._partials[i]);
+            delete_signal_statistics(task._partials[i]);
+        }
+
+        BRAIN_DELETE(task._partials);
+    }
+}
+
+BrainUlong
+get_signal_statistics_count(const BrainSignalStatistics statistics)
+{
+    BrainUlong ret = 0;
+
+    if (BRAIN_ALLOCATED(statistics))
+    {
+        ret = statistics->_count;
+    }
+
+    return ret;
+}
+
+void
+get_signal_statistics(const BrainSignalStatistics statistics,
+                      BrainReal* means,
+                      BrainReal* variances,
+                      BrainReal* min,
+                      BrainReal* max)
+{
+    if (BRAIN_ALLOCATED(statistics)
+    &&  (0 < statistics->_count))
+    {
+        BrainUint j = 0;
+
+        for (j = 0; j < statistics->_size; ++j)
+        {
+            if (BRAIN_ALLOCATED(means))
+            {
+                means[j] = (BrainReal)statistics->_mean[j];
+            }
+
+            if (BRAIN_ALLOCATED(variances))
+            {
+                variances[j] = (BrainReal)(statistics->_m2[j] / (BrainDouble)statistics->_count);
+            }
+        }
+
+        if (BRAIN_ALLOCATED(min))
+        {
+            BRAIN_COPY(statistics->_min, min, BrainReal, statistics->_size);
+        }
+
+        if (BRAIN_ALLOCATED(max))
+        {
+            BRAIN_COPY(statistics->_max, max, BrainReal, statistics->_size);
+        }
+    }
+}
+
+static void
+affine_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    const AffineTask* task = (const AffineTask*)data;
+    const BrainReal* scales = task->_scales;
+    const BrainReal* shifts = task->_shifts;
+    const BrainUint size = task->_size;
+    BrainUint i = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        BrainReal* signal = task->_signals[i];
+        BrainUint j = 0;
+
+        if (BRAIN_ALLOCATED(signal))
         {
-            sigmas[j] = 0.;
-            for (i = 0; i < number_of_signals; ++i)
+            // a multiply-add per component, easily vectorized
+            for (j = 0; j < size; ++j)
+            {
+                signal[j] = signal[j] * scales[j] + shifts[j];
+            }
+        }
+    }
+}
+
+void
+ApplyAffineModel(BrainReal** signals,
+                 const BrainReal* scales,
+                 const BrainReal* shifts,
+                 const BrainUint number_of_signals,
+                 const BrainUint size)
+{
+    if (BRAIN_ALLOCATED(signals)
+    &&  BRAIN_ALLOCATED(scales)
+    &&  BRAIN_ALLOCATED(shifts)
+    &&  (0 < number_of_signals)
+    &&  (0 < size))
+    {
+        AffineTask task;
+
+        task._signals = signals;
+        task._scales  = scales;
+        task._shifts  = shifts;
+        task._size    = size;
+
+        parallel_for(number_of_signals,
+                     get_number_of_threads(number_of_signals, BRAIN_SIGNAL_GRAIN),
+                     affine_worker,
+                     &task);
+    }
+}
+
+static void
+composed_affine_worker(void* data, const BrainUint begin, const BrainUint end, const BrainUint thread)
+{
+    const ComposedAffineTask* task = (const ComposedAffineTask*)data;
+    const BrainDouble* scales = task->_scales;
+    const BrainDouble* shifts = task->_shifts;
+    const BrainUint size = task->_size;
+    BrainUint i = 0;
+
+    for (i = begin; i < end; ++i)
+    {
+        BrainReal* signal = task->_signals[i];
+        BrainUint j = 0;
+
+        if (BRAIN_ALLOCATED(signal))
+        {
+            // the signal is only rounded once, when it is stored back
+            for (j = 0; j < size; ++j)
             {
-                if (BRAIN_ALLOCATED(signals[i]))
-                {
-                    const BrainReal diff = signals[i][j] - means[j];
-                    sigmas[j] += diff * diff;
-                }
+                signal[j] = (BrainReal)(signal[j] * scales[j] + shifts[j]);
             }
-            sigmas[j] /= (BrainReal)number_of_signals;
         }
     }
 }
 
+void
+ReplaceAffineModel(BrainReal** signals,
+                   const BrainReal* former_scales,
+                   const BrainReal* former_shifts,
+                   const BrainReal* scales,
+                   const BrainReal* shifts,
+                   const BrainUint number_of_signals,
+                   const BrainUint size)
+{
+    if (BRAIN_ALLOCATED(signals)
+    &&  BRAIN_ALLOCATED(former_scales)
+    &&  BRAIN_ALLOCATED(former_shifts)
+    &&  BRAIN_ALLOCATED(scales)
+    &&  BRAIN_ALLOCATED(shifts)
+    &&  (0 < number_of_signals)
+    &&  (0 < size))
+    {
+        ComposedAffineTask task;
+        BrainDouble* composed_scales = NULL;
+        BrainDouble* composed_shifts = NULL;
+        BrainUint j = 0;
+
+        BRAIN_NEW(composed_scales, BrainDouble, size);
+        BRAIN_NEW(composed_shifts, BrainDouble, size);
+        /****************************************************************/
+        /**  The inverse of the former model and the new model compose **/
+        /**  into one affine model, kept in double precision           **/
+        /****************************************************************/
+        for (j = 0; j < size; ++j)
+        {
+            composed_scales[j] = (BrainDouble)scales[j] / (BrainDouble)former_scales[j];
+            composed_shifts[j] = (BrainDouble)shifts[j] - composed_scales[j] * (BrainDouble)former_shifts[j];
+        }
+
+        task._signals = signals;
+        task._scales  = composed_scales;
+        task._shifts  = composed_shifts;
+        task._size    = size;
+
+        parallel_for(number_of_signals,
+                     get_number_of_threads(number_of_signals, BRAIN_SIGNAL_GRAIN),
+                     composed_affine_worker,
+                     &task);
+
+        BRAIN_DELETE(composed_scales);
+        BRAIN_DELETE(composed_shifts);
+    }
+}
+
+void
+GetGaussianScale(const BrainReal* means,
+                 const BrainReal* sigmas,
+                 BrainReal* scales,
+                 BrainReal* shifts,
+                 const BrainUint size)
+{
+    BrainUint j = 0;
+
+    for (j = 0; j < size; ++j)
+    {
+        // a constant component is only centered
+        scales[j] = (0. < sigmas[j]) ? (BrainReal)(1.0 / sqrt(sigmas[j])) : 1.;
+        shifts[j] = -means[j] * scales[j];
+    }
+}
+
+void
+GetMinMaxScale(const BrainReal* min,
+               const BrainReal* max,
+               BrainReal* scales,
+               BrainReal* shifts,
+               const BrainUint size)
+{
+    BrainUint j = 0;
+
+    for (j = 0; j < size; ++j)
+    {
+        scales[j] = (min[j] < max[j]) ? (BrainReal)(1.0 / (max[j] - min[j])) : 1.;
+        shifts[j] = -((max[j] + min[j]) / 2.0) * scales[j];
+    }
+}
+
+void
+FindGaussianModel(BrainReal** signals,
+                      BrainReal* means,
+                      BrainReal* sigmas,
+                      const BrainUint number_of_signals,
+                      const BrainUint size)
+{
+    if (BRAIN_ALLOCATED(signals)
+    &&  BRAIN_ALLOCATED(means)
+    &&  BRAIN_ALLOCATED(sigmas)
+    &&  (0 < size)
+    &&  (number_of_signals))
+    {
+        BrainSignalStatistics statistics = new_signal_statistics(size);
+
+        find_signal_statistics(statistics, signals, number_of_signals);
+        get_signal_statistics(statistics, means, sigmas, NULL, NULL);
+        delete_signal_statistics(statistics);
+    }
+}
+
 void
 ApplyGaussianModel(BrainReal** signals,
                    BrainReal* means,
@@ -127,21 +534,19 @@ ApplyGaussianModel(BrainReal** signals,
     &&  BRAIN_ALLOCATED(sigmas)
     &&  BRAIN_ALLOCATED(means))
     {
-        BrainUint i;
-        BrainUint j;
+        BrainReal* scales = NULL;
+        BrainReal* shifts = NULL;
         /**************************************************************/
-        /**                  CENTER AND SCALE EACH VECTOR            **/
+        /**      CENTER AND SCALE EACH VECTOR WITH 1 / SQRT(SIGMA)   **/
         /**************************************************************/
-        for (i = 0; i < number_of_signals; ++i)
-        {
-            if (BRAIN_ALLOCATED(signals[i]))
-            {
-                for (j = 0;j < size; ++j)
-                {
-                    signals[i][j] = (signals[i][j] - means[j]) / sqrt(sigmas[j]);
-                }
-            }
-        }
+        BRAIN_NEW(scales, BrainReal, size);
+        BRAIN_NEW(shifts, BrainReal, size);
+
+        GetGaussianScale(means, sigmas, scales, shifts, size);
+        ApplyAffineModel(signals, scales, shifts, number_of_signals, size);
+
+        BRAIN_DELETE(scales);
+        BRAIN_DELETE(shifts);
     }
 }
 
@@ -156,20 +561,11 @@ void FindMinMaxModel(BrainReal** signals,
     &&  BRAIN_ALLOCATED(min)
     &&  BRAIN_ALLOCATED(max))
     {
-        BrainUint i = 0;
-        BrainUint j = 0;
+        BrainSignalStatistics statistics = new_signal_statistics(size);
 
-        BRAIN_COPY(signals[0], min, BrainReal, size);
-        BRAIN_COPY(signals[0], max, BrainReal, size);
-
-        for (i = 0; i < number_of_signals; ++i)
-        {
-            for (j = 0; j< size; ++j)
-            {
-                min[j] = MIN(min[j], signals[i][j]);
-                max[j] = MAX(max[j], signals[i][j]);
-            }
-        }
+        find_signal_statistics(statistics, signals, number_of_signals);
+        get_signal_statistics(statistics, NULL, NULL, min, max);
+        delete_signal_statistics(statistics);
     }
 }
 
@@ -186,20 +582,17 @@ ApplyMinMaxModel(BrainReal** signals,
     &&  BRAIN_ALLOCATED(min)
     &&  BRAIN_ALLOCATED(max))
     {
-        BrainUint i = 0;
-        BrainUint j = 0;
+        BrainReal* scales = NULL;
+        BrainReal* shifts = NULL;
 
-        for (i = 0; i < number_of_signals; ++i)
-        {
-            for (j = 0; j < size; ++j)
-            {
-                signals[i][j] = signals[i][j] - (max[j] + min[j]) / 2.0;
-                if (min[j] < max[j])
-                {
-                    signals[i][j] /= (max[j] - min[j]);
-                }
-            }
-        }
+        BRAIN_NEW(scales, BrainReal, size);
+        BRAIN_NEW(shifts, BrainReal, size);
+
+        GetMinMaxScale(min, max, scales, shifts, size);
+        ApplyAffineModel(signals, scales, shifts, number_of_signals, size);
+
+        BRAIN_DELETE(scales);
+        BRAIN_DELETE(shifts);
     }
 }
 
@@ -215,100 +608,16 @@ kmeans(BrainReal** signals,
         BRAIN_ALLOCATED(centers) &&
         BRAIN_ALLOCATED(labels))
     {
+        BrainKMeans model = new_kmeans(number_of_class, size);
         BrainUint i = 0;
-        BrainUint j = 0;
-        BrainUint k = 0;
-        BrainUint* tmp = NULL;
-        BrainUint new_index = 0;
-        BrainBool changed = BRAIN_TRUE;
-        /**************************************************************/
-        /**                    RANDOMLY SELECT K CENTROIDS           **/
-        /**************************************************************/
-        BRAIN_NEW(tmp, BrainUint, number_of_class);
+
+        fit_kmeans(model, signals, number_of_signals, labels);
+
         for (i = 0; i < number_of_class; ++i)
         {
-            BrainBool valid = BRAIN_TRUE;
-            do
-            {
-                new_index = BRAIN_RAND_RANGE(0,number_of_signals);
-
-                for (j = 0; j < number_of_class; ++j)
-                {
-                    if (tmp[j] == new_index)
-                    {
-                        valid = BRAIN_FALSE;
-                        break;
-                    }
-                }
-            } while (!valid);
-            tmp[i] = new_index;
-            BRAIN_COPY(signals[new_index], centers[i], BrainReal, size);
-        }
-        BRAIN_DELETE(tmp);
-        /**************************************************************/
-        /**              UPDATE ALL CENTROIDS AND LABELS             **/
-        /**************************************************************/
-        while (changed)
-        {
-            changed = BRAIN_FALSE;
-            /**********************************************************/
-            /**                  RECOMPUTE ALL LABELS                **/
-            /**********************************************************/
-            for (i = 0; i < number_of_signals; ++i)
-            {
-                BrainReal dist = distance(signals[i], centers[0], size);
-                BrainUint label = 0;
-                for (j = 1; j < number_of_class; ++j)
-                {
-                    const BrainReal new_dist = distance(signals[i], centers[j], size);
-                    if (new_dist < dist)
-                    {
-                        dist = new_dist;
-                        label = j;
-                    }
-                }
-
-                if (label != labels[i])
-                {
-                    labels[i] = label;
-                    changed = BRAIN_TRUE;
-                }
-            }
-            /**********************************************************/
-            /**                RECOMPUTE ALL CENTROIDS               **/
-            /**********************************************************/
-            if(changed)
-            {
-                for (i = 0; i < number_of_class; ++i)
-                {
-                    BrainUint num = 0;
-                    BRAIN_SET(centers[i], 0, BrainReal, number_of_class);
-                    /******************************************************/
-                    /**              CENTROIDS CALCULATION               **/
-                    /******************************************************/
-                    for (j = 0; j < number_of_signals; ++j)
-                    {
-                        if (labels[j] == i)
-                        {
-                            ++num;
-                            for (k = 0; k < size; ++k)
-                            {
-                                centers[i][k] += signals[j][k];
-                            }
-                        }
-                    }
-                    /******************************************************/
-                    /**               CENTROIDS AVERAGING                **/
-                    /******************************************************/
-                    for (k = 0; k < size; ++k)
-                    {
-                        if (0 < num)
-                        {
-                            centers[i][k] /= (BrainReal)num;
-                        }
-                    }
-                }
-            }
+            BRAIN_COPY(get_kmeans_center(model, i), centers[i], BrainReal, size);
         }
+
+        delete_kmeans(model);
     }
 }
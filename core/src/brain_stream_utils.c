@@ -0,0 +1,621 @@
+#include "brain_stream_utils.h"
+#include "brain_csv_utils.h"
+#include "brain_logging_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_random_utils.h"
+#include "brain_label_utils.h"
+#include <sys/stat.h>
+
+#define BRAIN_STREAM_CACHE_MAGIC "BRSC"
+
+/**
+ * \struct StreamCacheHeader
+ * \brief  Header of a binary cache file
+ *
+ * The number of rows is written once the whole repository has been
+ * cached, so an interrupted cache is never reused. The labels of a
+ * labelled repository are stored after the rows.
+ */
+typedef struct StreamCacheHeader
+{
+    BrainChar   _magic[4];          /*!< Cache file signature           */
+    BrainUint   _real_size;         /*!< sizeof(BrainReal)              */
+    BrainUint   _input_length;      /*!< Input signal length            */
+    BrainUint   _output_length;     /*!< Output signal length           */
+    BrainUlong  _number_of_rows;    /*!< Number of cached rows          */
+    BrainUlong  _source_size;       /*!< Size of the CSV repository     */
+    BrainUlong  _source_time;       /*!< Last CSV repository update     */
+    BrainUlong  _labels_offset;     /*!< Position of the labels         */
+} StreamCacheHeader;
+
+/**
+ * \struct DataStream
+ * \brief  Internal model for a BrainDataStream
+ *
+ * All protected fields for a BrainDataStream
+ */
+typedef struct DataStream
+{
+    /******************************************************************/
+    /**                        SOURCE PARAMETERS                     **/
+    /******************************************************************/
+    BrainCsvReader  _reader;            /*!< CSV reader                     */
+    BrainChar*      _path;              /*!< CSV repository                 */
+    BrainChar*      _tokenizer;         /*!< CSV tokenizer                  */
+    BrainChar*      _cache_path;        /*!< Binary cache file              */
+    FILE*           _cache;             /*!< Opened binary cache            */
+    BrainBool       _use_cache;         /*!< Rows are read from the cache   */
+    BrainBool       _is_labelled;       /*!< CSV contains labels            */
+    BrainLabelDictionary _labels;       /*!< Labels found by the decoder    */
+    BrainUlong      _cached_rows;       /*!< Number of rows in the cache    */
+    StreamDecodeCbk _decode;            /*!< CSV line decoder               */
+    void*           _data;              /*!< Decoder user data              */
+    BrainUint       _input_length;      /*!< Input signal length            */
+    BrainUint       _output_length;     /*!< Output signal length           */
+    /******************************************************************/
+    /**                        HOLDOUT PARAMETERS                    **/
+    /******************************************************************/
+    BrainReal       _training_ratio;    /*!< Ratio of training rows         */
+    BrainUint       _holdout_size;      /*!< Maximum number of holdout rows */
+    BrainUlong      _holdout_end;       /*!< Row after the last holdout row */
+    /******************************************************************/
+    /**                          SHUFFLE BUFFER                      **/
+    /******************************************************************/
+    BrainUint       _buffer_size;       /*!< Number of buffered rows        */
+    BrainUint       _filled;            /*!< Number of valid buffered rows  */
+    BrainSignal     _inputs;            /*!< Buffered input signals         */
+    BrainSignal     _outputs;           /*!< Buffered output signals        */
+    BrainSignal     _input;             /*!< Current input signal           */
+    BrainSignal     _output;            /*!< Current output signal          */
+    BrainBool       _exhausted;         /*!< End of the current pass        */
+    BrainBool       _started;           /*!< First pass has been started    */
+    BrainUlong      _row;               /*!< Position in the repository     */
+    BrainUlong      _number_of_rows;    /*!< Training rows per epoch        */
+    BrainUint       _epoch;             /*!< Completed passes               */
+} DataStream;
+
+static BrainChar*
+copy_string(BrainString value)
+{
+    BrainChar* ret = NULL;
+
+    if (BRAIN_ALLOCATED(value))
+    {
+        BRAIN_NEW(ret, BrainChar, strlen(value) + 1);
+        strcpy(ret, value);
+    }
+
+    return ret;
+}
+
+static BrainReal
+row_hash_unit(const BrainUlong row)
+{
+    // splitmix64 finalizer: a cheap and well spread row hash
+    BrainUlong z = row + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z =  z ^ (z >> 31);
+
+    return (BrainReal)((z >> 11) * (1.0 / 9007199254740992.0));
+}
+
+static BrainBool
+is_holdout_row(const BrainDataStream stream, const BrainUlong row)
+{
+    return (row < stream->_holdout_end)
+        && (stream->_training_ratio <= row_hash_unit(row));
+}
+
+static void
+get_source_stamp(BrainString path, BrainUlong* size, BrainUlong* time)
+{
+    struct stat buffer;
+
+    *size = 0;
+    *time = 0;
+
+    if (stat(path, &buffer) == 0)
+    {
+        *size = (BrainUlong)buffer.st_size;
+        *time = (BrainUlong)buffer.st_mtime;
+    }
+}
+
+static BrainBool
+read_cached_labels(BrainDataStream stream, FILE* cache, const BrainUlong offset)
+{
+    BrainBool ret = BRAIN_FALSE;
+    BrainLabelDictionary labels = new_label_dictionary();
+
+    if ((fseek(cache, (long)offset, SEEK_SET) == 0)
+    &&  read_label_dictionary(labels, cache))
+    {
+        const BrainUint number_of_labels = get_label_dictionary_size(stream->_labels);
+        BrainUint id = 0;
+
+        // labels already known must keep their id
+        ret = (number_of_labels <= get_label_dictionary_size(labels));
+
+        for (id = 0; ret && (id < number_of_labels); ++id)
+        {
+            ret = !strcmp(get_label_dictionary_label(labels, id),
+                          get_label_dictionary_label(stream->_labels, id));
+        }
+
+        if (ret)
+        {
+            copy_label_dictionary(labels, stream->_labels);
+        }
+    }
+
+    delete_label_dictionary(labels);
+
+    return ret;
+}
+
+static BrainBool
+open_valid_cache(BrainDataStream stream)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    // labels of a labelled repository are restored from the cache
+    if (BRAIN_ALLOCATED(stream->_cache_path)
+    &&  (!stream->_is_labelled || BRAIN_ALLOCATED(stream->_labels)))
+    {
+        FILE* cache = fopen(stream->_cache_path, "rb");
+
+        if (BRAIN_ALLOCATED(cache))
+        {
+            StreamCacheHeader header;
+            BrainUlong size = 0;
+            BrainUlong time = 0;
+
+            get_source_stamp(stream->_path, &size, &time);
+
+            if ((fread(&header, sizeof(StreamCacheHeader), 1, cache) == 1)
+            &&  !memcmp(header._magic, BRAIN_STREAM_CACHE_MAGIC, 4)
+            &&  (header._real_size      == sizeof(BrainReal))
+            &&  (header._input_length   == stream->_input_length)
+            &&  (header._output_length  == stream->_output_length)
+            &&  (header._source_size    == size)
+            &&  (header._source_time    == time)
+            &&  (0 < header._number_of_rows)
+            &&  (!stream->_is_labelled || read_cached_labels(stream, cache, header._labels_offset)))
+            {
+                stream->_cache       = cache;
+                stream->_cached_rows = header._number_of_rows;
+                ret = BRAIN_TRUE;
+            }
+            else
+            {
+                fclose(cache);
+            }
+        }
+    }
+
+    return ret;
+}
+
+static void
+write_cache_header(FILE* cache,
+                   BrainDataStream stream,
+                   const BrainUlong number_of_rows,
+                   const BrainUlong labels_offset)
+{
+    StreamCacheHeader header;
+
+    memset(&header, 0, sizeof(StreamCacheHeader));
+    memcpy(header._magic, BRAIN_STREAM_CACHE_MAGIC, 4);
+    header._real_size       = sizeof(BrainReal);
+    header._input_length    = stream->_input_length;
+    header._output_length   = stream->_output_length;
+    header._number_of_rows  = number_of_rows;
+    header._labels_offset   = labels_offset;
+    get_source_stamp(stream->_path, &header._source_size, &header._source_time);
+
+    fseek(cache, 0, SEEK_SET);
+    fwrite(&header, sizeof(StreamCacheHeader), 1, cache);
+}
+
+static void
+rewind_source(BrainDataStream stream)
+{
+    if (stream->_use_cache)
+    {
+        fseek(stream->_cache, sizeof(StreamCacheHeader), SEEK_SET);
+    }
+    else
+    {
+        csv_reader_rewind(stream->_reader);
+    }
+
+    stream->_row = 0;
+}
+
+static BrainBool
+read_source_row(BrainDataStream stream, BrainSignal input, BrainSignal output)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (stream->_use_cache)
+    {
+        ret = (stream->_row < stream->_cached_rows)
+           && (fread(input,  sizeof(BrainReal), stream->_input_length,  stream->_cache) == stream->_input_length)
+           && (fread(output, sizeof(BrainReal), stream->_output_length, stream->_cache) == stream->_output_length);
+    }
+    else
+    {
+        BrainString      label  = NULL;
+        const BrainReal* signal = NULL;
+
+        if (csv_reader_next(stream->_reader, &label, &signal))
+        {
+            BRAIN_SET(input,  0, BrainReal, stream->_input_length);
+            BRAIN_SET(output, 0, BrainReal, stream->_output_length);
+
+            stream->_decode(stream->_data, label, signal, input, output);
+            ret = BRAIN_TRUE;
+        }
+    }
+
+    if (ret)
+    {
+        ++stream->_row;
+    }
+
+    return ret;
+}
+
+static BrainBool
+read_training_row(BrainDataStream stream, BrainSignal input, BrainSignal output)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    do
+    {
+        ret = read_source_row(stream, input, output);
+    } while (ret && is_holdout_row(stream, stream->_row - 1));
+
+    return ret;
+}
+
+static void
+start_pass(BrainDataStream stream)
+{
+    BrainUint i = 0;
+
+    if (stream->_started)
+    {
+        __atomic_store_n(&(stream->_epoch), stream->_epoch + 1, __ATOMIC_RELAXED);
+    }
+
+    rewind_source(stream);
+
+    stream->_started   = BRAIN_TRUE;
+    stream->_exhausted = BRAIN_FALSE;
+    stream->_filled    = 0;
+
+    /******************************************************************/
+    /**                      FILL THE SHUFFLE BUFFER                 **/
+    /******************************************************************/
+    for (i = 0; i < stream->_buffer_size; ++i)
+    {
+        if (!read_training_row(stream,
+                               stream->_inputs  + i * stream->_input_length,
+                               stream->_outputs + i * stream->_output_length))
+        {
+            stream->_exhausted = BRAIN_TRUE;
+            break;
+        }
+
+        ++stream->_filled;
+    }
+}
+
+BrainDataStream
+new_data_stream(BrainString path,
+                BrainString tokenizer,
+                const BrainDataFormat format,
+                const BrainBool is_labelled,
+                const BrainUint input_length,
+                const BrainUint output_length,
+                const BrainUint buffer_size,
+                BrainString cache_path,
+                StreamDecodeCbk decode,
+                void* data)
+{
+    BRAIN_INPUT(new_data_stream)
+
+    BrainDataStream stream = NULL;
+
+    if (BRAIN_ALLOCATED(path)
+    &&  BRAIN_ALLOCATED(tokenizer)
+    &&  BRAIN_ALLOCATED(decode)
+    &&  (0 < buffer_size))
+    {
+        const BrainUint number_of_fields = is_labelled ? input_length : input_length + output_length;
+
+        BRAIN_NEW(stream, DataStream, 1);
+
+        stream->_path           = copy_string(path);
+        stream->_tokenizer      = copy_string(tokenizer);
+        stream->_cache_path     = copy_string(cache_path);
+        stream->_reader         = new_csv_reader(stream->_path, stream->_tokenizer, number_of_fields, format, is_labelled);
+        stream->_cache          = NULL;
+        stream->_use_cache      = BRAIN_FALSE;
+        stream->_is_labelled    = is_labelled;
+        stream->_labels         = NULL;
+        stream->_cached_rows    = 0;
+        stream->_decode         = decode;
+        stream->_data           = data;
+        stream->_input_length   = input_length;
+        stream->_output_length  = output_length;
+        stream->_training_ratio = 1.;
+        stream->_holdout_size   = 0;
+        stream->_holdout_end    = 0;
+        stream->_buffer_size    = buffer_size;
+        stream->_filled         = 0;
+        stream->_exhausted      = BRAIN_TRUE;
+        stream->_started        = BRAIN_FALSE;
+        stream->_row            = 0;
+        stream->_number_of_rows = 0;
+        stream->_epoch          = 0;
+
+        BRAIN_NEW_TAG(stream->_inputs,  BrainReal, buffer_size * input_length, Memory_Dataset);
+        BRAIN_NEW_TAG(stream->_outputs, BrainReal, buffer_size * output_length, Memory_Dataset);
+        BRAIN_NEW_TAG(stream->_input,   BrainReal, input_length, Memory_Dataset);
+        BRAIN_NEW_TAG(stream->_output,  BrainReal, output_length, Memory_Dataset);
+    }
+
+    BRAIN_OUTPUT(new_data_stream)
+
+    return stream;
+}
+
+void
+delete_data_stream(BrainDataStream stream)
+{
+    if (BRAIN_ALLOCATED(stream))
+    {
+        if (BRAIN_ALLOCATED(stream->_cache))
+        {
+            fclose(stream->_cache);
+        }
+
+        delete_csv_reader(stream->_reader);
+
+        BRAIN_DELETE(stream->_path);
+        BRAIN_DELETE(stream->_tokenizer);
+        BRAIN_DELETE(stream->_cache_path);
+        BRAIN_DELETE(stream->_inputs);
+        BRAIN_DELETE(stream->_outputs);
+        BRAIN_DELETE(stream->_input);
+        BRAIN_DELETE(stream->_output);
+        BRAIN_DELETE(stream);
+    }
+}
+
+void
+accumulate_data_stream_memory(const BrainDataStream stream, BrainMemoryUsage usage)
+{
+    if (BRAIN_ALLOCATED(stream))
+    {
+        // the labels belong to the data
+        accumulate_csv_reader_memory(stream->_reader, usage);
+        accumulate_memory_usage(usage, stream->_path);
+        accumulate_memory_usage(usage, stream->_tokenizer);
+        accumulate_memory_usage(usage, stream->_cache_path);
+        accumulate_memory_usage(usage, stream->_inputs);
+        accumulate_memory_usage(usage, stream->_outputs);
+        accumulate_memory_usage(usage, stream->_input);
+        accumulate_memory_usage(usage, stream->_output);
+        accumulate_memory_usage(usage, stream);
+    }
+}
+
+void
+set_data_stream_holdout(BrainDataStream stream,
+                        const BrainReal training_ratio,
+                        const BrainUint holdout_size)
+{
+    if (BRAIN_ALLOCATED(stream))
+    {
+        stream->_training_ratio = training_ratio;
+        stream->_holdout_size   = holdout_size;
+    }
+}
+
+void
+set_data_stream_labels(BrainDataStream stream, BrainLabelDictionary labels)
+{
+    if (BRAIN_ALLOCATED(stream))
+    {
+        stream->_labels = labels;
+    }
+}
+
+BrainUlong
+data_stream_prepare(BrainDataStream stream, StreamRowCbk cbk, void* data)
+{
+    BRAIN_INPUT(data_stream_prepare)
+
+    BrainUlong ret = 0;
+
+    if (BRAIN_ALLOCATED(stream))
+    {
+        FILE*     writer = NULL;
+        BrainUint holdout = 0;
+
+        stream->_use_cache = open_valid_cache(stream);
+
+        if (!stream->_use_cache)
+        {
+            if (csv_reader_open(stream->_reader)
+            &&  BRAIN_ALLOCATED(stream->_cache_path))
+            {
+                writer = fopen(stream->_cache_path, "w+b");
+
+                if (BRAIN_ALLOCATED(writer))
+                {
+                    write_cache_header(writer, stream, 0, 0);
+                }
+                else
+                {
+                    BRAIN_WARNING("Unable to create the cache %s\n", stream->_cache_path);
+                }
+            }
+        }
+
+        rewind_source(stream);
+        stream->_holdout_end = 0;
+        /**************************************************************/
+        /**               BROWSE THE WHOLE REPOSITORY ONCE           **/
+        /**************************************************************/
+        while (read_source_row(stream, stream->_input, stream->_output))
+        {
+            const BrainUlong row = stream->_row - 1;
+            BrainBool is_holdout = BRAIN_FALSE;
+
+            if ((holdout < stream->_holdout_size)
+            &&  (stream->_training_ratio <= row_hash_unit(row)))
+            {
+                is_holdout = BRAIN_TRUE;
+                stream->_holdout_end = row + 1;
+                ++holdout;
+            }
+            else
+            {
+                ++ret;
+            }
+
+            if (BRAIN_ALLOCATED(writer))
+            {
+                fwrite(stream->_input,  sizeof(BrainReal), stream->_input_length,  writer);
+                fwrite(stream->_output, sizeof(BrainReal), stream->_output_length, writer);
+            }
+
+            if (BRAIN_ALLOCATED(cbk))
+            {
+                cbk(data, stream->_input, stream->_output, is_holdout);
+            }
+        }
+        /**************************************************************/
+        /**          NEXT EPOCHS ARE READ FROM THE BINARY CACHE      **/
+        /**************************************************************/
+        if (BRAIN_ALLOCATED(writer))
+        {
+            const BrainUlong labels_offset = (BrainUlong)ftell(writer);
+
+            if (stream->_is_labelled)
+            {
+                write_label_dictionary(stream->_labels, writer);
+            }
+
+            write_cache_header(writer, stream, stream->_row, labels_offset);
+            fflush(writer);
+
+            csv_reader_close(stream->_reader);
+            stream->_cache       = writer;
+            stream->_cached_rows = stream->_row;
+            stream->_use_cache   = BRAIN_TRUE;
+        }
+
+        stream->_number_of_rows = ret;
+        stream->_started        = BRAIN_FALSE;
+        stream->_exhausted      = BRAIN_TRUE;
+        stream->_filled         = 0;
+        stream->_epoch          = 0;
+    }
+
+    BRAIN_OUTPUT(data_stream_prepare)
+
+    return ret;
+}
+
+BrainBool
+data_stream_next(BrainDataStream stream, BrainSignal* input, BrainSignal* output)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(stream))
+    {
+        if ((stream->_filled == 0)
+        &&  stream->_exhausted)
+        {
+            start_pass(stream);
+        }
+
+        if (0 < stream->_filled)
+        {
+            const BrainUint index = random_index(get_thread_random(), stream->_filled);
+            BrainSignal slot_input  = NULL;
+            BrainSignal slot_output = NULL;
+
+            slot_input  = stream->_inputs  + index * stream->_input_length;
+            slot_output = stream->_outputs + index * stream->_output_length;
+
+            BRAIN_COPY(slot_input,  stream->_input,  BrainReal, stream->_input_length);
+            BRAIN_COPY(slot_output, stream->_output, BrainReal, stream->_output_length);
+
+            /**********************************************************/
+            /**       REPLACE THE SERVED ROW WITH THE NEXT ONE       **/
+            /**********************************************************/
+            if (stream->_exhausted
+            ||  !read_training_row(stream, slot_input, slot_output))
+            {
+                const BrainUint last = stream->_filled - 1;
+
+                stream->_exhausted = BRAIN_TRUE;
+
+                if (index != last)
+                {
+                    BRAIN_COPY(stream->_inputs  + last * stream->_input_length,  slot_input,  BrainReal, stream->_input_length);
+                    BRAIN_COPY(stream->_outputs + last * stream->_output_length, slot_output, BrainReal, stream->_output_length);
+                }
+
+                --stream->_filled;
+            }
+
+            if (BRAIN_ALLOCATED(input))
+            {
+                *input = stream->_input;
+            }
+
+            if (BRAIN_ALLOCATED(output))
+            {
+                *output = stream->_output;
+            }
+
+            ret = BRAIN_TRUE;
+        }
+    }
+
+    return ret;
+}
+
+BrainUint
+get_data_stream_epoch(const BrainDataStream stream)
+{
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(stream))
+    {
+        ret = __atomic_load_n(&(stream->_epoch), __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+BrainUlong
+get_data_stream_number_of_rows(const BrainDataStream stream)
+{
+    BrainUlong ret = 0;
+
+    if (BRAIN_ALLOCATED(stream))
+    {
+        ret = stream->_number_of_rows;
+    }
+
+    return ret;
+}
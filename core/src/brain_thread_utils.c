@@ -0,0 +1,145 @@
+#include "brain_thread_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_timeline_utils.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define BRAIN_MAX_THREADS 64
+
+/**
+ * \struct ParallelChunk
+ * \brief  Arguments given to a worker thread
+ */
+typedef struct ParallelChunk
+{
+    ParallelCbk _cbk;       /*!< Loop body              */
+    void*       _data;      /*!< Loop body user data    */
+    BrainUint   _begin;     /*!< First item             */
+    BrainUint   _end;       /*!< Item after the last    */
+    BrainUint   _thread;    /*!< Thread index           */
+} ParallelChunk;
+
+static void*
+parallel_worker(void* parameter)
+{
+    ParallelChunk* chunk = (ParallelChunk*)parameter;
+    const BrainUlong span = brain_timeline_begin();
+
+    chunk->_cbk(chunk->_data, chunk->_begin, chunk->_end, chunk->_thread);
+
+    brain_timeline_end("task", "thread", span, (BrainInt)chunk->_thread);
+
+    return NULL;
+}
+
+static BrainUint
+get_maximum_number_of_threads()
+{
+    BrainUint ret = 1;
+    const char* value = getenv("BRAIN_NUM_THREADS");
+
+    if (BRAIN_ALLOCATED(value))
+    {
+        ret = (BrainUint)atoi(value);
+    }
+    else
+    {
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (0 < processors)
+        {
+            ret = (BrainUint)processors;
+        }
+    }
+
+    if (ret < 1)
+    {
+        ret = 1;
+    }
+
+    if (BRAIN_MAX_THREADS < ret)
+    {
+        ret = BRAIN_MAX_THREADS;
+    }
+
+    return ret;
+}
+
+BrainUint
+get_number_of_threads(const BrainUint number_of_items, const BrainUint grain)
+{
+    BrainUint ret = get_maximum_number_of_threads();
+
+    if (0 < grain)
+    {
+        const BrainUint needed = number_of_items / grain;
+
+        if (needed < ret)
+        {
+            ret = needed;
+        }
+    }
+
+    if (ret < 1)
+    {
+        ret = 1;
+    }
+
+    return ret;
+}
+
+void
+parallel_for(const BrainUint number_of_items,
+             const BrainUint number_of_threads,
+             ParallelCbk cbk,
+             void* data)
+{
+    if (BRAIN_ALLOCATED(cbk)
+    &&  (0 < number_of_items))
+    {
+        if (number_of_threads <= 1)
+        {
+            cbk(data, 0, number_of_items, 0);
+        }
+        else
+        {
+            ParallelChunk chunks[BRAIN_MAX_THREADS];
+            pthread_t     threads[BRAIN_MAX_THREADS];
+            BrainBool     started[BRAIN_MAX_THREADS];
+            const BrainUint n = (number_of_threads < BRAIN_MAX_THREADS) ? number_of_threads : BRAIN_MAX_THREADS;
+            BrainUint i = 0;
+
+            for (i = 0; i < n; ++i)
+            {
+                chunks[i]._cbk    = cbk;
+                chunks[i]._data   = data;
+                chunks[i]._begin  = (BrainUint)(((BrainUlong)i * number_of_items) / n);
+                chunks[i]._end    = (BrainUint)(((BrainUlong)(i + 1) * number_of_items) / n);
+                chunks[i]._thread = i;
+                started[i]        = BRAIN_FALSE;
+            }
+            /**************************************************************/
+            /**     The calling thread processes the first chunk, a      **/
+            /**     chunk whose thread can not start is run inline       **/
+            /**************************************************************/
+            for (i = 1; i < n; ++i)
+            {
+                started[i] = (pthread_create(&threads[i], NULL, parallel_worker, &chunks[i]) == 0);
+            }
+
+            parallel_worker(&chunks[0]);
+
+            for (i = 1; i < n; ++i)
+            {
+                if (started[i])
+                {
+                    pthread_join(threads[i], NULL);
+                }
+                else
+                {
+                    parallel_worker(&chunks[i]);
+                }
+            }
+        }
+    }
+}
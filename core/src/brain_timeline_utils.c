@@ -0,0 +1,401 @@
+#include "brain_timeline_utils.h"
+#include "brain_memory_utils.h"
+#include "brain_logging_utils.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+/**
+ * \def BRAIN_TIMELINE_BUFFER
+ * \brief size of the output file buffer
+ */
+#define BRAIN_TIMELINE_BUFFER (1 << 20)
+
+/**
+ * \struct TimelineSpan
+ * \brief  A closed span
+ */
+typedef struct TimelineSpan
+{
+    BrainString _name;     /*!< Span name                    */
+    BrainString _category; /*!< Span category                */
+    BrainUlong  _begin;    /*!< Monotonic begin time in ns   */
+    BrainUlong  _end;      /*!< Monotonic end time in ns     */
+    BrainInt    _index;    /*!< Argument, negative if none   */
+    BrainUint   _thread;   /*!< Timeline index of the thread */
+} TimelineSpan;
+
+/**
+ * \struct TimelineChunk
+ * \brief  Spans of a thread waiting to be written
+ */
+typedef struct TimelineChunk
+{
+    TimelineSpan          _spans[BRAIN_TIMELINE_CHUNK]; /*!< Spans            */
+    BrainUint             _count;                       /*!< Number of spans  */
+    struct TimelineChunk* _next;                        /*!< Next in a list   */
+} TimelineChunk;
+
+/**
+ * \struct TimelineThread
+ * \brief  Recording state of a thread
+ */
+typedef struct TimelineThread
+{
+    pthread_mutex_t        _mutex;  /*!< Taken by the thread and the stop   */
+    TimelineChunk*         _chunk;  /*!< Chunk being filled, may be NULL    */
+    BrainUint              _index;  /*!< Timeline index of the thread       */
+    BrainBool              _owned;  /*!< Used by a running thread           */
+    struct TimelineThread* _next;   /*!< Next state of the registry         */
+} TimelineThread;
+
+// lock order: registry, then a thread state, then the queue
+static pthread_mutex_t _registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t _queue_mutex    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  _queue_cond     = PTHREAD_COND_INITIALIZER;
+static pthread_once_t  _timeline_once  = PTHREAD_ONCE_INIT;
+static pthread_key_t   _timeline_key;
+
+static TimelineThread* _threads  = NULL;
+static BrainUint       _number_of_threads = 0;
+static TimelineChunk*  _queue    = NULL;
+static TimelineChunk*  _free     = NULL;
+static BrainBool       _stopping = BRAIN_FALSE;
+static BrainBool       _enabled  = BRAIN_FALSE;
+static BrainUlong      _origin   = 0;
+static FILE*           _file     = NULL;
+static pthread_t       _writer;
+
+static __thread TimelineThread* _thread_state = NULL;
+
+static BrainUlong
+get_timeline_time()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (BrainUlong)now.tv_sec * 1000000000ULL + (BrainUlong)now.tv_nsec;
+}
+
+static BrainBool
+is_timeline_enabled()
+{
+    return __atomic_load_n(&_enabled, __ATOMIC_ACQUIRE);
+}
+
+static void
+hand_off_chunk(TimelineThread* state)
+{
+    if (BRAIN_ALLOCATED(state->_chunk))
+    {
+        pthread_mutex_lock(&_queue_mutex);
+        state->_chunk->_next = _queue;
+        _queue = state->_chunk;
+        pthread_cond_signal(&_queue_cond);
+        pthread_mutex_unlock(&_queue_mutex);
+
+        state->_chunk = NULL;
+    }
+}
+
+static TimelineChunk*
+acquire_chunk()
+{
+    TimelineChunk* chunk = NULL;
+
+    pthread_mutex_lock(&_queue_mutex);
+    chunk = _free;
+    if (BRAIN_ALLOCATED(chunk))
+    {
+        _free = chunk->_next;
+    }
+    pthread_mutex_unlock(&_queue_mutex);
+
+    if (!BRAIN_ALLOCATED(chunk))
+    {
+        BRAIN_NEW(chunk, TimelineChunk, 1);
+    }
+
+    chunk->_count = 0;
+    chunk->_next  = NULL;
+
+    return chunk;
+}
+
+static void
+release_thread_state(void* parameter)
+{
+    TimelineThread* state = (TimelineThread*)parameter;
+
+    pthread_mutex_lock(&_registry_mutex);
+    pthread_mutex_lock(&state->_mutex);
+    hand_off_chunk(state);
+    state->_owned = BRAIN_FALSE;
+    pthread_mutex_unlock(&state->_mutex);
+    pthread_mutex_unlock(&_registry_mutex);
+}
+
+static void
+create_timeline_key()
+{
+    pthread_key_create(&_timeline_key, release_thread_state);
+}
+
+static TimelineThread*
+acquire_thread_state()
+{
+    TimelineThread* state = NULL;
+
+    pthread_once(&_timeline_once, create_timeline_key);
+    pthread_mutex_lock(&_registry_mutex);
+
+    for (state = _threads; BRAIN_ALLOCATED(state); state = state->_next)
+    {
+        if (!state->_owned)
+        {
+            break;
+        }
+    }
+
+    if (!BRAIN_ALLOCATED(state))
+    {
+        BRAIN_NEW(state, TimelineThread, 1);
+        pthread_mutex_init(&state->_mutex, NULL);
+        state->_index = _number_of_threads++;
+        state->_next  = _threads;
+        _threads      = state;
+    }
+
+    state->_owned = BRAIN_TRUE;
+
+    pthread_mutex_unlock(&_registry_mutex);
+    pthread_setspecific(_timeline_key, state);
+
+    return state;
+}
+
+static void
+write_span(const TimelineSpan* span, const pid_t pid, BrainBool* first)
+{
+    fprintf(_file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+            *first ? "" : ",\n",
+            span->_name,
+            span->_category,
+            (BrainInt)pid,
+            span->_thread,
+            (BrainDouble)(span->_begin - _origin) * 1e-3,
+            (BrainDouble)(span->_end - span->_begin) * 1e-3);
+
+    if (0 <= span->_index)
+    {
+        fprintf(_file, ",\"args\":{\"index\":%d}", span->_index);
+    }
+
+    fputc('}', _file);
+
+    *first = BRAIN_FALSE;
+}
+
+static void*
+timeline_writer(void* parameter)
+{
+    const pid_t pid   = getpid();
+    BrainBool   first = BRAIN_TRUE;
+    BrainBool   running = BRAIN_TRUE;
+
+    while (running)
+    {
+        TimelineChunk* chunks = NULL;
+        TimelineChunk* chunk  = NULL;
+        /**************************************************************/
+        /**                 WAIT FOR SOME FULL CHUNKS                **/
+        /**************************************************************/
+        pthread_mutex_lock(&_queue_mutex);
+        while (!BRAIN_ALLOCATED(_queue)
+        &&     !_stopping)
+        {
+            pthread_cond_wait(&_queue_cond, &_queue_mutex);
+        }
+        chunks  = _queue;
+        _queue  = NULL;
+        running = !_stopping || BRAIN_ALLOCATED(chunks);
+        pthread_mutex_unlock(&_queue_mutex);
+
+        /**************************************************************/
+        /**               FORMAT THEM OUTSIDE OF THE LOCK            **/
+        /**************************************************************/
+        for (chunk = chunks; BRAIN_ALLOCATED(chunk); chunk = chunk->_next)
+        {
+            BrainUint i = 0;
+
+            for (i = 0; i < chunk->_count; ++i)
+            {
+                write_span(&(chunk->_spans[i]), pid, &first);
+            }
+        }
+
+        while (BRAIN_ALLOCATED(chunks))
+        {
+            chunk  = chunks;
+            chunks = chunks->_next;
+
+            pthread_mutex_lock(&_queue_mutex);
+            chunk->_next = _free;
+            _free = chunk;
+            pthread_mutex_unlock(&_queue_mutex);
+        }
+    }
+
+    return NULL;
+}
+
+BrainBool
+brain_timeline_start(BrainString path)
+{
+    BrainBool ret = BRAIN_FALSE;
+
+    if (BRAIN_ALLOCATED(path))
+    {
+        pthread_mutex_lock(&_registry_mutex);
+
+        if (!BRAIN_ALLOCATED(_file))
+        {
+            _file = fopen(path, "w");
+
+            if (BRAIN_ALLOCATED(_file))
+            {
+                setvbuf(_file, NULL, _IOFBF, BRAIN_TIMELINE_BUFFER);
+                fputs("{\"traceEvents\":[\n", _file);
+
+                _stopping = BRAIN_FALSE;
+                _origin   = get_timeline_time();
+
+                if (pthread_create(&_writer, NULL, timeline_writer, NULL) == 0)
+                {
+                    __atomic_store_n(&_enabled, BRAIN_TRUE, __ATOMIC_RELEASE);
+                    ret = BRAIN_TRUE;
+                }
+                else
+                {
+                    fclose(_file);
+                    _file = NULL;
+                }
+            }
+            else
+            {
+                BRAIN_WARNING("Unable to open the timeline %s", path);
+            }
+        }
+
+        pthread_mutex_unlock(&_registry_mutex);
+    }
+
+    return ret;
+}
+
+void
+brain_timeline_stop()
+{
+    pthread_mutex_lock(&_registry_mutex);
+
+    if (is_timeline_enabled())
+    {
+        TimelineThread* state = NULL;
+
+        __atomic_store_n(&_enabled, BRAIN_FALSE, __ATOMIC_RELEASE);
+        /**************************************************************/
+        /**      A thread recording a span holds its own lock, so    **/
+        /**      no span is added once its chunk has been taken      **/
+        /**************************************************************/
+        for (state = _threads; BRAIN_ALLOCATED(state); state = state->_next)
+        {
+            pthread_mutex_lock(&state->_mutex);
+            hand_off_chunk(state);
+            pthread_mutex_unlock(&state->_mutex);
+        }
+
+        pthread_mutex_lock(&_queue_mutex);
+        _stopping = BRAIN_TRUE;
+        pthread_cond_signal(&_queue_cond);
+        pthread_mutex_unlock(&_queue_mutex);
+
+        pthread_join(_writer, NULL);
+
+        fputs("\n],\"displayTimeUnit\":\"ms\"}\n", _file);
+        fclose(_file);
+        _file = NULL;
+
+        while (BRAIN_ALLOCATED(_free))
+        {
+            TimelineChunk* chunk = _free;
+
+            _free = chunk->_next;
+            BRAIN_DELETE(chunk);
+        }
+    }
+
+    pthread_mutex_unlock(&_registry_mutex);
+}
+
+BrainUlong
+brain_timeline_begin()
+{
+    BrainUlong ret = 0;
+
+    if (is_timeline_enabled())
+    {
+        ret = get_timeline_time();
+    }
+
+    return ret;
+}
+
+void
+brain_timeline_end(BrainString name,
+                   BrainString category,
+                   const BrainUlong begin,
+                   const BrainInt index)
+{
+    if ((0 < begin)
+    &&  is_timeline_enabled())
+    {
+        const BrainUlong end   = get_timeline_time();
+        TimelineThread*  state = _thread_state;
+
+        if (!BRAIN_ALLOCATED(state))
+        {
+            state         = acquire_thread_state();
+            _thread_state = state;
+        }
+
+        pthread_mutex_lock(&state->_mutex);
+
+        // the recorder may have been stopped or restarted meanwhile
+        if (is_timeline_enabled()
+        &&  (_origin <= begin))
+        {
+            TimelineSpan* span = NULL;
+
+            if (!BRAIN_ALLOCATED(state->_chunk))
+            {
+                state->_chunk = acquire_chunk();
+            }
+
+            span            = &(state->_chunk->_spans[state->_chunk->_count++]);
+            span->_name     = name;
+            span->_category = category;
+            span->_begin    = begin;
+            span->_end      = end;
+            span->_index    = index;
+            span->_thread   = state->_index;
+
+            if (state->_chunk->_count == BRAIN_TIMELINE_CHUNK)
+            {
+                hand_off_chunk(state);
+            }
+        }
+
+        pthread_mutex_unlock(&state->_mutex);
+    }
+}
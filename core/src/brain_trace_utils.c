@@ -0,0 +1,156 @@
+#include "brain_trace_utils.h"
+#include "brain_memory_utils.h"
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * \struct TraceRecord
+ * \brief  A single trace event
+ */
+typedef struct TraceRecord
+{
+    BrainUlong  _time;   /*!< Monotonic time in nanoseconds */
+    BrainString _name;   /*!< Traced function               */
+    BrainUint   _thread; /*!< Recording thread              */
+    BrainUint   _event;  /*!< A BrainTraceEvent             */
+} TraceRecord;
+
+/**
+ * \struct TraceBuffer
+ * \brief  Ring buffer of a thread
+ */
+typedef struct TraceBuffer
+{
+    TraceRecord*        _records; /*!< BRAIN_TRACE_CAPACITY records      */
+    BrainUlong          _count;   /*!< Number of recorded events         */
+    BrainBool           _owned;   /*!< Used by a running thread          */
+    struct TraceBuffer* _next;    /*!< Next buffer of the registry       */
+} TraceBuffer;
+
+static pthread_mutex_t _trace_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  _trace_once    = PTHREAD_ONCE_INIT;
+static pthread_key_t   _trace_key;
+static TraceBuffer*    _trace_buffers = NULL;
+static BrainUint       _trace_threads = 0;
+
+static __thread TraceBuffer* _thread_buffer = NULL;
+static __thread BrainUint    _thread_index  = 0;
+
+static void
+release_trace_buffer(void* parameter)
+{
+    TraceBuffer* buffer = (TraceBuffer*)parameter;
+
+    // records are kept until the next dump, the buffer is reused
+    pthread_mutex_lock(&_trace_mutex);
+    buffer->_owned = BRAIN_FALSE;
+    pthread_mutex_unlock(&_trace_mutex);
+}
+
+static void
+create_trace_key()
+{
+    pthread_key_create(&_trace_key, release_trace_buffer);
+}
+
+static TraceBuffer*
+acquire_trace_buffer()
+{
+    TraceBuffer* buffer = NULL;
+
+    pthread_once(&_trace_once, create_trace_key);
+    pthread_mutex_lock(&_trace_mutex);
+
+    for (buffer = _trace_buffers; BRAIN_ALLOCATED(buffer); buffer = buffer->_next)
+    {
+        if (!buffer->_owned)
+        {
+            break;
+        }
+    }
+
+    if (!BRAIN_ALLOCATED(buffer))
+    {
+        BRAIN_NEW(buffer, TraceBuffer, 1);
+        BRAIN_NEW(buffer->_records, TraceRecord, BRAIN_TRACE_CAPACITY);
+        buffer->_next  = _trace_buffers;
+        _trace_buffers = buffer;
+    }
+
+    buffer->_owned = BRAIN_TRUE;
+    _thread_index  = _trace_threads++;
+
+    pthread_mutex_unlock(&_trace_mutex);
+    pthread_setspecific(_trace_key, buffer);
+
+    return buffer;
+}
+
+void
+brain_trace_record(BrainString name, const BrainTraceEvent event)
+{
+    TraceBuffer* buffer = _thread_buffer;
+    TraceRecord* record = NULL;
+    struct timespec now;
+
+    if (!BRAIN_ALLOCATED(buffer))
+    {
+        buffer         = acquire_trace_buffer();
+        _thread_buffer = buffer;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    record          = &(buffer->_records[buffer->_count & (BRAIN_TRACE_CAPACITY - 1)]);
+    record->_time   = (BrainUlong)now.tv_sec * 1000000000ULL + (BrainUlong)now.tv_nsec;
+    record->_name   = name;
+    record->_thread = _thread_index;
+    record->_event  = event;
+
+    ++buffer->_count;
+}
+
+void
+brain_trace_dump(FILE* file)
+{
+    if (BRAIN_ALLOCATED(file))
+    {
+        TraceBuffer* buffer = NULL;
+
+        pthread_mutex_lock(&_trace_mutex);
+
+        for (buffer = _trace_buffers; BRAIN_ALLOCATED(buffer); buffer = buffer->_next)
+        {
+            const BrainUlong first = (BRAIN_TRACE_CAPACITY < buffer->_count) ? buffer->_count - BRAIN_TRACE_CAPACITY : 0;
+            BrainUlong i = 0;
+
+            for (i = first; i < buffer->_count; ++i)
+            {
+                const TraceRecord* record = &(buffer->_records[i & (BRAIN_TRACE_CAPACITY - 1)]);
+
+                fprintf(file, "%u %llu %c %s\n",
+                        record->_thread,
+                        (unsigned long long)record->_time,
+                        (record->_event == Trace_Begin) ? 'B' : 'E',
+                        record->_name);
+            }
+        }
+
+        pthread_mutex_unlock(&_trace_mutex);
+    }
+}
+
+void
+brain_trace_clear()
+{
+    TraceBuffer* buffer = NULL;
+
+    pthread_mutex_lock(&_trace_mutex);
+
+    for (buffer = _trace_buffers; BRAIN_ALLOCATED(buffer); buffer = buffer->_next)
+    {
+        buffer->_count = 0;
+    }
+
+    pthread_mutex_unlock(&_trace_mutex);
+}
@@ -1,70 +1,294 @@
 #include "brain_weight_utils.h"
-#include "brain_random_utils.h"
+#include "brain_enum_utils.h"
+#include "brain_logging_utils.h"
 #include "brain_memory_utils.h"
+#include <math.h>
 
-typedef struct Weight
+#if defined(BRAIN_ENABLE_DOUBLE_PRECISION)
+#define BRAIN_SQRT(x) sqrt(x)
+#else
+#define BRAIN_SQRT(x) sqrtf(x)
+#endif
+
+static BrainString _optimizers[] = {
+    "SGD",
+    "Momentum",
+    "Nesterov",
+    "AdaGrad",
+    "RMSProp",
+    "Adam"
+};
+
+/**
+ * \struct Optimizer
+ * \brief  Internal model for a BrainOptimizer
+ */
+typedef struct Optimizer
+{
+    OptimizerType _type;          /*!< Update rule                       */
+    BrainReal     _learning_rate; /*!< Learning rate                     */
+    BrainReal     _momentum;      /*!< Velocity decay                    */
+    BrainReal     _beta1;         /*!< First moment decay                */
+    BrainReal     _beta2;         /*!< Second moment decay               */
+    BrainReal     _epsilon;       /*!< Added to the second moment root   */
+    BrainReal     _weight_decay;  /*!< Decoupled weight decay            */
+    BrainReal     _clipping;      /*!< Largest absolute gradient         */
+    BrainReal     _scale;         /*!< One over the minibatch size       */
+    BrainUint     _step;          /*!< Number of updates                 */
+    BrainReal     _step_rate;     /*!< Bias corrected Adam learning rate */
+    BrainReal     _step_epsilon;  /*!< Bias corrected Adam epsilon       */
+} Optimizer;
+
+static BrainReal
+clip_gradient(const BrainReal gradient, const BrainReal clip)
 {
-    BrainReal _w;         /*!< An array of weight                   */
-    BrainReal _gradient;  /*!< weights gradient value               */
-    BrainReal _delta;     /*!< weights delta value                  */
-} Weight;
+    const BrainReal low = (gradient < -clip) ? -clip : gradient;
 
-BrainWeight
-new_weight(BrainReal random_value_limit)
+    return (clip < low) ? clip : low;
+}
+
+BrainOptimizer
+new_optimizer(BrainString name)
 {
-    BrainWeight _weight = NULL;
+    BrainOptimizer optimizer = NULL;
+    const OptimizerType type = get_enum_values(_optimizers, Optimizer_First, Optimizer_Last, name);
+
+    if (type != Optimizer_Invalide)
+    {
+        BRAIN_NEW(optimizer, Optimizer, 1);
 
-    BRAIN_NEW(_weight, Weight, 1);
+        optimizer->_type = type;
 
-    _weight->_w = (BrainReal)BRAIN_RAND_RANGE(-random_value_limit, random_value_limit);
-    _weight->_delta = 0.;
-    _weight->_gradient = 0.;
+        configure_optimizer(optimizer, 0.005, 0.9, 0.9, 0.999, 1e-8);
+        regularize_optimizer(optimizer, 0., 0.);
 
-    return _weight;
+        optimizer->_scale        = 1.;
+        optimizer->_step         = 0;
+        optimizer->_step_rate    = optimizer->_learning_rate;
+        optimizer->_step_epsilon = optimizer->_epsilon;
+    }
+    else
+    {
+        BRAIN_WARNING("Unknown optimizer %s\n", BRAIN_ALLOCATED(name) ? name : "");
+    }
+
+    return optimizer;
+}
+
+void
+delete_optimizer(BrainOptimizer optimizer)
+{
+    BRAIN_DELETE(optimizer);
 }
 
 void
-update_weight(BrainWeight weight,
-              BrainReal learning_rate,
-              BrainReal momentum)
+configure_optimizer(BrainOptimizer optimizer,
+                    const BrainReal learning_rate,
+                    const BrainReal momentum,
+                    const BrainReal beta1,
+                    const BrainReal beta2,
+                    const BrainReal epsilon)
 {
-    if (BRAIN_ALLOCATED(weight))
+    if (BRAIN_ALLOCATED(optimizer))
     {
-        BrainReal delta = learning_rate * weight->_gradient - momentum * weight->_delta;
+        optimizer->_learning_rate = learning_rate;
+        optimizer->_momentum      = momentum;
+        optimizer->_beta1         = beta1;
+        optimizer->_beta2         = beta2;
+        optimizer->_epsilon       = epsilon;
+    }
+}
 
-        weight->_w -= delta;
-        weight->_gradient = 0.;
-        weight->_delta = delta;
+void
+regularize_optimizer(BrainOptimizer optimizer,
+                     const BrainReal weight_decay,
+                     const BrainReal clipping)
+{
+    if (BRAIN_ALLOCATED(optimizer))
+    {
+        optimizer->_weight_decay = weight_decay;
+        // an infinite bound never clips
+        optimizer->_clipping     = (0. < clipping) ? clipping : (BrainReal)HUGE_VAL;
     }
 }
 
-BrainReal
-get_weight(BrainWeight weight)
+BrainUint
+get_optimizer_number_of_states(const BrainOptimizer optimizer)
 {
-    BrainReal value = 0.;
-    if (BRAIN_ALLOCATED(weight))
+    BrainUint ret = 0;
+
+    if (BRAIN_ALLOCATED(optimizer))
     {
-        value = weight->_w;
+        switch (optimizer->_type)
+        {
+            case Optimizer_Momentum:
+            case Optimizer_Nesterov:
+            case Optimizer_AdaGrad:
+            case Optimizer_RMSProp:
+                ret = 1;
+                break;
+            case Optimizer_Adam:
+                ret = 2;
+                break;
+            default:
+                break;
+        }
     }
-    return value;
+
+    return ret;
 }
 
 void
-set_weight(BrainWeight weight, BrainReal value)
+step_optimizer(BrainOptimizer optimizer, const BrainUint number_of_samples)
 {
-    if (BRAIN_ALLOCATED(weight))
+    if (BRAIN_ALLOCATED(optimizer)
+    &&  (0 < number_of_samples))
     {
-        weight->_w = value;
-        weight->_delta = 0.;
-        weight->_gradient = 0.;
+        /**************************************************************/
+        /**   Adam moments start at 0, so they are divided by        **/
+        /**   1 - beta^t. Both corrections are folded in the         **/
+        /**   learning rate and epsilon once per update:             **/
+        /**                                                          **/
+        /**   lr_t  = lr * sqrt(1 - beta2^t) / (1 - beta1^t)         **/
+        /**   eps_t = eps * sqrt(1 - beta2^t)                        **/
+        /**************************************************************/
+        const BrainDouble first  = 1. - pow((BrainDouble)optimizer->_beta1, (BrainDouble)(optimizer->_step + 1));
+        const BrainDouble second = sqrt(1. - pow((BrainDouble)optimizer->_beta2, (BrainDouble)(optimizer->_step + 1)));
+
+        ++optimizer->_step;
+
+        optimizer->_scale        = (BrainReal)(1. / (BrainDouble)number_of_samples);
+        optimizer->_step_rate    = (BrainReal)((BrainDouble)optimizer->_learning_rate * second / first);
+        optimizer->_step_epsilon = (BrainReal)((BrainDouble)optimizer->_epsilon * second);
     }
 }
 
 void
-accumulate_gradient(BrainWeight weight, BrainReal gradient, BrainReal in)
+update_weights(const BrainOptimizer optimizer,
+               BrainReal* weights,
+               BrainReal* gradients,
+               BrainReal* first,
+               BrainReal* second,
+               const BrainUint number_of_weights)
 {
-    if (BRAIN_ALLOCATED(weight))
+    if (BRAIN_ALLOCATED(optimizer)
+    &&  BRAIN_ALLOCATED(weights)
+    &&  BRAIN_ALLOCATED(gradients)
+    &&  ((get_optimizer_number_of_states(optimizer) < 1) || BRAIN_ALLOCATED(first))
+    &&  ((get_optimizer_number_of_states(optimizer) < 2) || BRAIN_ALLOCATED(second)))
     {
-        weight->_gradient += gradient * in;
+        const BrainReal scale = optimizer->_scale;
+        const BrainReal clip  = optimizer->_clipping;
+        const BrainReal rate  = optimizer->_learning_rate;
+        const BrainReal decay = 1. - optimizer->_learning_rate * optimizer->_weight_decay;
+        const BrainReal mu    = optimizer->_momentum;
+        const BrainReal beta1 = optimizer->_beta1;
+        const BrainReal beta2 = optimizer->_beta2;
+        const BrainReal eps   = optimizer->_epsilon;
+        BrainUint i = 0;
+        /**************************************************************/
+        /**  One loop per rule, so that each one is a straight line  **/
+        /**  of code the compiler can vectorize. The gradient of a   **/
+        /**  weight is first averaged and clipped:                   **/
+        /**                                                          **/
+        /**             g = clip(gradient / minibatch)               **/
+        /**************************************************************/
+        switch (optimizer->_type)
+        {
+            case Optimizer_SGD:
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    weights[i]   = decay * weights[i] - rate * g;
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            case Optimizer_Momentum:
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    first[i]     = mu * first[i] + g;
+                    weights[i]   = decay * weights[i] - rate * first[i];
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            case Optimizer_Nesterov:
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    first[i]     = mu * first[i] + g;
+                    weights[i]   = decay * weights[i] - rate * (g + mu * first[i]);
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            case Optimizer_AdaGrad:
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    first[i]     = first[i] + g * g;
+                    weights[i]   = decay * weights[i] - rate * g / (BRAIN_SQRT(first[i]) + eps);
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            case Optimizer_RMSProp:
+            {
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    first[i]     = beta2 * first[i] + (1. - beta2) * g * g;
+                    weights[i]   = decay * weights[i] - rate * g / (BRAIN_SQRT(first[i]) + eps);
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            case Optimizer_Adam:
+            {
+                const BrainReal step_rate    = optimizer->_step_rate;
+                const BrainReal step_epsilon = optimizer->_step_epsilon;
+#if defined(__GNUC__)
+                #pragma GCC ivdep
+#endif
+                for (i = 0; i < number_of_weights; ++i)
+                {
+                    const BrainReal g = clip_gradient(gradients[i] * scale, clip);
+
+                    first[i]     = beta1 * first[i]  + (1. - beta1) * g;
+                    second[i]    = beta2 * second[i] + (1. - beta2) * g * g;
+                    weights[i]   = decay * weights[i] - step_rate * first[i] / (BRAIN_SQRT(second[i]) + step_epsilon);
+                    gradients[i] = 0.;
+                }
+            }
+                break;
+            default:
+                break;
+        }
     }
 }
@@ -0,0 +1,291 @@
+#include "brain_kmeans_utils.h"
+#include "brain_random_utils.h"
+#include "brain_memory_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define KMEANS_TEST_SIZE      5
+#define KMEANS_TEST_CLUSTERS  4
+#define KMEANS_TEST_SIGNALS   400
+#define KMEANS_TEST_TOLERANCE 1e-3
+#define KMEANS_TEST_BATCH     40
+#define KMEANS_TEST_PASSES    20
+
+/**
+ * \struct Blobs
+ * \brief  Signals drawn around well separated centers
+ */
+typedef struct Blobs
+{
+    BrainReal** _signals;           /*!< Signals                        */
+    BrainUint   _number_of_signals; /*!< Number of signals              */
+} Blobs;
+
+static BrainBool
+check(const BrainBool condition, BrainString message)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", message);
+    }
+
+    return condition;
+}
+
+static BrainDouble
+get_distance(const BrainReal* a, const BrainReal* b)
+{
+    BrainDouble ret = 0.;
+    BrainUint   j   = 0;
+
+    for (j = 0; j < KMEANS_TEST_SIZE; ++j)
+    {
+        const BrainDouble d = (BrainDouble)a[j] - (BrainDouble)b[j];
+
+        ret += d * d;
+    }
+
+    return ret;
+}
+
+static void
+new_blobs(Blobs* blobs, BrainRandom random, const BrainUint number_of_signals, const BrainReal spread)
+{
+    BrainUint i = 0;
+
+    blobs->_number_of_signals = number_of_signals;
+    BRAIN_NEW(blobs->_signals, BrainReal*, number_of_signals);
+
+    /******************************************************************/
+    /**  Signal i belongs to the blob i % KMEANS_TEST_CLUSTERS, the  **/
+    /**  blobs are 10 apart on a different component each            **/
+    /******************************************************************/
+    for (i = 0; i < number_of_signals; ++i)
+    {
+        const BrainUint blob = i % KMEANS_TEST_CLUSTERS;
+        BrainUint j = 0;
+
+        BRAIN_NEW(blobs->_signals[i], BrainReal, KMEANS_TEST_SIZE);
+
+        for (j = 0; j < KMEANS_TEST_SIZE; ++j)
+        {
+            blobs->_signals[i][j] = spread * (BrainReal)random_range(random, -1., 1.);
+        }
+
+        blobs->_signals[i][blob] += 10.;
+    }
+}
+
+static void
+delete_blobs(Blobs* blobs)
+{
+    BrainUint i = 0;
+
+    for (i = 0; i < blobs->_number_of_signals; ++i)
+    {
+        BRAIN_DELETE(blobs->_signals[i]);
+    }
+
+    BRAIN_DELETE(blobs->_signals);
+}
+
+static BrainBool
+check_fit(BrainKMeans kmeans, const Blobs* blobs)
+{
+    const BrainUint number_of_signals = blobs->_number_of_signals;
+    BrainUint*  labels    = NULL;
+    BrainUint*  predicted = NULL;
+    BrainUint*  counts    = NULL;
+    BrainReal** signals   = blobs->_signals;
+    BrainBool   nearest   = BRAIN_TRUE;
+    BrainBool   means     = BRAIN_TRUE;
+    BrainBool   predict   = BRAIN_TRUE;
+    BrainBool   ret       = BRAIN_TRUE;
+    BrainUint   i         = 0;
+    BrainUint   k         = 0;
+
+    BRAIN_NEW(labels,    BrainUint, number_of_signals);
+    BRAIN_NEW(predicted, BrainUint, number_of_signals);
+    BRAIN_NEW(counts,    BrainUint, KMEANS_TEST_CLUSTERS);
+
+    // a null tolerance only stops once no signal changes of cluster
+    configure_kmeans(kmeans, 100, 0.);
+    ret = check(0 < fit_kmeans(kmeans, signals, number_of_signals, labels), "fit iterates") && ret;
+    predict_kmeans(kmeans, signals, number_of_signals, predicted);
+
+    /******************************************************************/
+    /**  Every label is the brute force nearest center, and matches  **/
+    /**  the prediction                                              **/
+    /******************************************************************/
+    for (i = 0; i < number_of_signals; ++i)
+    {
+        const BrainDouble distance = get_distance(signals[i], get_kmeans_center(kmeans, labels[i]));
+
+        for (k = 0; k < KMEANS_TEST_CLUSTERS; ++k)
+        {
+            nearest = nearest
+            &&        (distance <= get_distance(signals[i], get_kmeans_center(kmeans, k)) + KMEANS_TEST_TOLERANCE);
+        }
+
+        predict = predict && (labels[i] == predicted[i]);
+        ++counts[labels[i]];
+    }
+
+    /******************************************************************/
+    /**  Every center is the mean of its members                     **/
+    /******************************************************************/
+    for (k = 0; k < KMEANS_TEST_CLUSTERS; ++k)
+    {
+        BrainDouble mean[KMEANS_TEST_SIZE] = {0.};
+        BrainUint   j = 0;
+
+        for (i = 0; i < number_of_signals; ++i)
+        {
+            for (j = 0; (labels[i] == k) && (j < KMEANS_TEST_SIZE); ++j)
+            {
+                mean[j] += signals[i][j];
+            }
+        }
+
+        for (j = 0; j < KMEANS_TEST_SIZE; ++j)
+        {
+            means = means
+            &&      (0 < counts[k])
+            &&      (fabs(mean[j] / counts[k] - get_kmeans_center(kmeans, k)[j]) < KMEANS_TEST_TOLERANCE);
+        }
+    }
+
+    ret = check(nearest, "labels are the nearest centers") && ret;
+    ret = check(means,   "centers are the means of their members") && ret;
+    ret = check(predict, "predictions match the fitted labels") && ret;
+
+    BRAIN_DELETE(labels);
+    BRAIN_DELETE(predicted);
+    BRAIN_DELETE(counts);
+
+    return ret;
+}
+
+static BrainBool
+check_degenerate(const Blobs* blobs)
+{
+    BrainKMeans kmeans = new_kmeans(KMEANS_TEST_CLUSTERS, KMEANS_TEST_SIZE);
+    BrainReal** copies = NULL;
+    BrainUint*  labels = NULL;
+    BrainBool   ret    = BRAIN_TRUE;
+    BrainBool   valid  = BRAIN_TRUE;
+    BrainUint   i      = 0;
+
+    BRAIN_NEW(copies, BrainReal*, KMEANS_TEST_SIGNALS);
+    BRAIN_NEW(labels, BrainUint, KMEANS_TEST_SIGNALS);
+
+    for (i = 0; i < KMEANS_TEST_SIGNALS; ++i)
+    {
+        copies[i] = blobs->_signals[0];
+        labels[i] = KMEANS_TEST_CLUSTERS;
+    }
+
+    // fewer signals than clusters are refused
+    ret = check(fit_kmeans(kmeans, copies, KMEANS_TEST_CLUSTERS - 1, labels) == 0, "fewer signals than clusters are refused") && ret;
+    ret = check(labels[0] == KMEANS_TEST_CLUSTERS, "refused signals are not labelled") && ret;
+
+    fit_kmeans(kmeans, copies, KMEANS_TEST_SIGNALS, labels);
+
+    for (i = 0; i < KMEANS_TEST_SIGNALS; ++i)
+    {
+        valid = valid
+        &&      (labels[i] < KMEANS_TEST_CLUSTERS)
+        &&      (get_distance(copies[i], get_kmeans_center(kmeans, labels[i])) < KMEANS_TEST_TOLERANCE);
+    }
+
+    ret = check(valid, "duplicated signals are labelled with their center") && ret;
+    ret = check(get_kmeans_inertia(kmeans) < KMEANS_TEST_TOLERANCE, "duplicated signals have no inertia") && ret;
+
+    BRAIN_DELETE(copies);
+    BRAIN_DELETE(labels);
+    delete_kmeans(kmeans);
+
+    return ret;
+}
+
+static BrainBool
+check_partial_fit(BrainRandom random)
+{
+    BrainKMeans full    = new_kmeans(KMEANS_TEST_CLUSTERS, KMEANS_TEST_SIZE);
+    BrainKMeans partial = new_kmeans(KMEANS_TEST_CLUSTERS, KMEANS_TEST_SIZE);
+    BrainDouble worst   = 0.;
+    BrainBool   used[KMEANS_TEST_CLUSTERS] = {BRAIN_FALSE};
+    BrainBool   ret     = BRAIN_TRUE;
+    BrainUint   i       = 0;
+    BrainUint   k       = 0;
+    Blobs       blobs;
+
+    new_blobs(&blobs, random, KMEANS_TEST_SIGNALS, 1.);
+    fit_kmeans(full, blobs._signals, blobs._number_of_signals, NULL);
+
+    /******************************************************************/
+    /**  Every minibatch holds all the blobs, the first one seeds    **/
+    /**  the centers                                                 **/
+    /******************************************************************/
+    for (i = 0; i < KMEANS_TEST_PASSES * KMEANS_TEST_SIGNALS; i += KMEANS_TEST_BATCH)
+    {
+        partial_fit_kmeans(partial, blobs._signals + (i % KMEANS_TEST_SIGNALS), KMEANS_TEST_BATCH);
+    }
+
+    // each minibatch center converges close to its own full fit center
+    for (k = 0; k < KMEANS_TEST_CLUSTERS; ++k)
+    {
+        BrainDouble closest = get_distance(get_kmeans_center(partial, k), get_kmeans_center(full, 0));
+        BrainUint   nearest = 0;
+        BrainUint   c       = 0;
+
+        for (c = 1; c < KMEANS_TEST_CLUSTERS; ++c)
+        {
+            const BrainDouble distance = get_distance(get_kmeans_center(partial, k), get_kmeans_center(full, c));
+
+            if (distance < closest)
+            {
+                closest = distance;
+                nearest = c;
+            }
+        }
+
+        ret = check(!used[nearest], "minibatch centers are distinct") && ret;
+        used[nearest] = BRAIN_TRUE;
+        worst = (worst < closest) ? closest : worst;
+    }
+
+    printf("minibatch centers within %.3e of the full fit\n", sqrt(worst));
+    ret = check(sqrt(worst) < 0.1, "minibatch centers converge to the full fit centers") && ret;
+
+    delete_kmeans(full);
+    delete_kmeans(partial);
+    delete_blobs(&blobs);
+
+    return ret;
+}
+
+int
+main()
+{
+    BrainKMeans kmeans = new_kmeans(KMEANS_TEST_CLUSTERS, KMEANS_TEST_SIZE);
+    BrainRandom random = new_random(7);
+    BrainBool   ret    = BRAIN_TRUE;
+    Blobs       blobs;
+
+    // the k-means++ seeding draws from the thread generators
+    set_random_seed(42);
+    // overlapping blobs, so that signals change of cluster
+    new_blobs(&blobs, random, KMEANS_TEST_SIGNALS, 4.);
+
+    ret = check_fit(kmeans, &blobs) && ret;
+    ret = check_degenerate(&blobs) && ret;
+    ret = check_partial_fit(random) && ret;
+
+    delete_kmeans(kmeans);
+    delete_blobs(&blobs);
+    delete_random(random);
+
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}
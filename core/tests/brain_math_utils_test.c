@@ -0,0 +1,64 @@
+#include "brain_math_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BRAIN_FAST_TOLERANCE 1e-4
+
+typedef struct FastCase
+{
+    BrainString             _name;  /*!< Activation name          */
+    BrainActivationFunction _exact; /*!< libm based activation    */
+    BrainActivationFunction _fast;  /*!< Interpolated activation  */
+} FastCase;
+
+static BrainBool
+check_fast_activation(const FastCase* test)
+{
+    BrainDouble worst_error = 0.;
+    BrainDouble worst_value = 0.;
+    BrainInt i = 0;
+
+    /******************************************************************/
+    /**  Sweep [-40, 40] on a step which is not a multiple of the    **/
+    /**  table step, so that values between the samples are checked  **/
+    /******************************************************************/
+    for (i = -400000; i <= 400000; ++i)
+    {
+        const BrainReal   x     = (BrainReal)(i * 1e-4 + 1e-7);
+        const BrainDouble error = fabs((BrainDouble)test->_fast(x) - (BrainDouble)test->_exact(x));
+
+        if (worst_error < error)
+        {
+            worst_error = error;
+            worst_value = x;
+        }
+    }
+
+    printf("%-8s max error %.3e at %+.4f\n", test->_name, worst_error, worst_value);
+
+    return (worst_error < BRAIN_FAST_TOLERANCE);
+}
+
+int
+main()
+{
+    const FastCase tests[] = {{"Sigmoid",  sigmoid,             fast_sigmoid},
+                              {"TanH",     tangeant_hyperbolic, fast_tangeant_hyperbolic},
+                              {"ArcTan",   co_tangeant,         fast_co_tangeant},
+                              {"SoftPlus", softplus,            fast_softplus}};
+    const BrainUint number_of_tests = sizeof(tests) / sizeof(tests[0]);
+    BrainUint number_of_failures = 0;
+    BrainUint i = 0;
+
+    initialize_fast_activations();
+
+    for (i = 0; i < number_of_tests; ++i)
+    {
+        if (!check_fast_activation(&tests[i]))
+        {
+            ++number_of_failures;
+        }
+    }
+
+    return (number_of_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
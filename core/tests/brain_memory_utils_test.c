@@ -0,0 +1,162 @@
+#include "brain_memory_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * \struct CountingContext
+ * \brief  Context of an allocator counting its calls
+ */
+typedef struct CountingContext
+{
+    BrainUint _allocations; /*!< Blocks given         */
+    BrainUint _releases;    /*!< Blocks taken back    */
+} CountingContext;
+
+static void*
+counting_allocate(void* context, size_t size)
+{
+    ++((CountingContext*)context)->_allocations;
+
+    return malloc(size);
+}
+
+static void
+counting_release(void* context, void* pointer)
+{
+    ++((CountingContext*)context)->_releases;
+
+    free(pointer);
+}
+
+static BrainBool
+check(const BrainBool condition, BrainString message)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", message);
+    }
+
+    return condition;
+}
+
+static BrainBool
+check_blocks(BrainString allocator)
+{
+    BrainReal* weights = NULL;
+    BrainReal* values  = NULL;
+    BrainBool  ret     = BRAIN_TRUE;
+    BrainUint  i       = 0;
+
+    printf("%s allocator\n", allocator);
+
+    BRAIN_NEW_TAG(weights, BrainReal, 37, Memory_Weights);
+    BRAIN_NEW(values, BrainReal, 37);
+
+    ret = check(((uintptr_t)weights % BRAIN_MEMORY_ALIGNMENT) == 0, "weights are aligned") && ret;
+    ret = check((brain_memory_size(weights) % BRAIN_MEMORY_ALIGNMENT) == 0, "weights are padded") && ret;
+    ret = check(brain_memory_size(values) == 37 * sizeof(BrainReal), "other blocks are not padded") && ret;
+
+    for (i = 0; i < 37; ++i)
+    {
+        weights[i] = (BrainReal)i;
+        values[i]  = (BrainReal)i;
+    }
+
+    /******************************************************************/
+    /**  An aligned block is moved by a resize, keeps its values and  **/
+    /**  has a zeroed padding                                        **/
+    /******************************************************************/
+    BRAIN_RESIZE(weights, BrainReal, 21);
+    BRAIN_RESIZE(values,  BrainReal, 1000);
+
+    ret = check(((uintptr_t)weights % BRAIN_MEMORY_ALIGNMENT) == 0, "resized weights are aligned") && ret;
+
+    for (i = 0; i < 21; ++i)
+    {
+        ret = check((weights[i] == (BrainReal)i) && (values[i] == (BrainReal)i), "resize keeps the values") && ret;
+    }
+
+    for (i = 21; i < brain_memory_size(weights) / sizeof(BrainReal); ++i)
+    {
+        ret = check(weights[i] == 0., "padding is zeroed") && ret;
+    }
+
+    ret = check(!brain_memory_set_allocator(NULL), "allocator is kept while blocks are allocated") && ret;
+
+    BRAIN_DELETE(weights);
+    BRAIN_DELETE(values);
+
+    return ret;
+}
+
+static BrainBool
+check_arena(CountingContext* context)
+{
+    const size_t size = get_memory_arena_footprint(37, sizeof(BrainReal), Memory_Weights)
+                      + get_memory_arena_footprint(3,  sizeof(BrainUint), Memory_Other)
+                      + get_memory_arena_footprint(5,  sizeof(BrainReal), Memory_Activations);
+    const BrainUint  allocations = context->_allocations;
+    BrainMemoryArena arena   = new_memory_arena(size);
+    BrainReal*       weights = NULL;
+    BrainUint*       values  = NULL;
+    BrainReal*       signal  = NULL;
+    BrainReal*       extra   = NULL;
+    BrainBool        ret     = BRAIN_TRUE;
+    MemoryUsage      usage;
+
+    printf("arena\n");
+
+    memset(&usage, 0, sizeof(MemoryUsage));
+
+    BRAIN_NEW_IN(arena, weights, BrainReal, 37, Memory_Weights);
+    BRAIN_NEW_IN(arena, values,  BrainUint, 3,  Memory_Other);
+    BRAIN_NEW_IN(arena, signal,  BrainReal, 5,  Memory_Activations);
+    // larger than the slack of the footprints, it comes from the allocator
+    BRAIN_NEW_IN(arena, extra,   BrainReal, 100, Memory_Other);
+    close_memory_arena(arena);
+
+    ret = check(context->_allocations == allocations + 2, "blocks are carved out of a single allocation") && ret;
+    ret = check(((uintptr_t)weights % BRAIN_MEMORY_ALIGNMENT) == 0, "carved weights are aligned") && ret;
+    ret = check(((uintptr_t)signal  % BRAIN_MEMORY_ALIGNMENT) == 0, "carved activations are aligned") && ret;
+    ret = check((brain_memory_size(values) == 3 * sizeof(BrainUint)) && (values[2] == 0), "carved blocks are zeroed") && ret;
+
+    accumulate_memory_usage(&usage, weights);
+    accumulate_memory_usage(&usage, values);
+    ret = check((usage.blocks[Memory_Weights] == 1) && (usage.blocks[Memory_Other] == 1), "carved blocks keep their tag") && ret;
+
+    /******************************************************************/
+    /**  A carved block is moved out of the arena by a resize, and    **/
+    /**  the arena is released with its last block                   **/
+    /******************************************************************/
+    values[0] = 42;
+    BRAIN_RESIZE(values, BrainUint, 100);
+    ret = check(values[0] == 42, "resize moves a carved block") && ret;
+
+    BRAIN_DELETE(weights);
+    BRAIN_DELETE(signal);
+    ret = check(context->_releases == allocations + 1, "arena is released with its last block") && ret;
+
+    BRAIN_DELETE(values);
+    BRAIN_DELETE(extra);
+
+    return ret;
+}
+
+int
+main()
+{
+    CountingContext context  = {0, 0};
+    BrainAllocator  counting = {counting_allocate, NULL, counting_release, NULL, &context};
+    BrainBool       ret      = BRAIN_TRUE;
+
+    ret = check_blocks("default") && ret;
+
+    ret = check(brain_memory_set_allocator(&counting), "allocator is installed") && ret;
+    ret = check_blocks("counting") && ret;
+    ret = check_arena(&context) && ret;
+    ret = check((0 < context._allocations) && (context._allocations == context._releases), "blocks come from the allocator") && ret;
+    ret = check(brain_memory_set_allocator(NULL), "default allocator is restored") && ret;
+
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}